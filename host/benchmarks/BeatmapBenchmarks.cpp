@@ -0,0 +1,147 @@
+#include "ByteBuffer.hpp"
+#include "HostTypes.hpp"
+#include "SampleData.hpp"
+#include "Beatmaps/Abstractions/DifficultyColorsEncoding.hpp"
+#include "Objects/EntitlementDecision.hpp"
+#include "Utils/CompactEncoding.hpp"
+#include "Utils/LevelHash.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace MultiplayerCore;
+using namespace MultiplayerCore::Host;
+using MultiplayerCore::Beatmaps::Abstractions::DifficultyColorsEncoding;
+using MultiplayerCore::Objects::EntitlementDecision;
+
+static void BM_DifficultyColorsWrite(benchmark::State& state) {
+    const auto beatmaps = Samples::Beatmaps();
+    const auto& colors = beatmaps[2].mapColors.at(4);
+    ByteWriter writer(256);
+    for (auto _ : state) {
+        writer.Reset();
+        DifficultyColorsEncoding::Write(&writer, colors);
+        benchmark::DoNotOptimize(writer.get_Data().data());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DifficultyColorsWrite);
+
+static void BM_DifficultyColorsRead(benchmark::State& state) {
+    const auto beatmaps = Samples::Beatmaps();
+    ByteWriter writer(256);
+    DifficultyColorsEncoding::Write(&writer, beatmaps[2].mapColors.at(4));
+
+    DifficultyColors colors;
+    for (auto _ : state) {
+        ByteReader reader(writer.written());
+        DifficultyColorsEncoding::Read(&reader, colors);
+        benchmark::DoNotOptimize(colors);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DifficultyColorsRead);
+
+static void BM_HalfFloatRoundTrip(benchmark::State& state) {
+    std::vector<float> values;
+    for (int i = 0; i < 256; i++) values.push_back(i * 0.0173f - 1.0f);
+    for (auto _ : state) {
+        float sum = 0;
+        for (auto value : values) sum += Utils::HalfFloat::ToFloat(Utils::HalfFloat::FromFloat(value));
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * values.size());
+}
+BENCHMARK(BM_HalfFloatRoundTrip);
+
+static void BM_BeatmapPacketWrite(benchmark::State& state) {
+    const auto beatmaps = Samples::Beatmaps();
+    const auto& beatmap = beatmaps[state.range(0)];
+    auto write = state.range(1) ? Samples::WriteCompactBeatmapPacket : Samples::WriteBeatmapPacket;
+    ByteWriter writer(4096);
+    for (auto _ : state) {
+        writer.Reset();
+        write(&writer, beatmap);
+        benchmark::DoNotOptimize(writer.get_Data().data());
+    }
+    state.SetBytesProcessed(state.iterations() * writer.get_Length());
+    state.counters["bytes"] = writer.get_Length();
+}
+BENCHMARK(BM_BeatmapPacketWrite)->ArgsProduct({{0, 1, 2}, {0, 1}})->ArgNames({"beatmap", "compact"});
+
+static void BM_HashForLevelId(benchmark::State& state) {
+    std::vector<std::string> levelIds = {
+        "custom_level_A1B2C3D4E5F60718293A4B5C6D7E8F9001122334",
+        "custom_level_0F5A6F24F6AE4F2C3D4A9C7A4B0E3B2F1D2C3B4A",
+        "100Bills",
+        "OST_Escape"
+    };
+    for (auto _ : state) {
+        for (const auto& levelId : levelIds) benchmark::DoNotOptimize(Utils::LevelHash::FromLevelId(levelId));
+    }
+    state.SetItemsProcessed(state.iterations() * levelIds.size());
+}
+BENCHMARK(BM_HashForLevelId);
+
+static void BM_LevelHashEquals(benchmark::State& state) {
+    std::string_view lhs = "a1b2c3d4e5f60718293a4b5c6d7e8f9001122334";
+    std::string_view rhs = "A1B2C3D4E5F60718293A4B5C6D7E8F9001122334";
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(lhs);
+        benchmark::DoNotOptimize(Utils::LevelHash::Equals(lhs, rhs));
+    }
+}
+BENCHMARK(BM_LevelHashEquals);
+
+namespace {
+    // shaped like the songdownloader BeatSaver types EntitlementDecision gets used with
+    struct FakeDiff {
+        bool chroma, me, ne;
+        bool GetChroma() const { return chroma; }
+        bool GetME() const { return me; }
+        bool GetNE() const { return ne; }
+    };
+
+    struct FakeVersion {
+        std::string hash;
+        std::vector<FakeDiff> diffs;
+        const std::string& GetHash() const { return hash; }
+        const std::vector<FakeDiff>& GetDiffs() const { return diffs; }
+    };
+
+    bool IsInstalled(std::string_view requirement) {
+        // a lookup into the installed mods, about what pinkcore does
+        static const std::vector<std::string> installed = { "Chroma", "Noodle Extensions", "Vivify", "Heck", "Cinema" };
+        return std::find(installed.begin(), installed.end(), requirement) != installed.end();
+    }
+}
+
+static void BM_EntitlementLocalLevel(benchmark::State& state) {
+    rapidjson::Document doc;
+    doc.Parse(Samples::InfoDat.data(), Samples::InfoDat.size());
+    ExtraSongData songData(doc);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(EntitlementDecision::ForLocalLevel(&songData, IsInstalled));
+    }
+}
+BENCHMARK(BM_EntitlementLocalLevel);
+
+static void BM_EntitlementBeatSaverVersion(benchmark::State& state) {
+    std::vector<FakeVersion> versions;
+    for (int i = 0; i < state.range(0); i++) {
+        auto& version = versions.emplace_back();
+        version.hash = Utils::HexBytes::Encode(reinterpret_cast<const uint8_t*>(&i), sizeof(i)) + "00112233445566778899AABBCCDDEEFF";
+        version.diffs = { { true, false, false }, { true, false, true }, { true, false, true }, { false, false, false }, { true, false, true } };
+    }
+    // beatsaver lists the latest version first, which is the one lobbies usually play
+    auto levelHash = versions.front().hash;
+
+    for (auto _ : state) {
+        auto version = EntitlementDecision::FindVersion(versions, levelHash);
+        benchmark::DoNotOptimize(version == versions.end() ? EntitlementDecision::ForMissingLevel() : EntitlementDecision::ForBeatSaverVersion(*version, IsInstalled));
+    }
+}
+BENCHMARK(BM_EntitlementBeatSaverVersion)->Arg(1)->Arg(8);
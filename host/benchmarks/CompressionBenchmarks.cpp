@@ -0,0 +1,110 @@
+#include "ByteBuffer.hpp"
+#include "SampleData.hpp"
+#include "Networking/PacketFraming.hpp"
+#include "Utils/Lz4.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <span>
+#include <vector>
+
+using namespace MultiplayerCore;
+using namespace MultiplayerCore::Host;
+
+namespace {
+    /// @brief serialized payloads of the sample beatmaps, index 0..2 are MpBeatmapPacket, 3..5 MpCompactBeatmapPacket
+    const std::vector<std::vector<uint8_t>>& Payloads() {
+        static auto payloads = []{
+            std::vector<std::vector<uint8_t>> payloads;
+            auto beatmaps = Samples::Beatmaps();
+            for (auto write : { Samples::WriteBeatmapPacket, Samples::WriteCompactBeatmapPacket }) {
+                for (const auto& beatmap : beatmaps) {
+                    ByteWriter writer;
+                    write(&writer, beatmap);
+                    auto written = writer.written();
+                    payloads.emplace_back(written.begin(), written.end());
+                }
+            }
+            return payloads;
+        }();
+        return payloads;
+    }
+
+    std::span<const uint8_t> Dictionary(bool useDictionary) {
+        return useDictionary ? Networking::PacketFraming::CompressionDictionary() : std::span<const uint8_t>();
+    }
+}
+
+static void BM_Lz4Compress(benchmark::State& state) {
+    const auto& payload = Payloads()[state.range(0)];
+    auto dictionary = Dictionary(state.range(1));
+    std::vector<uint8_t> compressed(Utils::Lz4::CompressBound(payload.size()));
+
+    std::size_t compressedLength = 0;
+    for (auto _ : state) {
+        compressedLength = Utils::Lz4::Compress(payload, compressed, dictionary);
+        benchmark::DoNotOptimize(compressed.data());
+    }
+
+    state.SetBytesProcessed(state.iterations() * payload.size());
+    state.counters["raw"] = payload.size();
+    state.counters["compressed"] = compressedLength;
+    state.counters["ratio"] = double(compressedLength) / payload.size();
+}
+BENCHMARK(BM_Lz4Compress)->ArgsProduct({{0, 1, 2, 3, 4, 5}, {0, 1}})->ArgNames({"payload", "dict"})->Unit(benchmark::kMicrosecond);
+
+static void BM_Lz4Decompress(benchmark::State& state) {
+    const auto& payload = Payloads()[state.range(0)];
+    auto dictionary = Dictionary(state.range(1));
+    std::vector<uint8_t> compressed(Utils::Lz4::CompressBound(payload.size()));
+    compressed.resize(Utils::Lz4::Compress(payload, compressed, dictionary));
+    std::vector<uint8_t> decompressed(payload.size());
+
+    for (auto _ : state) {
+        if (!Utils::Lz4::Decompress(compressed, decompressed, dictionary)) state.SkipWithError("Decompression failed");
+        benchmark::DoNotOptimize(decompressed.data());
+    }
+
+    state.SetBytesProcessed(state.iterations() * payload.size());
+    state.counters["ratio"] = double(compressed.size()) / payload.size();
+}
+BENCHMARK(BM_Lz4Decompress)->ArgsProduct({{0, 1, 2, 3, 4, 5}, {0, 1}})->ArgNames({"payload", "dict"})->Unit(benchmark::kMicrosecond);
+
+// the whole send side of a compressed frame, header, payload and the in place compression
+static void BM_CompressedFrameWrite(benchmark::State& state) {
+    const auto& payload = Payloads()[state.range(0)];
+    ByteWriter writer(4096);
+    for (auto _ : state) {
+        writer.Reset();
+        auto flagPosition = Networking::PacketFraming::WriteCompactHeader(&writer, 3);
+        auto payloadStart = writer.get_Length();
+        writer.Put(payload);
+        Networking::PacketFraming::CompressPayload(&writer, flagPosition, payloadStart, 256);
+        benchmark::DoNotOptimize(writer.get_Data().data());
+    }
+    state.SetBytesProcessed(state.iterations() * payload.size());
+    state.counters["frame"] = writer.get_Length();
+}
+BENCHMARK(BM_CompressedFrameWrite)->DenseRange(0, 5)->ArgName("payload")->Unit(benchmark::kMicrosecond);
+
+static void BM_CompressedFrameRead(benchmark::State& state) {
+    const auto& payload = Payloads()[state.range(0)];
+    ByteWriter writer(4096);
+    auto flagPosition = Networking::PacketFraming::WriteCompactHeader(&writer, 3);
+    auto payloadStart = writer.get_Length();
+    writer.Put(payload);
+    Networking::PacketFraming::CompressPayload(&writer, flagPosition, payloadStart, 0);
+
+    std::vector<uint8_t> decompressed;
+    for (auto _ : state) {
+        ByteReader reader(writer.written());
+        auto header = Networking::PacketFraming::ReadHeader(&reader);
+        auto length = reader.get_AvailableBytes();
+        auto [payloadLength, compressedLength] = Networking::PacketFraming::ReadCompressedHeader(&reader, length, header.flags);
+        decompressed.resize(payloadLength);
+        Networking::PacketFraming::Decompress(&reader, compressedLength, decompressed);
+        benchmark::DoNotOptimize(decompressed.data());
+    }
+    state.SetBytesProcessed(state.iterations() * payload.size());
+}
+BENCHMARK(BM_CompressedFrameRead)->DenseRange(0, 5)->ArgName("payload")->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,218 @@
+#include "ByteBuffer.hpp"
+#include "Networking/PacketFraming.hpp"
+#include "Networking/PacketHandlerTable.hpp"
+#include "Networking/PacketMetrics.hpp"
+#include "Networking/RegisteredTypeSet.hpp"
+#include "Networking/SendScheduler.hpp"
+#include "Utils/CompactEncoding.hpp"
+#include "Utils/VarInt.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace MultiplayerCore;
+using namespace MultiplayerCore::Host;
+
+static constexpr std::array<std::string_view, 8> PacketNames = {
+    "MpPlayerData",
+    "MpBeatmapPacket",
+    "MpCompactBeatmapPacket",
+    "MpNodePoseSyncStatePacket",
+    "MpPacketRegistryPacket",
+    "MpPacketRegistryAckPacket",
+    "MpPacketBatch",
+    "MpPacketChunk"
+};
+
+static void BM_VarIntWrite(benchmark::State& state) {
+    ByteWriter writer(1024);
+    uint32_t value = state.range(0);
+    for (auto _ : state) {
+        writer.Reset();
+        for (int i = 0; i < 64; i++) Utils::VarInt::Write(&writer, value);
+        benchmark::DoNotOptimize(writer.get_Data().data());
+    }
+    state.SetItemsProcessed(state.iterations() * 64);
+}
+BENCHMARK(BM_VarIntWrite)->Arg(5)->Arg(300)->Arg(1 << 30);
+
+static void BM_VarIntRead(benchmark::State& state) {
+    ByteWriter writer(1024);
+    for (int i = 0; i < 64; i++) Utils::VarInt::Write(&writer, state.range(0));
+    for (auto _ : state) {
+        ByteReader reader(writer.written());
+        uint32_t sum = 0;
+        for (int i = 0; i < 64; i++) sum += Utils::VarInt::Read(&reader);
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * 64);
+}
+BENCHMARK(BM_VarIntRead)->Arg(5)->Arg(300)->Arg(1 << 30);
+
+static void BM_CompactStringRoundTrip(benchmark::State& state) {
+    std::string value(state.range(0), 'x');
+    ByteWriter writer(1024);
+    for (auto _ : state) {
+        writer.Reset();
+        Utils::CompactString::Write(&writer, value);
+        ByteReader reader(writer.written());
+        benchmark::DoNotOptimize(Utils::CompactString::Read(&reader));
+    }
+    state.SetBytesProcessed(state.iterations() * value.size());
+}
+BENCHMARK(BM_CompactStringRoundTrip)->Arg(8)->Arg(64)->Arg(512);
+
+static void BM_NameFrameHeader(benchmark::State& state) {
+    ByteWriter writer(256);
+    for (auto _ : state) {
+        for (auto name : PacketNames) {
+            writer.Reset();
+            Networking::PacketFraming::WriteNameHeader(&writer, name);
+            ByteReader reader(writer.written());
+            benchmark::DoNotOptimize(Networking::PacketFraming::ReadHeader(&reader));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * PacketNames.size());
+}
+BENCHMARK(BM_NameFrameHeader);
+
+static void BM_CompactFrameHeader(benchmark::State& state) {
+    ByteWriter writer(256);
+    for (auto _ : state) {
+        for (uint32_t id = 0; id < PacketNames.size(); id++) {
+            writer.Reset();
+            Networking::PacketFraming::WriteCompactHeader(&writer, id);
+            ByteReader reader(writer.written());
+            benchmark::DoNotOptimize(Networking::PacketFraming::ReadHeader(&reader));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * PacketNames.size());
+}
+BENCHMARK(BM_CompactFrameHeader);
+
+static void BM_HandlerTableFind(benchmark::State& state) {
+    Networking::PacketHandlerTable<int> table;
+    for (int i = 0; i < state.range(0); i++) table.set("ModPacket" + std::to_string(i), i);
+    for (auto name : PacketNames) table.set(name, 0);
+
+    for (auto _ : state) {
+        for (auto name : PacketNames) benchmark::DoNotOptimize(table.find(name));
+    }
+    state.SetItemsProcessed(state.iterations() * PacketNames.size());
+}
+BENCHMARK(BM_HandlerTableFind)->Arg(0)->Arg(50)->Arg(500);
+
+// compact frames, whose keys come out of the peer's registry already computed
+static void BM_HandlerTableFindKey(benchmark::State& state) {
+    Networking::PacketHandlerTable<int> table;
+    for (int i = 0; i < state.range(0); i++) table.set("ModPacket" + std::to_string(i), i);
+    std::vector<Networking::PacketKey> keys;
+    for (auto name : PacketNames) {
+        table.set(name, 0);
+        keys.push_back(Networking::KeyOf(name));
+    }
+
+    for (auto _ : state) {
+        for (auto key : keys) benchmark::DoNotOptimize(table.find(key));
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+BENCHMARK(BM_HandlerTableFindKey)->Arg(0)->Arg(50)->Arg(500);
+
+namespace {
+    // stand in for Il2CppReflectionType, only the address matters
+    struct alignas(8) FakeType { std::array<uint8_t, 64> data; };
+
+    struct HandlesTypeFixture {
+        HandlesTypeFixture(std::size_t registered) : types(registered + 16) {
+            for (std::size_t i = 0; i < registered; i++) {
+                set.insert(&types[i]);
+                list.push_back(&types[i]);
+            }
+        }
+
+        // the first registered type, and one of ours the game asks about that isn't registered
+        const FakeType* hit() const { return &types.front(); }
+        const FakeType* miss() const { return &types.back(); }
+
+        std::vector<FakeType> types;
+        Networking::RegisteredTypeSet<FakeType> set;
+        std::list<const FakeType*> list;
+    };
+}
+
+// what HandlesType used to do, a linear search through a list
+static void BM_HandlesTypeList(benchmark::State& state) {
+    HandlesTypeFixture fixture(state.range(0));
+    auto type = state.range(1) ? fixture.hit() : fixture.miss();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(std::find(fixture.list.begin(), fixture.list.end(), type) != fixture.list.end());
+    }
+}
+BENCHMARK(BM_HandlesTypeList)->ArgsProduct({{5, 50, 500}, {0, 1}})->ArgNames({"types", "hit"});
+
+static void BM_HandlesTypeSet(benchmark::State& state) {
+    HandlesTypeFixture fixture(state.range(0));
+    auto type = state.range(1) ? fixture.hit() : fixture.miss();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(fixture.set.contains(type));
+    }
+}
+BENCHMARK(BM_HandlesTypeSet)->ArgsProduct({{5, 50, 500}, {0, 1}})->ArgNames({"types", "hit"});
+
+// the game asks about a handful of different types in turn, so the cache slots get reused
+static void BM_HandlesTypeSetMixed(benchmark::State& state) {
+    HandlesTypeFixture fixture(state.range(0));
+    std::array<const FakeType*, 8> asked;
+    for (std::size_t i = 0; i < asked.size(); i++) asked[i] = &fixture.types[(i * 7919) % fixture.types.size()];
+    for (auto _ : state) {
+        for (auto type : asked) benchmark::DoNotOptimize(fixture.set.contains(type));
+    }
+    state.SetItemsProcessed(state.iterations() * asked.size());
+}
+BENCHMARK(BM_HandlesTypeSetMixed)->Arg(5)->Arg(50)->Arg(500);
+
+static void BM_MetricsRecordReceived(benchmark::State& state) {
+    // shared between the benchmark threads, like the serializer's metrics are between the network and main thread
+    static auto metrics = std::make_unique<Networking::PacketMetrics>();
+    for (auto _ : state) {
+        for (auto name : PacketNames) metrics->RecordReceived(metrics->ForPacket(name), metrics->ForSender("76561198000000000"), 64);
+    }
+    state.SetItemsProcessed(state.iterations() * PacketNames.size());
+}
+BENCHMARK(BM_MetricsRecordReceived)->ThreadRange(1, 4);
+
+// a frame's worth of player data, poses and a chunk or two queued at mixed priorities, sent under a budget of 4 kB per frame
+static void BM_SendSchedulerDrain(benchmark::State& state) {
+    using Scheduler = Networking::SendScheduler<const void*>;
+    constexpr std::array<std::pair<Networking::PacketPriority, std::size_t>, 4> Queued = {{
+        { Networking::PacketPriority::Normal, 96 },
+        { Networking::PacketPriority::High, 32 },
+        { Networking::PacketPriority::Low, 1200 },
+        { Networking::PacketPriority::Normal, 180 }
+    }};
+    Scheduler scheduler;
+    scheduler.set_bytesPerFrame(4096);
+
+    std::size_t sentBytes = 0;
+    for (auto _ : state) {
+        auto now = std::chrono::steady_clock::now();
+        for (int i = 0; i < state.range(0); i++) {
+            auto [priority, size] = Queued[i % Queued.size()];
+            scheduler.Enqueue(priority, { nullptr, true, std::vector<uint8_t>(size), now });
+        }
+        scheduler.Drain([&sentBytes](const Scheduler::Message& message){ sentBytes += message.frame.size(); }, now);
+        // what didn't fit is dropped, every iteration starts from an empty queue
+        scheduler.clear();
+    }
+    benchmark::DoNotOptimize(sentBytes);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SendSchedulerDrain)->Arg(4)->Arg(32);
@@ -0,0 +1,157 @@
+#include "Beatmaps/BeatmapMetadataStore.hpp"
+#include "Objects/EntitlementStore.hpp"
+#include "Utils/BatchQueue.hpp"
+#include "Utils/LruCache.hpp"
+#include "Utils/SingleFlight.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using namespace MultiplayerCore::Beatmaps;
+
+namespace {
+    // 40 hex characters, like a level hash
+    std::string HashOf(std::size_t i) {
+        char buffer[41];
+        std::snprintf(buffer, sizeof(buffer), "%040zx", i * 2654435761u);
+        return buffer;
+    }
+
+    BeatmapMetadata SampleMetadata(std::size_t i) {
+        BeatmapMetadata metadata;
+        metadata.hash = HashOf(i);
+        metadata.found = true;
+        metadata.key = "3a9f" + std::to_string(i);
+        metadata.songName = "Song " + std::to_string(i);
+        metadata.songSubName = "(Extended Mix)";
+        metadata.songAuthorName = "Some Artist";
+        metadata.levelAuthorName = "Some Mapper & Another Mapper";
+        metadata.bpm = 174;
+        metadata.duration = 212.5f;
+        metadata.versions.push_back({ metadata.hash, std::vector<BeatmapMetadata::Difficulty>(5, { BeatmapMetadata::Difficulty::Chroma }) });
+        metadata.fetched = std::chrono::system_clock::now();
+        return metadata;
+    }
+
+    struct StoreFixture {
+        StoreFixture(std::size_t count) : path(std::filesystem::temp_directory_path() / "mpcore-benchmark-metadata.log") {
+            std::filesystem::remove(path);
+            BeatmapMetadataStore store(path);
+            for (std::size_t i = 0; i < count; i++) store.Store(SampleMetadata(i));
+        }
+        ~StoreFixture() { std::filesystem::remove(path); }
+
+        std::filesystem::path path;
+    };
+}
+
+// what a lobby song selection costs once the map is cached, instead of a BeatSaver round trip
+static void BM_MetadataStoreFind(benchmark::State& state) {
+    StoreFixture fixture(state.range(0));
+    BeatmapMetadataStore store(fixture.path);
+    std::vector<std::string> hashes;
+    for (std::size_t i = 0; i < 64; i++) hashes.push_back(HashOf(i * 7919 % state.range(0)));
+
+    for (auto _ : state) {
+        for (auto& hash : hashes) benchmark::DoNotOptimize(store.Find(hash));
+    }
+    state.SetItemsProcessed(state.iterations() * hashes.size());
+}
+BENCHMARK(BM_MetadataStoreFind)->Arg(100)->Arg(5000);
+
+// reading the log when the first lobby of a session opens
+static void BM_MetadataStoreLoad(benchmark::State& state) {
+    StoreFixture fixture(state.range(0));
+    for (auto _ : state) {
+        BeatmapMetadataStore store(fixture.path);
+        benchmark::DoNotOptimize(store.get_stats().entries);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_MetadataStoreLoad)->Arg(100)->Arg(5000)->Unit(benchmark::kMillisecond);
+
+// several lookups of one new map at once, like a song selection in a lobby, with a 1 ms stand in for the BeatSaver request
+static void BM_SingleFlightLookup(benchmark::State& state) {
+    static MultiplayerCore::Utils::SingleFlight<std::string, BeatmapMetadata> requests;
+    auto hash = HashOf(1);
+    for (auto _ : state) {
+        auto metadata = requests.Do(hash, [&hash](){
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            return SampleMetadata(1);
+        }).get();
+        benchmark::DoNotOptimize(metadata.bpm);
+    }
+    if (state.thread_index() == 0) {
+        auto stats = requests.get_stats();
+        state.counters["coalesced"] = static_cast<double>(stats.coalesced) / (stats.calls + stats.coalesced);
+    }
+}
+BENCHMARK(BM_SingleFlightLookup)->Threads(1)->Threads(5)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+// a lobby bringing in a new map per player at once, with a 1 ms stand in for the multi hash BeatSaver request
+static void BM_BatchQueueLookup(benchmark::State& state) {
+    static MultiplayerCore::Utils::BatchQueue<std::string, BeatmapMetadata> batches([](const std::vector<std::string>& hashes){
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        std::unordered_map<std::string, BeatmapMetadata> found;
+        for (auto& hash : hashes) found.emplace(hash, SampleMetadata(0));
+        return found;
+    }, std::chrono::milliseconds(2), 50);
+
+    std::size_t i = state.thread_index();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(batches.Get(HashOf(i)));
+        i += state.threads();
+    }
+    if (state.thread_index() == 0) {
+        auto stats = batches.get_stats();
+        state.counters["perRequest"] = static_cast<double>(stats.lookups) / stats.batches;
+    }
+}
+BENCHMARK(BM_BatchQueueLookup)->Threads(1)->Threads(8)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+// what GetEntitlementStatus_override costs for a level decided in an earlier session, instead of a task on another thread
+static void BM_EntitlementStoreFind(benchmark::State& state) {
+    using MultiplayerCore::Objects::EntitlementStore;
+    using Status = MultiplayerCore::Objects::EntitlementDecision::Status;
+    auto path = std::filesystem::temp_directory_path() / "mpcore-benchmark-entitlements.log";
+    std::filesystem::remove(path);
+    {
+        EntitlementStore store(path, 1);
+        for (int64_t i = 0; i < state.range(0); i++) store.Store(HashOf(i), Status::Ok, 1700000000 + i);
+    }
+
+    EntitlementStore store(path, 1);
+    int64_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(store.Find(HashOf(i), 1700000000 + i));
+        if (++i == state.range(0)) i = 0;
+    }
+    state.SetItemsProcessed(state.iterations());
+    std::filesystem::remove(path);
+}
+BENCHMARK(BM_EntitlementStoreFind)->Arg(5000);
+
+// the entitlement task cache of a long quickplay session, more levels than it holds so the misses evict
+static void BM_LruCacheLookup(benchmark::State& state) {
+    MultiplayerCore::Utils::LruCache<std::string, int> cache(256, std::chrono::minutes(10));
+    std::vector<std::string> levelIds;
+    for (int64_t i = 0; i < state.range(0); i++) levelIds.push_back("custom_level_" + HashOf(i));
+
+    std::size_t i = 0;
+    for (auto _ : state) {
+        auto& levelId = levelIds[i * 7919 % levelIds.size()];
+        if (!cache.Find(levelId)) cache.Insert(levelId, 0);
+        i++;
+    }
+    auto& stats = cache.get_stats();
+    state.counters["hitRate"] = static_cast<double>(stats.hits) / (stats.hits + stats.misses);
+    state.counters["kB"] = stats.bytes / 1024.0;
+}
+BENCHMARK(BM_LruCacheLookup)->Arg(200)->Arg(1000);
@@ -0,0 +1,37 @@
+#include "HostTypes.hpp"
+#include "SampleData.hpp"
+
+#include <benchmark/benchmark.h>
+
+using namespace MultiplayerCore::Host;
+
+// what ExtraSongData::FromMapPath does after reading the file
+static void BM_ExtraSongDataParse(benchmark::State& state) {
+    for (auto _ : state) {
+        rapidjson::Document doc;
+        doc.Parse(Samples::InfoDat.data(), Samples::InfoDat.size());
+        ExtraSongData songData(doc);
+        benchmark::DoNotOptimize(songData.difficulties.data());
+    }
+    state.SetBytesProcessed(state.iterations() * Samples::InfoDat.size());
+}
+BENCHMARK(BM_ExtraSongDataParse);
+
+// only the json parse, the difference to the above is the cost of pulling our data out of the document
+static void BM_InfoDatDocumentParse(benchmark::State& state) {
+    for (auto _ : state) {
+        rapidjson::Document doc;
+        doc.Parse(Samples::InfoDat.data(), Samples::InfoDat.size());
+        benchmark::DoNotOptimize(doc.IsObject());
+    }
+    state.SetBytesProcessed(state.iterations() * Samples::InfoDat.size());
+}
+BENCHMARK(BM_InfoDatDocumentParse);
+
+static void BM_ParseDifficulty(benchmark::State& state) {
+    for (auto _ : state) {
+        for (auto name : ExtraSongData::DifficultyNames) benchmark::DoNotOptimize(ExtraSongData::ParseDifficulty(name));
+    }
+    state.SetItemsProcessed(state.iterations() * ExtraSongData::DifficultyNames.size());
+}
+BENCHMARK(BM_ParseDifficulty);
@@ -0,0 +1,36 @@
+// MpPacketBatch payloads as MpPacketSerializer::DeserializeBatch walks them, every frame is read like a packet of its own
+#include "FuzzTarget.hpp"
+#include "Networking/PacketFraming.hpp"
+
+#include <exception>
+
+using namespace MultiplayerCore;
+using namespace MultiplayerCore::Host;
+using Networking::PacketFraming;
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, std::size_t size) {
+    if (size > Fuzz::MaxInputBytes) return 0;
+    Fuzz::Deadline deadline;
+
+    ByteReader reader({ data, size });
+    try {
+        int end = size;
+        auto frameCount = PacketFraming::ReadBatchFrameCount(&reader, size);
+        Fuzz::Check(frameCount <= size, "more batch frames than bytes");
+        for (std::size_t i = 0; i < frameCount; i++) {
+            int frameLength = PacketFraming::ReadBatchFrameLength(&reader, end);
+            Fuzz::Check(frameLength > 0 && frameLength <= end - reader.get_Position(), "batch frame exceeds the batch");
+
+            // a bad frame only loses itself, the next one starts where its length says it ends
+            // the serializer refuses batches in batches, so there is no recursion to follow
+            ByteReader frame(reader.get_RawData().subspan(reader.get_Position(), frameLength));
+            try {
+                PacketFraming::ReadHeader(&frame);
+            } catch (const std::exception&) {}
+            reader.SkipBytes(frameLength);
+        }
+    } catch (const std::exception&) {
+        // the serializer logs and skips the rest of the batch
+    }
+    return 0;
+}
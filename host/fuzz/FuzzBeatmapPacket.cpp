@@ -0,0 +1,30 @@
+// MpBeatmapPacket, the counts in it come straight off the wire and have to stay within DecodeLimits
+#include "FuzzTarget.hpp"
+#include "HostPackets.hpp"
+
+using namespace MultiplayerCore;
+using namespace MultiplayerCore::Host;
+using Networking::DecodeLimits;
+using Beatmaps::Packets::MpBeatmapPacketEncoding;
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, std::size_t size) {
+    if (size > Fuzz::MaxInputBytes) return 0;
+    Fuzz::Deadline deadline;
+
+    ByteReader reader({ data, size });
+    Samples::Beatmap beatmap;
+    try {
+        MpBeatmapPacketEncoding::Read(&reader, beatmap);
+    } catch (const std::exception&) {
+        return 0;
+    }
+
+    Fuzz::Check(beatmap.requirements.size() <= DecodeLimits::MaxDifficulties, "difficulties exceed MaxDifficulties");
+    for (const auto& [difficulty, reqs] : beatmap.requirements)
+        Fuzz::Check(reqs.size() <= DecodeLimits::MaxRequirementsPerDifficulty, "requirements exceed MaxRequirementsPerDifficulty");
+    Fuzz::Check(beatmap.contributors.size() <= DecodeLimits::MaxContributors, "contributors exceed MaxContributors");
+    Fuzz::Check(beatmap.mapColors.size() <= DecodeLimits::MaxMapColors, "map colors exceed MaxMapColors");
+
+    Fuzz::CheckRoundTrip(beatmap, &Samples::WriteBeatmapPacket, &MpBeatmapPacketEncoding::Read<ByteReader*, Samples::Beatmap>);
+    return 0;
+}
@@ -0,0 +1,48 @@
+// A stream of MpPacketChunk payloads from a few senders, read and reassembled like MpPacketSerializer::DeserializeChunk does.
+// Each record is a sender byte, milliseconds since the previous record, a varint length and that many bytes of chunk payload
+#include "FuzzTarget.hpp"
+#include "Networking/ChunkReassembler.hpp"
+#include "Networking/PacketFraming.hpp"
+#include "Utils/VarInt.hpp"
+
+#include <exception>
+
+using namespace MultiplayerCore;
+using namespace MultiplayerCore::Host;
+using Networking::PacketFraming;
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, std::size_t size) {
+    if (size > Fuzz::MaxInputBytes) return 0;
+    Fuzz::Deadline deadline;
+
+    Networking::ChunkReassembler<uint8_t> transfers;
+    auto now = std::chrono::steady_clock::time_point();
+    ByteReader input({ data, size });
+    try {
+        while (input.get_AvailableBytes() > 0) {
+            auto sender = input.GetByte() % 4;
+            now += std::chrono::milliseconds(input.GetByte() * 64);
+            int length = Utils::VarInt::Read(&input);
+            if (length < 0 || length > input.get_AvailableBytes()) return 0;
+
+            ByteReader chunk(input.get_RawData().subspan(input.get_Position(), length));
+            input.SkipBytes(length);
+            try {
+                auto [transferId, totalLength, offset, chunkLength] = PacketFraming::ReadChunkHeader(&chunk, length);
+                Fuzz::Check(totalLength <= PacketFraming::MaxTransferBytes, "transfer exceeds MaxTransferBytes");
+                auto frame = transfers.Add(sender, transferId, totalLength, offset, chunk.get_RawData().subspan(chunk.get_Position(), chunkLength), now);
+                if (!frame.empty()) Fuzz::Check(frame.size() == totalLength, "reassembled frame does not have the length the transfer claimed");
+            } catch (const std::exception&) {
+                // the serializer logs and skips the chunk
+            }
+
+            if (sender == 3) transfers.RemovePeer(sender);
+            transfers.Expire(now, [](uint32_t, std::size_t receivedBytes, uint32_t totalLength){
+                Fuzz::Check(receivedBytes < totalLength, "a complete transfer was still buffered");
+            });
+        }
+    } catch (const std::exception&) {
+        // ran out of input in the middle of a record
+    }
+    return 0;
+}
@@ -0,0 +1,73 @@
+// Frame headers as MpPacketSerializer::Deserialize reads them: a name or a compact id resolved through the registry of the sender,
+// followed by a plain or LZ4 compressed payload. Every input also goes through CompressPayload and has to decompress to itself
+#include "FuzzTarget.hpp"
+#include "Networking/PacketFraming.hpp"
+#include "Networking/PacketRegistry.hpp"
+
+#include <exception>
+#include <vector>
+
+using namespace MultiplayerCore;
+using namespace MultiplayerCore::Host;
+using Networking::PacketFraming;
+
+static void ReadFrame(std::span<const uint8_t> data) {
+    // a sender that registered the built-in packets
+    static auto registry = [] {
+        Networking::PacketRegistry<int, int> registry;
+        registry.SetIncoming(0, { "MpPacketRegistryPacket", "MpPacketRegistryAckPacket", "MpPacketBatch", "MpPacketChunk", "MpPlayerData", "MpBeatmapPacket", "MpCompactBeatmapPacket", "MpNodePoseSyncStatePacket" });
+        return registry;
+    }();
+
+    ByteReader reader(data);
+    try {
+        auto header = PacketFraming::ReadHeader(&reader);
+        int length = data.size() - reader.get_Position();
+        if (!header.compact()) return;
+
+        registry.ResolveIncoming(0, header.compactId);
+        if (header.flags == PacketFraming::FramePlain) return;
+
+        auto [payloadLength, compressedLength] = PacketFraming::ReadCompressedHeader(&reader, length, header.flags);
+        Fuzz::Check(payloadLength <= PacketFraming::MaxDecompressedBytes, "decompressed size exceeds MaxDecompressedBytes");
+        Fuzz::Check(compressedLength <= std::size_t(reader.get_AvailableBytes()), "compressed length exceeds the frame");
+        std::vector<uint8_t> payload(payloadLength);
+        PacketFraming::Decompress(&reader, compressedLength, payload);
+    } catch (const std::exception&) {
+        // the serializer logs and skips the packet
+    }
+}
+
+static void CheckCompressionRoundTrip(std::span<const uint8_t> data) {
+    if (data.size() > PacketFraming::MaxDecompressedBytes) return;
+
+    ByteWriter writer(data.size() + 16);
+    int flagPosition = PacketFraming::WriteCompactHeader(&writer, 5);
+    int payloadStart = writer.get_Length();
+    writer.Put(data);
+    bool compressed = PacketFraming::CompressPayload(&writer, flagPosition, payloadStart, 0);
+
+    ByteReader reader(writer.written());
+    auto header = PacketFraming::ReadHeader(&reader);
+    Fuzz::Check(header.compact() && header.compactId == 5, "compact header did not round trip");
+    Fuzz::Check((header.flags == PacketFraming::FrameLz4) == compressed, "frame flag does not match the payload");
+    if (!compressed) {
+        Fuzz::Check(Fuzz::SameBytes(writer.written().subspan(reader.get_Position()), data), "uncompressed payload changed");
+        return;
+    }
+
+    int length = writer.get_Length() - reader.get_Position();
+    auto [payloadLength, compressedLength] = PacketFraming::ReadCompressedHeader(&reader, length, header.flags);
+    std::vector<uint8_t> payload(payloadLength);
+    PacketFraming::Decompress(&reader, compressedLength, payload);
+    Fuzz::Check(Fuzz::SameBytes(payload, data), "compressed payload did not decompress to itself");
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, std::size_t size) {
+    if (size > Fuzz::MaxInputBytes) return 0;
+    Fuzz::Deadline deadline;
+
+    ReadFrame({ data, size });
+    CheckCompressionRoundTrip({ data, size });
+    return 0;
+}
@@ -0,0 +1,24 @@
+// MpNodePoseSyncStatePacket, the two pose sync rates the server sends
+#include "FuzzTarget.hpp"
+#include "HostPackets.hpp"
+
+using namespace MultiplayerCore;
+using namespace MultiplayerCore::Host;
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, std::size_t size) {
+    if (size > Fuzz::MaxInputBytes) return 0;
+    Fuzz::Deadline deadline;
+
+    ByteReader reader({ data, size });
+    Packets::NodePoseSyncStatePacket packet;
+    try {
+        NodePoseSyncState::MpNodePoseSyncStatePacketEncoding::Read(&reader, packet);
+    } catch (const std::exception&) {
+        return 0;
+    }
+
+    Fuzz::CheckRoundTrip(packet,
+        [](ByteWriter* writer, const Packets::NodePoseSyncStatePacket& packet) { packet.Serialize(writer); },
+        &NodePoseSyncState::MpNodePoseSyncStatePacketEncoding::Read<ByteReader*, Packets::NodePoseSyncStatePacket>);
+    return 0;
+}
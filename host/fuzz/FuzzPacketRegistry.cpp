@@ -0,0 +1,32 @@
+// MpPacketRegistryPacket, the names it carries end up in the registry compact ids of the sender are resolved through
+#include "FuzzTarget.hpp"
+#include "HostPackets.hpp"
+#include "Networking/PacketRegistry.hpp"
+
+using namespace MultiplayerCore;
+using namespace MultiplayerCore::Host;
+using Networking::DecodeLimits;
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, std::size_t size) {
+    if (size > Fuzz::MaxInputBytes) return 0;
+    Fuzz::Deadline deadline;
+
+    ByteReader reader({ data, size });
+    Packets::PacketRegistryPacket packet;
+    try {
+        Networking::Packets::MpPacketRegistryPacketEncoding::Read(&reader, packet);
+    } catch (const std::exception&) {
+        return 0;
+    }
+    Fuzz::Check(packet.packetNames.size() <= DecodeLimits::MaxPacketNames, "packet names exceed MaxPacketNames");
+
+    Fuzz::CheckRoundTrip(packet,
+        [](ByteWriter* writer, const Packets::PacketRegistryPacket& packet) { packet.Serialize(writer); },
+        &Networking::Packets::MpPacketRegistryPacketEncoding::Read<ByteReader*, Packets::PacketRegistryPacket>);
+
+    Networking::PacketRegistry<int, int> registry;
+    auto count = packet.packetNames.size();
+    registry.SetIncoming(0, std::move(packet.packetNames));
+    Fuzz::Check(registry.ResolveIncoming(0, count).empty(), "an id past the registry resolved");
+    return 0;
+}
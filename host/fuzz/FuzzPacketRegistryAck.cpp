@@ -0,0 +1,24 @@
+// MpPacketRegistryAckPacket, a single varint
+#include "FuzzTarget.hpp"
+#include "HostPackets.hpp"
+
+using namespace MultiplayerCore;
+using namespace MultiplayerCore::Host;
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, std::size_t size) {
+    if (size > Fuzz::MaxInputBytes) return 0;
+    Fuzz::Deadline deadline;
+
+    ByteReader reader({ data, size });
+    Packets::PacketRegistryAckPacket packet;
+    try {
+        Networking::Packets::MpPacketRegistryPacketEncoding::ReadAck(&reader, packet);
+    } catch (const std::exception&) {
+        return 0;
+    }
+
+    Fuzz::CheckRoundTrip(packet,
+        [](ByteWriter* writer, const Packets::PacketRegistryAckPacket& packet) { packet.Serialize(writer); },
+        &Networking::Packets::MpPacketRegistryPacketEncoding::ReadAck<ByteReader*, Packets::PacketRegistryAckPacket>);
+    return 0;
+}
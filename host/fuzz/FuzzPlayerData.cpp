@@ -0,0 +1,24 @@
+// MpPlayerData, two LiteNetLib strings around the platform
+#include "FuzzTarget.hpp"
+#include "HostPackets.hpp"
+
+using namespace MultiplayerCore;
+using namespace MultiplayerCore::Host;
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, std::size_t size) {
+    if (size > Fuzz::MaxInputBytes) return 0;
+    Fuzz::Deadline deadline;
+
+    ByteReader reader({ data, size });
+    Packets::PlayerData packet;
+    try {
+        Players::MpPlayerDataEncoding::Read(&reader, packet);
+    } catch (const std::exception&) {
+        return 0;
+    }
+
+    Fuzz::CheckRoundTrip(packet,
+        [](ByteWriter* writer, const Packets::PlayerData& packet) { packet.Serialize(writer); },
+        &Players::MpPlayerDataEncoding::Read<ByteReader*, Packets::PlayerData>);
+    return 0;
+}
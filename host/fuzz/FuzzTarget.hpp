@@ -0,0 +1,71 @@
+#pragma once
+
+#include "ByteBuffer.hpp"
+#include "Networking/DecodeLimits.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <span>
+
+// entry point of every target, libFuzzer's when built with clang, StandaloneMain.cpp's otherwise
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, std::size_t size);
+
+namespace MultiplayerCore::Host::Fuzz {
+    /// @brief wall time one input may take. Decoding a packet happens on the receive path and should take microseconds,
+    /// anything approaching a frame at 90 Hz means a hostile peer could hitch the lobby with it
+    static constexpr std::chrono::milliseconds MaxInputTime{10};
+
+    /// @brief inputs are single packets, which the game never hands us larger than a reassembled chunked transfer
+    static constexpr std::size_t MaxInputBytes = 1024 * 1024;
+
+    [[noreturn]] inline void Fail(const char* what) {
+        std::fprintf(stderr, "fuzz target failed: %s\n", what);
+        std::abort();
+    }
+
+    inline void Check(bool condition, const char* what) {
+        if (!condition) Fail(what);
+    }
+
+    /// @brief aborts if the input took longer than MaxInputTime, libFuzzer's own -timeout only goes down to a second
+    class Deadline {
+        public:
+            ~Deadline() {
+                if (std::chrono::steady_clock::now() - start > MaxInputTime) Fail("input took longer than MaxInputTime");
+            }
+
+        private:
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    };
+
+    /// @brief whether two written buffers hold the same bytes
+    inline bool SameBytes(std::span<const uint8_t> a, std::span<const uint8_t> b) {
+        return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
+    }
+
+    /// @brief a packet that decoded has to survive being sent on: what write makes of it has to decode completely,
+    /// and write the same bytes again
+    template<typename TPacket, typename TWrite, typename TRead>
+    void CheckRoundTrip(const TPacket& packet, TWrite&& write, TRead&& read) {
+        ByteWriter first;
+        write(&first, packet);
+
+        TPacket decoded{};
+        ByteReader reader(first.written());
+        try {
+            read(&reader, decoded);
+        } catch (const std::exception&) {
+            Fail("a written packet did not decode");
+        }
+        Check(reader.get_AvailableBytes() == 0, "decoding a written packet left bytes over");
+
+        ByteWriter second;
+        write(&second, decoded);
+        Check(SameBytes(first.written(), second.written()), "a decoded packet did not write the same bytes again");
+    }
+}
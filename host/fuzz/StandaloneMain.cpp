@@ -0,0 +1,55 @@
+// Driver for compilers without libFuzzer: replays inputs from files and directories (a corpus or a crash found on a clang build),
+// and can throw random inputs at the target, which is no substitute for coverage guided fuzzing but catches the obvious
+//   mpcore-fuzz-beatmap-packet crash-1234 corpus/
+//   mpcore-fuzz-beatmap-packet -runs=100000 -seed=1
+#include "FuzzTarget.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <string_view>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+static void RunFile(const fs::path& path) {
+    std::ifstream in(path, std::ios::binary);
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    LLVMFuzzerTestOneInput(data.data(), data.size());
+}
+
+int main(int argc, char** argv) {
+    uint64_t runs = 0;
+    uint64_t seed = std::random_device()();
+    std::size_t files = 0;
+
+    for (int i = 1; i < argc; i++) {
+        std::string_view arg = argv[i];
+        if (arg.starts_with("-runs=")) runs = std::stoull(std::string(arg.substr(6)));
+        else if (arg.starts_with("-seed=")) seed = std::stoull(std::string(arg.substr(6)));
+        else if (arg.starts_with("-")) std::cerr << "ignoring " << arg << ", only -runs and -seed are supported without libFuzzer\n";
+        else if (fs::is_directory(arg)) {
+            for (const auto& entry : fs::recursive_directory_iterator(arg)) {
+                if (!entry.is_regular_file()) continue;
+                RunFile(entry.path());
+                files++;
+            }
+        } else {
+            RunFile(arg);
+            files++;
+        }
+    }
+
+    // mostly short inputs, where random bytes still get past the first few fields now and then
+    std::mt19937_64 random(seed);
+    std::vector<uint8_t> data;
+    for (uint64_t run = 0; run < runs; run++) {
+        data.resize(std::uniform_int_distribution<std::size_t>(0, 1)(random) ? random() % 64 : random() % 4096);
+        for (auto& b : data) b = random();
+        LLVMFuzzerTestOneInput(data.data(), data.size());
+    }
+
+    std::cout << "ran " << files << " files and " << runs << " random inputs (seed " << seed << ")\n";
+}
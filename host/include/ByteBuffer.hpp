@@ -0,0 +1,96 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace MultiplayerCore::Host {
+    /// @brief stand in for LiteNetLib's NetDataWriter, same little endian layout and the same members the pure MpCore code uses
+    class ByteWriter {
+        public:
+            ByteWriter(std::size_t capacity = 64) : data(capacity) {}
+
+            template<typename T>
+            requires(std::is_arithmetic_v<T>)
+            void Put(T value) {
+                Reserve(sizeof(T));
+                std::memcpy(data.data() + position, &value, sizeof(T));
+                position += sizeof(T);
+            }
+
+            void Put(std::span<const uint8_t> bytes) {
+                Reserve(bytes.size());
+                std::copy(bytes.begin(), bytes.end(), data.begin() + position);
+                position += bytes.size();
+            }
+
+            int get_Length() const { return position; }
+            void SetPosition(int value) { position = value; }
+            void Reset() { position = 0; }
+
+            /// @brief the whole buffer, which can be larger than get_Length()
+            std::span<uint8_t> get_Data() { return data; }
+            std::span<const uint8_t> written() const { return { data.data(), std::size_t(position) }; }
+
+        private:
+            void Reserve(std::size_t bytes) {
+                if (position + bytes <= data.size()) return;
+                data.resize(std::max(data.size() * 2, position + bytes));
+            }
+
+            std::vector<uint8_t> data;
+            std::size_t position = 0;
+    };
+
+    /// @brief stand in for LiteNetLib's NetDataReader over a buffer it does not own
+    class ByteReader {
+        public:
+            ByteReader(std::span<const uint8_t> data) : data(data) {}
+
+            template<typename T>
+            requires(std::is_arithmetic_v<T>)
+            T Get() {
+                if (sizeof(T) > data.size() - position) throw std::out_of_range("Read past the end of the buffer");
+                T value;
+                std::memcpy(&value, data.data() + position, sizeof(T));
+                position += sizeof(T);
+                return value;
+            }
+
+            uint8_t GetByte() { return Get<uint8_t>(); }
+            uint16_t GetUShort() { return Get<uint16_t>(); }
+            int32_t GetInt() { return Get<int32_t>(); }
+            uint32_t GetUInt() { return Get<uint32_t>(); }
+            int64_t GetLong() { return Get<int64_t>(); }
+            float GetFloat() { return Get<float>(); }
+
+            /// @brief LiteNetLib string as NetDataReader::GetString reads it, an int byte count and utf8
+            std::string GetString() {
+                int byteCount = GetInt();
+                if (byteCount <= 0) return {};
+                if (byteCount > get_AvailableBytes()) throw std::out_of_range("String length exceeds available bytes");
+                std::string value(reinterpret_cast<const char*>(data.data() + position), byteCount);
+                position += byteCount;
+                return value;
+            }
+
+            int get_Position() const { return position; }
+            int get_AvailableBytes() const { return data.size() - position; }
+            std::span<const uint8_t> get_RawData() const { return data; }
+
+            void SkipBytes(int count) {
+                if (count < 0 || std::size_t(count) > data.size() - position) throw std::out_of_range("Skipped past the end of the buffer");
+                position += count;
+            }
+
+        private:
+            std::span<const uint8_t> data;
+            std::size_t position = 0;
+    };
+}
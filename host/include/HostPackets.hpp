@@ -0,0 +1,64 @@
+#pragma once
+
+#include "ByteBuffer.hpp"
+#include "SampleData.hpp"
+#include "Beatmaps/Packets/MpBeatmapPacketEncoding.hpp"
+#include "Beatmaps/Packets/MpCompactBeatmapPacketEncoding.hpp"
+#include "Networking/Packets/MpPacketRegistryPacketEncoding.hpp"
+#include "NodePoseSyncState/MpNodePoseSyncStatePacketEncoding.hpp"
+#include "Players/MpPlayerDataEncoding.hpp"
+#include "Utils/VarInt.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace MultiplayerCore::Host::Packets {
+    /// @brief same layout as Networking::Packets::MpPacketRegistryPacket
+    struct PacketRegistryPacket {
+        std::vector<std::string> packetNames;
+
+        void Serialize(ByteWriter* writer) const {
+            Utils::VarInt::Write(writer, packetNames.size());
+            for (const auto& name : packetNames) Samples::PutString(writer, name);
+        }
+
+        void Deserialize(ByteReader* reader) { Networking::Packets::MpPacketRegistryPacketEncoding::Read(reader, *this); }
+    };
+
+    /// @brief same layout as Networking::Packets::MpPacketRegistryAckPacket
+    struct PacketRegistryAckPacket {
+        uint32_t packetCount = 0;
+
+        void Serialize(ByteWriter* writer) const { Utils::VarInt::Write(writer, packetCount); }
+        void Deserialize(ByteReader* reader) { Networking::Packets::MpPacketRegistryPacketEncoding::ReadAck(reader, *this); }
+    };
+
+    /// @brief same layout as Players::MpPlayerData
+    struct PlayerData {
+        std::string platformId;
+        int32_t platform = 0;
+        std::string gameVersion;
+
+        void Serialize(ByteWriter* writer) const {
+            Samples::PutString(writer, platformId);
+            writer->Put(platform);
+            Samples::PutString(writer, gameVersion);
+        }
+
+        void Deserialize(ByteReader* reader) { Players::MpPlayerDataEncoding::Read(reader, *this); }
+    };
+
+    /// @brief same layout as NodePoseSyncState::MpNodePoseSyncStatePacket
+    struct NodePoseSyncStatePacket {
+        int64_t deltaUpdateFrequencyMs = 10;
+        int64_t fullStateUpdateFrequencyMs = 100;
+
+        void Serialize(ByteWriter* writer) const {
+            writer->Put(deltaUpdateFrequencyMs);
+            writer->Put(fullStateUpdateFrequencyMs);
+        }
+
+        void Deserialize(ByteReader* reader) { NodePoseSyncState::MpNodePoseSyncStatePacketEncoding::Read(reader, *this); }
+    };
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "Utils/BasicExtraSongData.hpp"
+
+#include <optional>
+
+namespace MultiplayerCore::Host {
+    /// @brief same layout as UnityEngine::Color
+    struct Color {
+        constexpr Color(float r, float g, float b, float a) : r(r), g(g), b(b), a(a) {}
+        float r, g, b, a;
+    };
+
+    /// @brief same values as GlobalNamespace::BeatmapDifficulty
+    enum class BeatmapDifficulty : int {
+        Easy,
+        Normal,
+        Hard,
+        Expert,
+        ExpertPlus
+    };
+
+    using ExtraSongData = Utils::BasicExtraSongData<Color, BeatmapDifficulty>;
+
+    /// @brief same members as Beatmaps::Abstractions::DifficultyColors
+    struct DifficultyColors {
+        using ColorOpt = std::optional<ExtraSongData::MapColor>;
+        ColorOpt colorLeft;
+        ColorOpt colorRight;
+        ColorOpt envColorLeft;
+        ColorOpt envColorRight;
+        ColorOpt envColorLeftBoost;
+        ColorOpt envColorRightBoost;
+        ColorOpt obstacleColor;
+    };
+}
@@ -0,0 +1,317 @@
+#pragma once
+
+#include "ByteBuffer.hpp"
+#include "HostTypes.hpp"
+#include "Beatmaps/Abstractions/DifficultyColorsEncoding.hpp"
+#include "Utils/CompactEncoding.hpp"
+#include "Utils/VarInt.hpp"
+
+#include <array>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace MultiplayerCore::Host::Samples {
+    /// @brief info.dat of a typical modded map, a few difficulties with requirements, colors and contributors
+    inline constexpr std::string_view InfoDat = R"({
+  "_version": "2.0.0",
+  "_songName": "Ghost Mapping Showcase",
+  "_songSubName": "Extended Mix",
+  "_songAuthorName": "Some Artist",
+  "_levelAuthorName": "Mapper, Lighter",
+  "_beatsPerMinute": 174,
+  "_songTimeOffset": 0,
+  "_shuffle": 0,
+  "_shufflePeriod": 0.5,
+  "_previewStartTime": 12,
+  "_previewDuration": 10,
+  "_songFilename": "song.egg",
+  "_coverImageFilename": "cover.jpg",
+  "_environmentName": "BigMirrorEnvironment",
+  "_allDirectionsEnvironmentName": "GlassDesertEnvironment",
+  "_customData": {
+    "_contributors": [],
+    "contributors": [
+      { "_role": "Mapper", "_name": "Mapper", "_iconPath": "mapper.png" },
+      { "_role": "Lighter", "_name": "Lighter", "_iconPath": "lighter.png" },
+      { "_role": "Playtester", "_name": "Tester One", "_iconPath": "" },
+      { "_role": "Playtester", "_name": "Tester Two" }
+    ],
+    "_customEnvironmentName": "Vivify Environment",
+    "_customEnvironmentHash": "5E0B9C4A3F5D8C1E",
+    "_defaultCharacteristicName": "Standard"
+  },
+  "_difficultyBeatmapSets": [
+    {
+      "_beatmapCharacteristicName": "Standard",
+      "_difficultyBeatmaps": [
+        {
+          "_difficulty": "Hard", "_difficultyRank": 5, "_beatmapFilename": "HardStandard.dat", "_noteJumpMovementSpeed": 16, "_noteJumpStartBeatOffset": 0,
+          "_customData": {
+            "_difficultyLabel": "Hard",
+            "_requirements": [ "Chroma" ],
+            "_suggestions": [ "Cinema" ],
+            "_warnings": [],
+            "_information": [ "Lights by Lighter" ],
+            "_colorLeft": { "r": 0.78, "g": 0.13, "b": 0.21 },
+            "_colorRight": { "r": 0.16, "g": 0.55, "b": 0.82 }
+          }
+        },
+        {
+          "_difficulty": "Expert", "_difficultyRank": 7, "_beatmapFilename": "ExpertStandard.dat", "_noteJumpMovementSpeed": 18, "_noteJumpStartBeatOffset": -0.2,
+          "_customData": {
+            "_difficultyLabel": "Expert",
+            "_requirements": [ "Chroma", "Noodle Extensions" ],
+            "_suggestions": [ "Cinema" ],
+            "_warnings": [ "Flashing lights" ],
+            "_information": [ "Lights by Lighter" ],
+            "_colorLeft": { "r": 0.78, "g": 0.13, "b": 0.21 },
+            "_colorRight": { "r": 0.16, "g": 0.55, "b": 0.82 },
+            "_colorEnvLeft": { "r": 1.4, "g": 0.2, "b": 0.3 },
+            "_colorEnvRight": { "r": 0.2, "g": 0.6, "b": 1.6 },
+            "_colorObstacle": { "r": 1, "g": 0.2, "b": 0.2 }
+          }
+        },
+        {
+          "_difficulty": "ExpertPlus", "_difficultyRank": 9, "_beatmapFilename": "ExpertPlusStandard.dat", "_noteJumpMovementSpeed": 20, "_noteJumpStartBeatOffset": -0.5,
+          "_customData": {
+            "_difficultyLabel": "Showcase",
+            "_requirements": [ "Chroma", "Noodle Extensions", "Vivify" ],
+            "_suggestions": [ "Cinema" ],
+            "_warnings": [ "Flashing lights", "Heavy on performance" ],
+            "_information": [ "Lights by Lighter", "Made for the showcase" ],
+            "_colorLeft": { "r": 0.78, "g": 0.13, "b": 0.21 },
+            "_colorRight": { "r": 0.16, "g": 0.55, "b": 0.82 },
+            "_colorEnvLeft": { "r": 1.4, "g": 0.2, "b": 0.3 },
+            "_colorEnvRight": { "r": 0.2, "g": 0.6, "b": 1.6 },
+            "_colorEnvLeftBoost": { "r": 2.0, "g": 0.4, "b": 0.6 },
+            "_colorEnvRightBoost": { "r": 0.4, "g": 1.2, "b": 2.4 },
+            "_colorObstacle": { "r": 1, "g": 0.2, "b": 0.2 }
+          }
+        }
+      ]
+    },
+    {
+      "_beatmapCharacteristicName": "Lawless",
+      "_difficultyBeatmaps": [
+        {
+          "_difficulty": "Expert", "_difficultyRank": 7, "_beatmapFilename": "ExpertLawless.dat", "_noteJumpMovementSpeed": 18, "_noteJumpStartBeatOffset": 0,
+          "_customData": {
+            "_difficultyLabel": "Lawless",
+            "_requirements": [ "Mapping Extensions" ],
+            "_suggestions": [],
+            "_warnings": [],
+            "_information": []
+          }
+        },
+        {
+          "_difficulty": "Easy", "_difficultyRank": 1, "_beatmapFilename": "EasyLawless.dat", "_noteJumpMovementSpeed": 10, "_noteJumpStartBeatOffset": 0
+        }
+      ]
+    }
+  ]
+})";
+
+    /// @brief members in the order of ExtraSongData::Contributor, the decoders construct it the same way
+    struct Contributor {
+        std::string name, role, iconPath;
+    };
+
+    /// @brief contents of an MpBeatmapPacket without the il2cpp types
+    struct Beatmap {
+        std::string levelHash;
+        std::string songName, songSubName, songAuthorName, levelAuthorName;
+        float beatsPerMinute = 0;
+        float songDuration = 0;
+        std::string characteristic;
+        uint32_t difficulty = 0;
+        std::map<uint8_t, std::vector<std::string>> requirements;
+        std::vector<Contributor> contributors;
+        std::map<uint8_t, DifficultyColors> mapColors;
+    };
+
+    /// @brief a small vanilla-ish map, a typical modded one and a large one with many contributors
+    inline std::vector<Beatmap> Beatmaps() {
+        using Color = ExtraSongData::MapColor;
+        std::vector<Beatmap> beatmaps;
+
+        auto& small = beatmaps.emplace_back();
+        small.levelHash = "0F5A6F24F6AE4F2C3D4A9C7A4B0E3B2F1D2C3B4A";
+        small.songName = "Short Song";
+        small.songAuthorName = "Artist";
+        small.levelAuthorName = "Mapper";
+        small.beatsPerMinute = 128;
+        small.songDuration = 142.5f;
+        small.characteristic = "Standard";
+        small.difficulty = 3;
+
+        auto& typical = beatmaps.emplace_back();
+        typical.levelHash = "A1B2C3D4E5F60718293A4B5C6D7E8F9001122334";
+        typical.songName = "Ghost Mapping Showcase";
+        typical.songSubName = "Extended Mix";
+        typical.songAuthorName = "Some Artist";
+        typical.levelAuthorName = "Mapper, Lighter";
+        typical.beatsPerMinute = 174;
+        typical.songDuration = 241.2f;
+        typical.characteristic = "Standard";
+        typical.difficulty = 4;
+        typical.requirements[2] = { "Chroma" };
+        typical.requirements[3] = { "Chroma", "Noodle Extensions" };
+        typical.requirements[4] = { "Chroma", "Noodle Extensions", "Vivify" };
+        typical.contributors = {
+            { "Mapper", "Mapper", "mapper.png" },
+            { "Lighter", "Lighter", "lighter.png" },
+            { "Tester One", "Playtester", "" }
+        };
+        for (uint8_t diff = 2; diff <= 4; diff++) {
+            auto& colors = typical.mapColors[diff];
+            colors.colorLeft = Color(0.78f, 0.13f, 0.21f);
+            colors.colorRight = Color(0.16f, 0.55f, 0.82f);
+            if (diff >= 3) {
+                colors.envColorLeft = Color(1.4f, 0.2f, 0.3f);
+                colors.envColorRight = Color(0.2f, 0.6f, 1.6f);
+                colors.obstacleColor = Color(1.0f, 0.2f, 0.2f);
+            }
+        }
+
+        auto& large = beatmaps.emplace_back(typical);
+        large.levelHash = "FFEEDDCCBBAA99887766554433221100FFEEDDCC";
+        large.songName = "Collab Megamix (All Difficulties, Full Lightshow)";
+        large.levelAuthorName = "Mapper, Lighter, Another Mapper, Yet Another Mapper";
+        large.songDuration = 612.0f;
+        for (uint8_t diff = 0; diff <= 4; diff++)
+            large.requirements[diff] = { "Chroma", "Noodle Extensions", "Vivify", "Heck" };
+        for (int i = 0; i < 24; i++)
+            large.contributors.push_back({ "Collaborator " + std::to_string(i), i % 3 == 0 ? "Lightshow" : "Mapping", "icons/collaborator" + std::to_string(i) + ".png" });
+        for (uint8_t diff = 0; diff <= 4; diff++) {
+            auto& colors = large.mapColors[diff];
+            colors.colorLeft = Color(0.78f, 0.13f, 0.21f);
+            colors.colorRight = Color(0.16f, 0.55f, 0.82f);
+            colors.envColorLeft = Color(1.4f, 0.2f, 0.3f);
+            colors.envColorRight = Color(0.2f, 0.6f, 1.6f);
+            colors.envColorLeftBoost = Color(2.0f, 0.4f, 0.6f);
+            colors.envColorRightBoost = Color(0.4f, 1.2f, 2.4f);
+            colors.obstacleColor = Color(1.0f, 0.2f, 0.2f);
+        }
+
+        return beatmaps;
+    }
+
+    /// @brief LiteNetLib string, an int byte count followed by the utf8 bytes
+    inline void PutString(ByteWriter* writer, std::string_view value) {
+        writer->Put(static_cast<int32_t>(value.size()));
+        writer->Put(std::span<const uint8_t>(reinterpret_cast<const uint8_t*>(value.data()), value.size()));
+    }
+
+    /// @brief payload as MpBeatmapPacket::Serialize writes it
+    inline void WriteBeatmapPacket(ByteWriter* writer, const Beatmap& beatmap) {
+        PutString(writer, beatmap.levelHash);
+        PutString(writer, beatmap.songName);
+        PutString(writer, beatmap.songSubName);
+        PutString(writer, beatmap.songAuthorName);
+        PutString(writer, beatmap.levelAuthorName);
+        writer->Put(beatmap.beatsPerMinute);
+        writer->Put(beatmap.songDuration);
+
+        PutString(writer, beatmap.characteristic);
+        writer->Put(beatmap.difficulty);
+
+        writer->Put(uint8_t(beatmap.requirements.size()));
+        for (const auto& [key, value] : beatmap.requirements) {
+            writer->Put(key);
+            writer->Put(uint8_t(value.size()));
+            for (const auto& req : value) PutString(writer, req);
+        }
+
+        writer->Put(uint8_t(beatmap.contributors.size()));
+        for (const auto& contributor : beatmap.contributors) {
+            PutString(writer, contributor.name);
+            PutString(writer, contributor.role);
+            PutString(writer, contributor.iconPath);
+        }
+
+        writer->Put(uint8_t(beatmap.mapColors.size()));
+        for (const auto& [key, value] : beatmap.mapColors) {
+            writer->Put(key);
+            Beatmaps::Abstractions::DifficultyColorsEncoding::Write(writer, value);
+        }
+    }
+
+    /// @brief payload as MpCompactBeatmapPacket::Serialize writes it
+    inline void WriteCompactBeatmapPacket(ByteWriter* writer, const Beatmap& beatmap) {
+        using namespace Utils;
+        constexpr auto& members = Beatmaps::Abstractions::DifficultyColorsEncoding::Members<DifficultyColors>;
+
+        std::array<uint8_t, 20> rawHash;
+        bool isRawHash = HexBytes::Decode(beatmap.levelHash, rawHash.data(), rawHash.size());
+        writer->Put(uint8_t(isRawHash ? 1 : 0));
+        if (isRawHash) writer->Put(std::span<const uint8_t>(rawHash));
+        else CompactString::Write(writer, beatmap.levelHash);
+
+        CompactString::Write(writer, beatmap.songName);
+        CompactString::Write(writer, beatmap.songSubName);
+        CompactString::Write(writer, beatmap.songAuthorName);
+        CompactString::Write(writer, beatmap.levelAuthorName);
+        writer->Put(beatmap.beatsPerMinute);
+        writer->Put(beatmap.songDuration);
+
+        CompactString::Write(writer, beatmap.characteristic);
+        VarInt::Write(writer, beatmap.difficulty);
+
+        std::vector<std::string_view> stringTable;
+        auto indexOf = [&stringTable](std::string_view value) -> uint32_t {
+            auto itr = std::find(stringTable.begin(), stringTable.end(), value);
+            if (itr != stringTable.end()) return itr - stringTable.begin();
+            stringTable.push_back(value);
+            return stringTable.size() - 1;
+        };
+        for (const auto& [key, value] : beatmap.requirements)
+            for (const auto& req : value) indexOf(req);
+
+        VarInt::Write(writer, stringTable.size());
+        for (auto str : stringTable) CompactString::Write(writer, str);
+
+        VarInt::Write(writer, beatmap.requirements.size());
+        for (const auto& [key, value] : beatmap.requirements) {
+            writer->Put(key);
+            VarInt::Write(writer, value.size());
+            for (const auto& req : value) VarInt::Write(writer, indexOf(req));
+        }
+
+        VarInt::Write(writer, beatmap.contributors.size());
+        for (const auto& contributor : beatmap.contributors) {
+            CompactString::Write(writer, contributor.name);
+            CompactString::Write(writer, contributor.role);
+            CompactString::Write(writer, contributor.iconPath);
+        }
+
+        VarInt::Write(writer, beatmap.mapColors.size());
+        for (const auto& [key, value] : beatmap.mapColors) {
+            uint8_t present = 0, wide = 0;
+            for (std::size_t i = 0; i < members.size(); i++) {
+                const auto& color = value.*members[i];
+                if (!color.has_value()) continue;
+                present |= 1 << i;
+                if (!UnitFloat8::Fits(color->r) || !UnitFloat8::Fits(color->g) || !UnitFloat8::Fits(color->b)) wide |= 1 << i;
+            }
+
+            writer->Put(key);
+            writer->Put(present);
+            writer->Put(wide);
+            for (std::size_t i = 0; i < members.size(); i++) {
+                const auto& color = value.*members[i];
+                if (!color.has_value()) continue;
+                if (wide & (1 << i)) {
+                    writer->Put(HalfFloat::FromFloat(color->r));
+                    writer->Put(HalfFloat::FromFloat(color->g));
+                    writer->Put(HalfFloat::FromFloat(color->b));
+                } else {
+                    writer->Put(UnitFloat8::FromFloat(color->r));
+                    writer->Put(UnitFloat8::FromFloat(color->g));
+                    writer->Put(UnitFloat8::FromFloat(color->b));
+                }
+            }
+        }
+    }
+}
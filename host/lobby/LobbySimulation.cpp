@@ -0,0 +1,303 @@
+#include "LobbySimulation.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <numeric>
+
+namespace MultiplayerCore::Host::Lobby {
+    // roughly what the game's own pose sync packets take per player, they don't go through MpCore
+    // but the rates they are sent at are what MpNodePoseSyncStatePacket sets
+    static constexpr uint64_t PoseDeltaBytes = 36;
+    static constexpr uint64_t PoseFullBytes = 96;
+
+    LobbySimulation::LobbySimulation(uint32_t seed) : random(seed) {
+        Connect(VirtualPeer::Role::Server);
+    }
+
+    LobbySimulation::~LobbySimulation() = default;
+
+    VirtualPeer& LobbySimulation::Connect(VirtualPeer::Role role) {
+        auto& member = members.emplace_back();
+        member.peer = std::make_unique<VirtualPeer>(members.size() - 1, role, *this);
+        auto peer = member.peer.get();
+        peer->Initialize();
+        if (capture && !captureAttached && role != VirtualPeer::Role::Server) {
+            peer->set_capture(capture.get());
+            captureAttached = true;
+        }
+
+        std::vector<VirtualPeer*> existing;
+        for (auto& other : members)
+            if (other.connected) existing.push_back(other.peer.get());
+
+        for (auto other : existing) {
+            MemberOf(other).connections.push_back(peer);
+            member.connections.push_back(other);
+        }
+        member.connected = true;
+        member.joined = time;
+        member.nextPoseDelta = member.nextPoseFull = time;
+
+        for (auto other : existing) {
+            other->HandlePlayerConnected(peer);
+            peer->HandlePlayerConnected(other);
+        }
+        return *peer;
+    }
+
+    VirtualPeer& LobbySimulation::AddPlayer(VirtualPeer::Role role) {
+        auto& peer = Connect(role);
+        // a joining player asks the lobby for their selected beatmaps once connected, everyone who has one sends it to the whole lobby again.
+        // The request is a game rpc that goes out after the registry exchange the connection started, so it's handled a frame later
+        At(time + FrameTime, [this, &peer]() {
+            if (!MemberOf(&peer).connected) return;
+            for (auto player : get_players())
+                if (player != &peer) player->ResendSelectedBeatmap();
+        });
+        return peer;
+    }
+
+    void LobbySimulation::RemovePlayer(VirtualPeer& player) {
+        auto& member = MemberOf(&player);
+        if (!member.connected || player.get_isConnectionOwner()) return;
+
+        member.connected = false;
+        member.left = time;
+        member.inbox.clear();
+        for (auto other : std::exchange(member.connections, {})) {
+            std::erase(MemberOf(other).connections, &player);
+            other->HandlePlayerDisconnected(&player);
+        }
+    }
+
+    std::vector<VirtualPeer*> LobbySimulation::get_players() const {
+        std::vector<VirtualPeer*> players;
+        for (auto& member : members)
+            if (member.connected && !member.peer->get_isConnectionOwner()) players.push_back(member.peer.get());
+        return players;
+    }
+
+    std::span<VirtualPeer* const> LobbySimulation::ConnectedPlayers(const VirtualPeer* sender) const {
+        return MemberOf(sender).connections;
+    }
+
+    void LobbySimulation::At(std::chrono::milliseconds time, std::function<void()> event) {
+        events.emplace(time, std::move(event));
+    }
+
+    void LobbySimulation::Every(std::chrono::milliseconds start, std::chrono::milliseconds interval, std::function<void()> event) {
+        At(start, [this, start, interval, event = std::move(event)]() {
+            event();
+            Every(start + interval, interval, event);
+        });
+    }
+
+    void LobbySimulation::Send(VirtualPeer* sender, VirtualPeer* target, std::vector<uint8_t> frame, uint64_t serializeNanos) {
+        auto& from = MemberOf(sender);
+        if (!from.connected) return;
+        framesSent++;
+
+        // everything goes through the server, players upload a frame once and the server sends it on to each receiver
+        auto size = frame.size();
+        if (!sender->get_isConnectionOwner()) from.uploadBytes += size;
+
+        auto shared = std::make_shared<const std::vector<uint8_t>>(std::move(frame));
+        auto deliver = [&](VirtualPeer* receiver) {
+            auto& to = MemberOf(receiver);
+            if (!receiver->get_isConnectionOwner()) to.downloadBytes += size;
+            to.inbox.push_back(Message{ sender, shared, serializeNanos });
+        };
+
+        if (target) {
+            if (MemberOf(target).connected) deliver(target);
+        } else {
+            for (auto receiver : from.connections) deliver(receiver);
+        }
+    }
+
+    void LobbySimulation::SendPoseUpdates() {
+        std::size_t players = get_players().size();
+        if (players < 2) return;
+
+        for (auto& member : members) {
+            if (!member.connected || member.peer->get_isConnectionOwner()) continue;
+            auto& peer = *member.peer;
+            // sent to every other player
+            while (member.nextPoseDelta <= time) {
+                poseDownloadBytes += PoseDeltaBytes * (players - 1);
+                member.nextPoseDelta += std::chrono::milliseconds(std::max<int64_t>(1, peer.get_deltaUpdateFrequencyMs()));
+            }
+            while (member.nextPoseFull <= time) {
+                poseDownloadBytes += PoseFullBytes * (players - 1);
+                member.nextPoseFull += std::chrono::milliseconds(std::max<int64_t>(1, peer.get_fullStateUpdateFrequencyMs()));
+            }
+        }
+    }
+
+    void LobbySimulation::Deliver() {
+        // handling a packet can send more, e.g. registries get acknowledged, so keep going until everything settled
+        bool delivered = true;
+        while (delivered) {
+            delivered = false;
+            for (auto& member : members) {
+                if (member.inbox.empty()) continue;
+                delivered = true;
+
+                auto inbox = std::exchange(member.inbox, {});
+                // time this peer has been busy with this frame's packets, each one waits for the ones before it
+                uint64_t busyNanos = 0;
+                for (auto& message : inbox) {
+                    if (!member.connected || !MemberOf(message.sender).connected) continue;
+
+                    auto start = std::chrono::steady_clock::now();
+                    member.peer->Receive(message.sender, *message.frame, std::chrono::steady_clock::time_point(time));
+                    busyNanos += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+                    latencies.push_back(message.serializeNanos + busyNanos);
+                    framesDelivered++;
+                }
+            }
+        }
+    }
+
+    bool LobbySimulation::CaptureFirstPlayer(const std::string& path) {
+        capture = std::make_unique<Networking::PacketCaptureWriter>();
+        // packet times are simulated time, a replay at recorded speed plays the lobby out in real time
+        return capture->Start(path, std::chrono::steady_clock::time_point(time));
+    }
+
+    void LobbySimulation::Run(std::chrono::milliseconds duration) {
+        auto start = std::chrono::steady_clock::now();
+        auto end = time + duration;
+        for (; time <= end; time += FrameTime) {
+            while (!events.empty() && events.begin()->first <= time) {
+                auto event = std::move(events.begin()->second);
+                events.erase(events.begin());
+                event();
+            }
+            SendPoseUpdates();
+            Deliver();
+        }
+        time = end;
+        wallTime += std::chrono::steady_clock::now() - start;
+    }
+
+    RunReport LobbySimulation::Report(std::string scenario, std::size_t players) const {
+        RunReport report;
+        report.scenario = std::move(scenario);
+        report.players = players;
+        report.seconds = std::chrono::duration<double>(time).count();
+        report.wallMillis = std::chrono::duration<double, std::milli>(wallTime).count();
+        report.framesSent = framesSent;
+        report.framesDelivered = framesDelivered;
+
+        double playerSeconds = 0;
+        uint64_t uploadBytes = 0, downloadBytes = 0;
+        for (auto& member : members) {
+            auto& peer = *member.peer;
+            report.errors += peer.get_errorCount();
+            for (std::size_t i = 0; i < report.packets.size(); i++) {
+                auto& stats = peer.get_handlerStats(static_cast<PacketType>(i));
+                report.packets[i].handler.count += stats.count;
+                report.packets[i].handler.nanos += stats.nanos;
+            }
+            peer.get_metrics().ForEachPacket([&report](std::string_view name, const Networking::PacketTypeMetrics& metrics) {
+                auto type = std::find(PacketNames.begin(), PacketNames.end(), name);
+                if (type == PacketNames.end()) return;
+                auto& packet = report.packets[type - PacketNames.begin()];
+                packet.sentCount += metrics.sentCount.load(std::memory_order_relaxed);
+                packet.sentBytes += metrics.sentBytes.load(std::memory_order_relaxed);
+                packet.receivedCount += metrics.receivedCount.load(std::memory_order_relaxed);
+                packet.receivedBytes += metrics.receivedBytes.load(std::memory_order_relaxed);
+                packet.droppedCount += metrics.droppedCount.load(std::memory_order_relaxed);
+            });
+            // senders also count what was dropped before its packet type was known
+            peer.get_metrics().ForEachSender([&report](std::string_view, const Networking::SenderMetrics& metrics) {
+                report.dropped += metrics.droppedCount.load(std::memory_order_relaxed);
+            });
+
+            if (peer.get_isConnectionOwner()) continue;
+            playerSeconds += std::chrono::duration<double>((member.connected ? time : member.left) - member.joined).count();
+            uploadBytes += member.uploadBytes;
+            downloadBytes += member.downloadBytes;
+        }
+
+        if (playerSeconds > 0) {
+            report.playerUploadBytesPerSecond = uploadBytes / playerSeconds;
+            report.playerDownloadBytesPerSecond = downloadBytes / playerSeconds;
+            report.poseDownloadBytesPerSecond = poseDownloadBytes / playerSeconds;
+        }
+        if (report.seconds > 0) report.serverEgressBytesPerSecond = downloadBytes / report.seconds;
+
+        if (!latencies.empty()) {
+            auto sorted = latencies;
+            auto percentile = [&sorted](double fraction) {
+                auto nth = sorted.begin() + std::min<std::size_t>(sorted.size() - 1, fraction * sorted.size());
+                std::nth_element(sorted.begin(), nth, sorted.end());
+                return *nth;
+            };
+            report.latencyP50 = percentile(0.5);
+            report.latencyP99 = percentile(0.99);
+            report.latencyMax = *std::max_element(sorted.begin(), sorted.end());
+        }
+        return report;
+    }
+
+    uint64_t RunReport::HandlerNanos() const {
+        return std::accumulate(packets.begin(), packets.end(), uint64_t(0), [](uint64_t sum, const PacketReport& packet) { return sum + packet.handler.nanos; });
+    }
+
+    void RunReport::Write(std::ostream& out) const {
+        auto flags = out.flags();
+        out << std::fixed << std::setprecision(1);
+        out << scenario << ", " << players << " players, " << seconds << " s simulated in " << wallMillis << " ms\n";
+        out << "  frames         " << framesSent << " sent, " << framesDelivered << " delivered, " << errors << " errors, " << dropped << " dropped\n";
+        out << "  per player     up " << playerUploadBytesPerSecond / 1000 << " kB/s, down " << playerDownloadBytesPerSecond / 1000
+            << " kB/s (game pose sync ~" << poseDownloadBytesPerSecond / 1000 << " kB/s down)\n";
+        out << "  server egress  " << serverEgressBytesPerSecond / 1000 << " kB/s\n";
+        out << "  latency        p50 " << latencyP50 / 1000.0 << " us, p99 " << latencyP99 / 1000.0 << " us, max " << latencyMax / 1000.0 << " us\n";
+
+        double handlerMillis = HandlerNanos() / 1e6;
+        out << "  handler cpu    " << handlerMillis << " ms total, " << (players && seconds > 0 ? handlerMillis * 1000 / players / seconds : 0) << " us/s per player\n";
+
+        out << "  " << std::left << std::setw(28) << "packet" << std::right
+            << std::setw(10) << "sent" << std::setw(12) << "sent kB"
+            << std::setw(10) << "received" << std::setw(12) << "recv kB" << std::setw(10) << "dropped"
+            << std::setw(12) << "handler ms" << std::setw(10) << "ns/call" << '\n';
+        for (std::size_t i = 0; i < packets.size(); i++) {
+            auto& packet = packets[i];
+            if (packet.sentCount == 0 && packet.receivedCount == 0) continue;
+            out << "  " << std::left << std::setw(28) << PacketNames[i] << std::right
+                << std::setw(10) << packet.sentCount << std::setw(12) << packet.sentBytes / 1000.0
+                << std::setw(10) << packet.receivedCount << std::setw(12) << packet.receivedBytes / 1000.0 << std::setw(10) << packet.droppedCount
+                << std::setw(12) << packet.handler.nanos / 1e6
+                << std::setw(10) << (packet.handler.count ? packet.handler.nanos / packet.handler.count : 0) << '\n';
+        }
+        out.flags(flags);
+    }
+
+    void RunReport::WriteJson(std::ostream& out) const {
+        out << "{\"scenario\":\"" << scenario << "\",\"players\":" << players
+            << ",\"seconds\":" << seconds << ",\"wallMillis\":" << wallMillis
+            << ",\"framesSent\":" << framesSent << ",\"framesDelivered\":" << framesDelivered << ",\"errors\":" << errors << ",\"dropped\":" << dropped
+            << ",\"playerUploadBytesPerSecond\":" << playerUploadBytesPerSecond
+            << ",\"playerDownloadBytesPerSecond\":" << playerDownloadBytesPerSecond
+            << ",\"serverEgressBytesPerSecond\":" << serverEgressBytesPerSecond
+            << ",\"poseDownloadBytesPerSecond\":" << poseDownloadBytesPerSecond
+            << ",\"latencyNanos\":{\"p50\":" << latencyP50 << ",\"p99\":" << latencyP99 << ",\"max\":" << latencyMax << '}'
+            << ",\"handlerNanos\":" << HandlerNanos()
+            << ",\"packets\":{";
+
+        bool first = true;
+        for (std::size_t i = 0; i < packets.size(); i++) {
+            auto& packet = packets[i];
+            if (packet.sentCount == 0 && packet.receivedCount == 0) continue;
+            if (!first) out << ',';
+            first = false;
+            out << '"' << PacketNames[i] << "\":{\"sent\":" << packet.sentCount << ",\"sentBytes\":" << packet.sentBytes
+                << ",\"received\":" << packet.receivedCount << ",\"receivedBytes\":" << packet.receivedBytes << ",\"dropped\":" << packet.droppedCount
+                << ",\"handled\":" << packet.handler.count << ",\"handlerNanos\":" << packet.handler.nanos << '}';
+        }
+        out << "}}\n";
+    }
+}
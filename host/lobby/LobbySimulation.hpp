@@ -0,0 +1,142 @@
+#pragma once
+
+#include "VirtualPeer.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace MultiplayerCore::Host::Lobby {
+    /// @brief totals of one packet type over every peer of a run
+    struct PacketReport {
+        uint64_t sentCount = 0;
+        uint64_t sentBytes = 0;
+        uint64_t receivedCount = 0;
+        uint64_t receivedBytes = 0;
+        uint64_t droppedCount = 0;
+        HandlerStats handler;
+    };
+
+    struct RunReport {
+        std::string scenario;
+        std::size_t players = 0;
+        double seconds = 0;
+        double wallMillis = 0;
+
+        /// @brief frames handed to the transport, and how many peers received them
+        uint64_t framesSent = 0;
+        uint64_t framesDelivered = 0;
+        uint64_t errors = 0;
+        /// @brief received frames that went over a decode budget
+        uint64_t dropped = 0;
+
+        /// @brief MpCore bytes per second and connected player, what goes up to the server and comes back down
+        double playerUploadBytesPerSecond = 0;
+        double playerDownloadBytesPerSecond = 0;
+        /// @brief MpCore bytes per second the server relays to the players
+        double serverEgressBytesPerSecond = 0;
+        /// @brief estimate of the game's own pose sync bytes per second and player, for scale
+        double poseDownloadBytesPerSecond = 0;
+
+        /// @brief time from a send until the receiver is done handling the packet, in nanoseconds
+        uint64_t latencyP50 = 0;
+        uint64_t latencyP99 = 0;
+        uint64_t latencyMax = 0;
+
+        std::array<PacketReport, static_cast<std::size_t>(PacketType::Count)> packets;
+
+        uint64_t HandlerNanos() const;
+
+        void Write(std::ostream& out) const;
+        /// @brief write the report as a single line of json
+        void WriteJson(std::ostream& out) const;
+    };
+
+    /// @brief a lobby of virtual peers connected through a dedicated server, all in process.
+    /// Time is simulated in frames, every frame runs the scripted events that are due and then delivers
+    /// everything that was sent until no peer has anything left to handle. Network time is not simulated,
+    /// message latency is the time MpCore adds: framing at the sender, then decoding and handling at the receiver,
+    /// behind whatever arrived before it in the same frame
+    class LobbySimulation : public Transport {
+        public:
+            static constexpr std::chrono::milliseconds FrameTime{10};
+
+            explicit LobbySimulation(uint32_t seed);
+            ~LobbySimulation();
+
+            /// @brief connect a new player, every connected peer and the new one get their player connected events
+            VirtualPeer& AddPlayer(VirtualPeer::Role role = VirtualPeer::Role::Player);
+            void RemovePlayer(VirtualPeer& player);
+
+            VirtualPeer& get_server() { return *members.front().peer; }
+            /// @brief connected players, without the server
+            std::vector<VirtualPeer*> get_players() const;
+            std::mt19937& get_random() { return random; }
+            std::chrono::milliseconds get_time() const { return time; }
+
+            /// @brief run event once the simulation reaches time
+            void At(std::chrono::milliseconds time, std::function<void()> event);
+            /// @brief run event at start and every interval after that
+            void Every(std::chrono::milliseconds start, std::chrono::milliseconds interval, std::function<void()> event);
+
+            /// @brief record what the first player to join receives into a packet capture at path, for mpcore-replay
+            /// @return false if path could not be opened
+            bool CaptureFirstPlayer(const std::string& path);
+
+            void Run(std::chrono::milliseconds duration);
+            RunReport Report(std::string scenario, std::size_t players) const;
+
+            void Send(VirtualPeer* sender, VirtualPeer* target, std::vector<uint8_t> frame, uint64_t serializeNanos) override;
+            std::span<VirtualPeer* const> ConnectedPlayers(const VirtualPeer* sender) const override;
+
+        private:
+            struct Message {
+                VirtualPeer* sender;
+                std::shared_ptr<const std::vector<uint8_t>> frame;
+                uint64_t serializeNanos;
+            };
+
+            struct Member {
+                std::unique_ptr<VirtualPeer> peer;
+                bool connected = false;
+                std::chrono::milliseconds joined{0};
+                std::chrono::milliseconds left{0};
+                std::vector<VirtualPeer*> connections;
+                std::vector<Message> inbox;
+                uint64_t uploadBytes = 0;
+                uint64_t downloadBytes = 0;
+                std::chrono::milliseconds nextPoseDelta{0};
+                std::chrono::milliseconds nextPoseFull{0};
+            };
+
+            Member& MemberOf(const VirtualPeer* peer) { return members[peer->get_index()]; }
+            const Member& MemberOf(const VirtualPeer* peer) const { return members[peer->get_index()]; }
+
+            VirtualPeer& Connect(VirtualPeer::Role role);
+            void SendPoseUpdates();
+            void Deliver();
+
+            std::mt19937 random;
+            std::chrono::milliseconds time{0};
+            std::chrono::nanoseconds wallTime{0};
+            std::multimap<std::chrono::milliseconds, std::function<void()>> events;
+            // never shrinks, peers that left stay around so their address is never reused by a new one
+            std::vector<Member> members;
+
+            uint64_t framesSent = 0;
+            uint64_t framesDelivered = 0;
+            uint64_t poseDownloadBytes = 0;
+            std::vector<uint64_t> latencies;
+
+            std::unique_ptr<Networking::PacketCaptureWriter> capture;
+            bool captureAttached = false;
+    };
+}
@@ -0,0 +1,98 @@
+#include "Scenarios.hpp"
+
+#include <memory>
+#include <random>
+
+using namespace std::chrono_literals;
+
+namespace MultiplayerCore::Host::Lobby {
+    static const std::vector<Samples::Beatmap>& SampleBeatmaps() {
+        static auto beatmaps = Samples::Beatmaps();
+        return beatmaps;
+    }
+
+    static const Samples::Beatmap& RandomBeatmap(LobbySimulation& lobby) {
+        auto& beatmaps = SampleBeatmaps();
+        return beatmaps[std::uniform_int_distribution<std::size_t>(0, beatmaps.size() - 1)(lobby.get_random())];
+    }
+
+    static VirtualPeer* RandomPlayer(LobbySimulation& lobby) {
+        auto players = lobby.get_players();
+        if (players.empty()) return nullptr;
+        return players[std::uniform_int_distribution<std::size_t>(0, players.size() - 1)(lobby.get_random())];
+    }
+
+    /// @brief players join one after the other, like a lobby filling up, and pick a beatmap shortly after joining
+    static void Fill(LobbySimulation& lobby, std::size_t players, bool legacyHalf = false) {
+        for (std::size_t i = 0; i < players; i++) {
+            auto joinAt = 20ms * i;
+            auto role = legacyHalf && i % 2 ? VirtualPeer::Role::LegacyPlayer : VirtualPeer::Role::Player;
+            lobby.At(joinAt, [&lobby, role]() {
+                auto& player = lobby.AddPlayer(role);
+                lobby.At(lobby.get_time() + 1s, [&lobby, &player]() { player.SelectBeatmap(RandomBeatmap(lobby)); });
+            });
+        }
+    }
+
+    /// @brief everyone has joined and picked a beatmap by then
+    static constexpr auto Settled = 5s;
+
+    static void Steady(LobbySimulation& lobby, std::size_t players) {
+        Fill(lobby, players);
+    }
+
+    static void SongPicks(LobbySimulation& lobby, std::size_t players) {
+        Fill(lobby, players);
+        lobby.Every(Settled, 50ms, [&lobby]() {
+            if (auto player = RandomPlayer(lobby)) player->SelectBeatmap(RandomBeatmap(lobby));
+        });
+    }
+
+    static void Churn(LobbySimulation& lobby, std::size_t players) {
+        Fill(lobby, players);
+        lobby.Every(Settled, 250ms, [&lobby]() {
+            if (auto player = RandomPlayer(lobby)) lobby.RemovePlayer(*player);
+            auto& player = lobby.AddPlayer();
+            lobby.At(lobby.get_time() + 1s, [&lobby, &player]() { player.SelectBeatmap(RandomBeatmap(lobby)); });
+        });
+    }
+
+    static void PoseRates(LobbySimulation& lobby, std::size_t players) {
+        Fill(lobby, players);
+        // delta and full state rates the server cycles through, the first one is the default
+        static constexpr std::pair<int64_t, int64_t> Rates[] = { { 10, 100 }, { 20, 200 }, { 50, 500 }, { 5, 50 } };
+        auto step = std::make_shared<std::size_t>(0);
+        lobby.Every(Settled, 5s, [&lobby, step]() {
+            auto [delta, full] = Rates[++*step % std::size(Rates)];
+            lobby.get_server().SendNodePoseSyncState(delta, full);
+        });
+    }
+
+    static void MixedVersions(LobbySimulation& lobby, std::size_t players) {
+        Fill(lobby, players, true);
+        lobby.Every(Settled, 50ms, [&lobby]() {
+            if (auto player = RandomPlayer(lobby)) player->SelectBeatmap(RandomBeatmap(lobby));
+        });
+    }
+
+    static void BeatmapFlood(LobbySimulation& lobby, std::size_t players) {
+        Fill(lobby, players);
+        // the first player to join resends their selection every millisecond, far beyond the beatmap packet budget
+        lobby.Every(Settled, 1ms, [&lobby]() {
+            auto players = lobby.get_players();
+            if (!players.empty()) players.front()->ResendSelectedBeatmap();
+        });
+    }
+
+    const std::vector<Scenario>& Scenarios() {
+        static const std::vector<Scenario> scenarios = {
+            { "steady", "the lobby fills up and everyone picks a beatmap once", &Steady },
+            { "song-picks", "a random player picks a new beatmap every 50 ms", &SongPicks },
+            { "churn", "a random player leaves and a new one joins every 250 ms", &Churn },
+            { "pose-rates", "the server changes the pose sync rates every 5 s", &PoseRates },
+            { "mixed-versions", "song-picks with every other player on an MpCore version without the packet registry", &MixedVersions },
+            { "beatmap-flood", "one player sends their beatmap packet 1000 times a second, which receivers drop over budget", &BeatmapFlood }
+        };
+        return scenarios;
+    }
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "LobbySimulation.hpp"
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+namespace MultiplayerCore::Host::Lobby {
+    /// @brief scripted lobby behaviour, script schedules its events on a fresh lobby of the given size
+    struct Scenario {
+        std::string_view name;
+        std::string_view description;
+        void (*script)(LobbySimulation& lobby, std::size_t players);
+    };
+
+    const std::vector<Scenario>& Scenarios();
+}
@@ -0,0 +1,235 @@
+#include "VirtualPeer.hpp"
+
+#include <algorithm>
+
+using MultiplayerCore::Networking::PacketDispatch;
+using MultiplayerCore::Networking::PacketFraming;
+
+namespace MultiplayerCore::Host::Lobby {
+    // the serializer's default
+    static constexpr std::size_t CompressionThreshold = 256;
+    // MpPlayersDataModel's budget for beatmap packets
+    static constexpr uint32_t MaxBeatmapPacketBytes = 16 * 1024;
+    static constexpr uint32_t MaxBeatmapPacketsPerSecond = 60;
+
+    template<typename TPacket>
+    static void DeserializeMember(ByteReader* reader, TPacket& packet) { packet.Deserialize(reader); }
+
+    VirtualPeer::VirtualPeer(uint32_t index, Role role, Transport& transport) :
+        index(index),
+        role(role),
+        // looks like a platform user id, and keeps the sender metrics apart
+        userId(std::to_string(76561198000000000ull + index)),
+        transport(transport) {}
+
+    void VirtualPeer::Initialize() {
+        // MpPacketSerializer::Initialize, older versions had no registry to exchange
+        if (role != Role::LegacyPlayer) {
+            RegisterCallback<Packets::PacketRegistryPacket>(PacketType::PacketRegistry, &DeserializeMember, &VirtualPeer::HandlePacketRegistry);
+            RegisterCallback<Packets::PacketRegistryAckPacket>(PacketType::PacketRegistryAck, &DeserializeMember, &VirtualPeer::HandlePacketRegistryAck);
+            // unpacked by the serializer itself, the frames in them go through dispatch like any other
+            RegisterHandler(PacketType::PacketBatch, [this](ByteReader* reader, int length, VirtualPeer* player){ PacketDispatch::Batch(*this, reader, length, player); });
+            RegisterHandler(PacketType::PacketChunk, [this](ByteReader* reader, int length, VirtualPeer* player){ PacketDispatch::Chunk(*this, reader, length, player); });
+        }
+
+        // MpPlayerManager::Initialize
+        RegisterCallback<Packets::PlayerData>(PacketType::PlayerData, &DeserializeMember, &VirtualPeer::HandlePlayerData);
+        if (role != Role::Server) {
+            ByteWriter writer;
+            Packets::PlayerData{ userId, 3 /* OculusQuest */, "1.37.0" }.Serialize(&writer);
+            auto written = writer.written();
+            localPlayerDataPayload.assign(written.begin(), written.end());
+        }
+
+        // MpPlayersDataModel::Activate
+        RegisterCallback<Samples::Beatmap>(PacketType::Beatmap, &Beatmaps::Packets::MpBeatmapPacketEncoding::Read<ByteReader*, Samples::Beatmap>, &VirtualPeer::HandleBeatmapPacket);
+        if (role != Role::LegacyPlayer) {
+            RegisterCallback<Samples::Beatmap>(PacketType::CompactBeatmap, &Beatmaps::Packets::MpCompactBeatmapPacketEncoding::Read<ByteReader*, Samples::Beatmap>, &VirtualPeer::HandleBeatmapPacket);
+            compressedTypes.insert(PacketType::CompactBeatmap);
+            decodeBudget.SetPacketLimits(NameOf(PacketType::CompactBeatmap), { MaxBeatmapPacketBytes, MaxBeatmapPacketsPerSecond });
+        }
+        decodeBudget.SetPacketLimits(NameOf(PacketType::Beatmap), { MaxBeatmapPacketBytes, MaxBeatmapPacketsPerSecond });
+
+        // MpNodePoseSyncStateManager::Initialize
+        RegisterCallback<Packets::NodePoseSyncStatePacket>(PacketType::NodePoseSyncState, &DeserializeMember, &VirtualPeer::HandleNodePoseSyncState);
+    }
+
+    template<typename TPacket>
+    void VirtualPeer::RegisterCallback(PacketType type, void (*deserialize)(ByteReader*, TPacket&), void (VirtualPeer::*handler)(TPacket&, VirtualPeer*)) {
+        RegisterHandler(type, [this, type, deserialize, handler](ByteReader* reader, int, VirtualPeer* player) {
+            auto handleStart = std::chrono::steady_clock::now();
+            TPacket packet;
+            deserialize(reader, packet);
+            (this->*handler)(packet, player);
+
+            auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - handleStart).count();
+            auto& stats = handlerStats[static_cast<std::size_t>(type)];
+            stats.count++;
+            stats.nanos += nanos;
+            handledNanos += nanos;
+        });
+    }
+
+    void VirtualPeer::RegisterHandler(PacketType type, PacketHandler handler) {
+        RegisterPacketId(type);
+        packetHandlers.set(NameOf(type), std::move(handler));
+    }
+
+    void VirtualPeer::RegisterPacketId(PacketType type) {
+        if (role == Role::LegacyPlayer || !packetRegistry.Register(type, NameOf(type))) return;
+
+        // late registrations need to be announced to everyone already in the lobby
+        if (!transport.ConnectedPlayers(this).empty()) SendPacketRegistry(nullptr);
+    }
+
+    void VirtualPeer::HandlePlayerConnected(VirtualPeer* player) {
+        // MpPacketSerializer, new players never know our ids yet, so fall back to names until they acknowledge
+        if (role != Role::LegacyPlayer) {
+            UpdateCompactPacketIdLimit();
+            SendPacketRegistry(player);
+        }
+
+        // MpPlayerManager, everyone else got our data when they joined, so only the new player needs it
+        if (!localPlayerDataPayload.empty()) Send(PacketType::PlayerData, localPlayerDataPayload, player);
+    }
+
+    void VirtualPeer::HandlePlayerDisconnected(VirtualPeer* player) {
+        packetRegistry.RemovePeer(player);
+        decodeBudget.RemovePeer(player);
+        incomingTransfers.RemovePeer(player);
+        metrics->RemoveSender(player->userId);
+        playerData.erase(player);
+        selectedBeatmaps.erase(player);
+        UpdateCompactPacketIdLimit();
+    }
+
+    uint64_t VirtualPeer::Receive(VirtualPeer* sender, std::span<const uint8_t> frame, std::chrono::steady_clock::time_point now) {
+        receivedAt = now;
+        handledNanos = 0;
+        ByteReader reader(frame);
+        PacketDispatch::Receive(*this, &reader, frame.size(), sender);
+        return handledNanos;
+    }
+
+    uint64_t VirtualPeer::ReceivePayload(VirtualPeer* sender, std::string_view packetName, uint8_t frameFlags, std::span<const uint8_t> payload, std::chrono::steady_clock::time_point now) {
+        receivedAt = now;
+        handledNanos = 0;
+        auto packetKey = Networking::KeyOf(packetName);
+        if (!PacketDispatch::AcceptSender(*this, sender, packetKey, payload.size())) return 0;
+
+        ByteReader reader(payload);
+        PacketDispatch::Dispatch(*this, &reader, payload.size(), sender, packetName, packetKey, frameFlags, payload.size());
+        return handledNanos;
+    }
+
+    void VirtualPeer::CapturePacket(Networking::CapturedPacket::Direction direction, VirtualPeer* peer, std::string_view packetName, uint8_t frameFlags, std::span<const uint8_t> payload) {
+        // not captured themselves, the frames in them are
+        if (packetName == NameOf(PacketType::PacketBatch) || packetName == NameOf(PacketType::PacketChunk)) return;
+        capture->Record(direction, peer->userId, packetName, frameFlags, payload, receivedAt);
+    }
+
+    std::vector<uint8_t> VirtualPeer::Frame(PacketType type, std::span<const uint8_t> payload, VirtualPeer* target) {
+        // if every receiver knows this packet's id we can send a null name followed by the id instead of the full name
+        frameWriter.Reset();
+        auto packetId = packetRegistry.IdOf(type);
+        if (packetId < packetRegistry.LimitFor(target)) {
+            int flagPosition = PacketFraming::WriteCompactHeader(&frameWriter, packetId);
+            int payloadStart = frameWriter.get_Length();
+            frameWriter.Put(payload);
+            if (compressedTypes.contains(type)) PacketFraming::CompressPayload(&frameWriter, flagPosition, payloadStart, CompressionThreshold);
+        } else {
+            PacketFraming::WriteNameHeader(&frameWriter, NameOf(type));
+            frameWriter.Put(payload);
+        }
+
+        auto written = frameWriter.written();
+        metrics->RecordSent(metrics->ForPacket(NameOf(type)), written.size());
+        return { written.begin(), written.end() };
+    }
+
+    void VirtualPeer::Send(PacketType type, std::span<const uint8_t> payload, VirtualPeer* target) {
+        auto start = std::chrono::steady_clock::now();
+        auto frame = Frame(type, payload, target);
+        auto serializeNanos = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+        transport.Send(this, target, std::move(frame), serializeNanos);
+    }
+
+    void VirtualPeer::SendWithFallback(PacketType type, std::span<const uint8_t> payload, PacketType fallbackType, std::span<const uint8_t> fallbackPayload) {
+        std::vector<VirtualPeer*> handling, notHandling;
+        for (auto player : transport.ConnectedPlayers(this))
+            (packetRegistry.PeerHandles(player, NameOf(type)) ? handling : notHandling).push_back(player);
+
+        // a lobby that agrees on one version still gets a single broadcast
+        if (notHandling.empty()) {
+            Send(type, payload, nullptr);
+        } else if (handling.empty()) {
+            Send(fallbackType, fallbackPayload, nullptr);
+        } else {
+            for (auto player : handling) Send(type, payload, player);
+            for (auto player : notHandling) Send(fallbackType, fallbackPayload, player);
+        }
+    }
+
+    void VirtualPeer::SendPacketRegistry(VirtualPeer* target) {
+        SendPacket(PacketType::PacketRegistry, Packets::PacketRegistryPacket{ packetRegistry.get_names() }, target);
+    }
+
+    void VirtualPeer::UpdateCompactPacketIdLimit() {
+        packetRegistry.UpdateLimit(transport.ConnectedPlayers(this));
+    }
+
+    void VirtualPeer::SelectBeatmap(const Samples::Beatmap& beatmap) {
+        // new selection, new packets, the payload cache of the old ones is of no use anymore
+        ByteWriter writer(512);
+        Samples::WriteBeatmapPacket(&writer, beatmap);
+        auto written = writer.written();
+        localBeatmapPayload.assign(written.begin(), written.end());
+
+        writer.Reset();
+        Samples::WriteCompactBeatmapPacket(&writer, beatmap);
+        written = writer.written();
+        localCompactBeatmapPayload.assign(written.begin(), written.end());
+
+        ResendSelectedBeatmap();
+    }
+
+    void VirtualPeer::ResendSelectedBeatmap() {
+        if (!HasSelectedBeatmap()) return;
+        if (role == Role::LegacyPlayer) Send(PacketType::Beatmap, localBeatmapPayload, nullptr);
+        else SendWithFallback(PacketType::CompactBeatmap, localCompactBeatmapPayload, PacketType::Beatmap, localBeatmapPayload);
+    }
+
+    void VirtualPeer::SendNodePoseSyncState(int64_t deltaUpdateFrequencyMs, int64_t fullStateUpdateFrequencyMs) {
+        SendPacket(PacketType::NodePoseSyncState, Packets::NodePoseSyncStatePacket{ deltaUpdateFrequencyMs, fullStateUpdateFrequencyMs }, nullptr);
+    }
+
+    const Samples::Beatmap* VirtualPeer::SelectedBeatmapOf(const VirtualPeer* player) const {
+        auto selected = selectedBeatmaps.find(player);
+        return selected != selectedBeatmaps.end() ? &selected->second : nullptr;
+    }
+
+    void VirtualPeer::HandlePacketRegistry(Packets::PacketRegistryPacket& packet, VirtualPeer* player) {
+        SendPacket(PacketType::PacketRegistryAck, Packets::PacketRegistryAckPacket{ uint32_t(packet.packetNames.size()) }, player);
+        packetRegistry.SetIncoming(player, std::move(packet.packetNames));
+    }
+
+    void VirtualPeer::HandlePacketRegistryAck(Packets::PacketRegistryAckPacket& packet, VirtualPeer* player) {
+        packetRegistry.Acknowledge(player, packet.packetCount);
+        UpdateCompactPacketIdLimit();
+    }
+
+    void VirtualPeer::HandlePlayerData(Packets::PlayerData& packet, VirtualPeer* player) {
+        playerData[player] = std::move(packet);
+    }
+
+    void VirtualPeer::HandleBeatmapPacket(Samples::Beatmap& packet, VirtualPeer* player) {
+        selectedBeatmaps[player] = std::move(packet);
+    }
+
+    void VirtualPeer::HandleNodePoseSyncState(Packets::NodePoseSyncStatePacket& packet, VirtualPeer* player) {
+        if (player->get_isConnectionOwner()) {
+            deltaUpdateFrequencyMs = packet.deltaUpdateFrequencyMs;
+            fullStateUpdateFrequencyMs = packet.fullStateUpdateFrequencyMs;
+        }
+    }
+}
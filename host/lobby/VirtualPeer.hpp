@@ -0,0 +1,205 @@
+#pragma once
+
+#include "ByteBuffer.hpp"
+#include "HostPackets.hpp"
+#include "SampleData.hpp"
+#include "Networking/ChunkReassembler.hpp"
+#include "Networking/DecodeBudget.hpp"
+#include "Networking/PacketCapture.hpp"
+#include "Networking/PacketDispatch.hpp"
+#include "Networking/PacketHandlerTable.hpp"
+#include "Networking/PacketMetrics.hpp"
+#include "Networking/PacketRegistry.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace MultiplayerCore::Host::Lobby {
+    /// @brief the packet types MpCore registers, in the order a client registers them
+    enum class PacketType : uint8_t {
+        PacketRegistry,
+        PacketRegistryAck,
+        PacketBatch,
+        PacketChunk,
+        PlayerData,
+        Beatmap,
+        CompactBeatmap,
+        NodePoseSyncState,
+        Count
+    };
+
+    inline constexpr std::array<std::string_view, static_cast<std::size_t>(PacketType::Count)> PacketNames = {
+        "MpPacketRegistryPacket",
+        "MpPacketRegistryAckPacket",
+        "MpPacketBatch",
+        "MpPacketChunk",
+        "MpPlayerData",
+        "MpBeatmapPacket",
+        "MpCompactBeatmapPacket",
+        "MpNodePoseSyncStatePacket"
+    };
+
+    inline constexpr std::string_view NameOf(PacketType type) { return PacketNames[static_cast<std::size_t>(type)]; }
+
+    class VirtualPeer;
+
+    /// @brief what a peer hands its frames to, stands in for the game's MultiplayerSessionManager
+    class Transport {
+        public:
+            virtual ~Transport() = default;
+            /// @brief send a framed packet, target nullptr is the whole lobby
+            /// @param serializeNanos time the sender spent framing it, part of the message latency
+            virtual void Send(VirtualPeer* sender, VirtualPeer* target, std::vector<uint8_t> frame, uint64_t serializeNanos) = 0;
+            /// @brief players sender is connected to, in connection order
+            virtual std::span<VirtualPeer* const> ConnectedPlayers(const VirtualPeer* sender) const = 0;
+    };
+
+    /// @brief how often the handler of a packet type ran and the time spent in it
+    struct HandlerStats {
+        uint64_t count = 0;
+        uint64_t nanos = 0;
+    };
+
+    /// @brief one virtual lobby member, doing the packet side of what MpPacketSerializer, MpPlayerManager,
+    /// MpPlayersDataModel and MpNodePoseSyncStateManager do in game. Receiving runs the serializer's own PacketDispatch
+    /// and the packets' own decoders, registration, framing and compact id negotiation use the same PacketRegistry and
+    /// PacketFraming, only the game types are swapped for the host stand-ins
+    class VirtualPeer {
+        public:
+            enum class Role {
+                /// @brief a player running this version of MpCore
+                Player,
+                /// @brief a player on an MpCore version from before the packet registry and the compact beatmap packet
+                LegacyPlayer,
+                /// @brief the dedicated server, connection owner that relays everything and sets the pose sync rates
+                Server
+            };
+
+            VirtualPeer(uint32_t index, Role role, Transport& transport);
+
+            /// @brief register handlers, like the Initialize of the serializer and the managers
+            void Initialize();
+
+            void HandlePlayerConnected(VirtualPeer* player);
+            void HandlePlayerDisconnected(VirtualPeer* player);
+
+            /// @brief Deserialize of the serializer, dispatches one frame received from sender
+            /// @param now simulated time, what the decode budgets are measured in
+            /// @return time spent handling it in nanoseconds
+            uint64_t Receive(VirtualPeer* sender, std::span<const uint8_t> frame, std::chrono::steady_clock::time_point now);
+            /// @brief dispatches a payload whose frame header was already read, the way a packet capture stores them
+            uint64_t ReceivePayload(VirtualPeer* sender, std::string_view packetName, uint8_t frameFlags, std::span<const uint8_t> payload, std::chrono::steady_clock::time_point now);
+
+            /// @brief SetLocalPlayerBeatmapLevel, selects a beatmap and sends it to the lobby
+            void SelectBeatmap(const Samples::Beatmap& beatmap);
+            /// @brief what the game does when another player asks for our recommended beatmap
+            void ResendSelectedBeatmap();
+            bool HasSelectedBeatmap() const { return !localBeatmapPayload.empty(); }
+
+            /// @brief connection owner only, broadcast new pose sync rates
+            void SendNodePoseSyncState(int64_t deltaUpdateFrequencyMs, int64_t fullStateUpdateFrequencyMs);
+
+            uint32_t get_index() const { return index; }
+            Role get_role() const { return role; }
+            const std::string& get_userId() const { return userId; }
+            bool get_isConnectionOwner() const { return role == Role::Server; }
+
+            int64_t get_deltaUpdateFrequencyMs() const { return deltaUpdateFrequencyMs; }
+            int64_t get_fullStateUpdateFrequencyMs() const { return fullStateUpdateFrequencyMs; }
+
+            /// @brief record every packet received into capture, the capture mode of the serializer
+            void set_capture(Networking::PacketCaptureWriter* value) { capture = value; }
+
+            const Networking::PacketMetrics& get_metrics() const { return *metrics; }
+            const HandlerStats& get_handlerStats(PacketType type) const { return handlerStats[static_cast<std::size_t>(type)]; }
+            uint64_t get_errorCount() const { return errorCount; }
+
+            /// @brief what we know about other players, what MpPlayerManager and MpPlayersDataModel keep
+            std::size_t KnownPlayerCount() const { return playerData.size(); }
+            const Samples::Beatmap* SelectedBeatmapOf(const VirtualPeer* player) const;
+
+        private:
+            using PacketHandler = std::function<void(ByteReader*, int, VirtualPeer*)>;
+
+            template<typename TPacket>
+            void RegisterCallback(PacketType type, void (*deserialize)(ByteReader*, TPacket&), void (VirtualPeer::*handler)(TPacket&, VirtualPeer*));
+            void RegisterHandler(PacketType type, PacketHandler handler);
+            void RegisterPacketId(PacketType type);
+
+            // what PacketDispatch needs of the serializer it runs in
+            friend struct Networking::PacketDispatch;
+            std::chrono::steady_clock::time_point Now() const { return receivedAt; }
+            Networking::SenderMetrics* GetSenderMetrics(VirtualPeer* player) { return metrics->ForSender(player->userId); }
+            bool get_capturing() const { return capture != nullptr; }
+            void CapturePacket(Networking::CapturedPacket::Direction direction, VirtualPeer* peer, std::string_view packetName, uint8_t frameFlags, std::span<const uint8_t> payload);
+            template<typename TFunc>
+            void WithBuffer(std::size_t length, TFunc&& fn) {
+                std::vector<uint8_t> buffer(length);
+                ByteReader reader(buffer);
+                fn(std::span<uint8_t>(buffer), &reader);
+            }
+            void OnPacketError(VirtualPeer*, std::string_view, const std::exception&) { errorCount++; }
+            // no channels in the sim, every packet counts against the sender limit
+            bool HasOwnSenderBudget(Networking::PacketKey) const { return false; }
+
+            /// @brief frames an already serialized payload for target, nullptr for the whole lobby
+            std::vector<uint8_t> Frame(PacketType type, std::span<const uint8_t> payload, VirtualPeer* target);
+            void Send(PacketType type, std::span<const uint8_t> payload, VirtualPeer* target);
+            template<typename TPacket>
+            void SendPacket(PacketType type, const TPacket& packet, VirtualPeer* target) {
+                ByteWriter writer;
+                packet.Serialize(&writer);
+                Send(type, writer.written(), target);
+            }
+            /// @brief compact packet to the players that handle it, legacy packet to everyone else
+            void SendWithFallback(PacketType type, std::span<const uint8_t> payload, PacketType fallbackType, std::span<const uint8_t> fallbackPayload);
+
+            void SendPacketRegistry(VirtualPeer* target);
+            void UpdateCompactPacketIdLimit();
+
+            void HandlePacketRegistry(Packets::PacketRegistryPacket& packet, VirtualPeer* player);
+            void HandlePacketRegistryAck(Packets::PacketRegistryAckPacket& packet, VirtualPeer* player);
+            void HandlePlayerData(Packets::PlayerData& packet, VirtualPeer* player);
+            void HandleBeatmapPacket(Samples::Beatmap& packet, VirtualPeer* player);
+            void HandleNodePoseSyncState(Packets::NodePoseSyncStatePacket& packet, VirtualPeer* player);
+
+            uint32_t index;
+            Role role;
+            std::string userId;
+            Transport& transport;
+
+            Networking::PacketHandlerTable<PacketHandler> packetHandlers;
+            Networking::PacketRegistry<PacketType, VirtualPeer*> packetRegistry;
+            Networking::DecodeBudget<VirtualPeer*> decodeBudget;
+            Networking::ChunkReassembler<VirtualPeer*> incomingTransfers;
+            Networking::PacketCaptureWriter* capture = nullptr;
+            std::unordered_set<PacketType> compressedTypes;
+            std::unique_ptr<Networking::PacketMetrics> metrics = std::make_unique<Networking::PacketMetrics>();
+            std::array<HandlerStats, static_cast<std::size_t>(PacketType::Count)> handlerStats{};
+            uint64_t errorCount = 0;
+            // simulated time of the message being received, and how long its handlers ran
+            std::chrono::steady_clock::time_point receivedAt;
+            uint64_t handledNanos = 0;
+            ByteWriter frameWriter{1024};
+
+            // the payload caches of the serializer, our packets get serialized once and sent many times
+            std::vector<uint8_t> localPlayerDataPayload;
+            std::vector<uint8_t> localBeatmapPayload;
+            std::vector<uint8_t> localCompactBeatmapPayload;
+
+            std::unordered_map<const VirtualPeer*, Packets::PlayerData> playerData;
+            std::unordered_map<const VirtualPeer*, Samples::Beatmap> selectedBeatmaps;
+            int64_t deltaUpdateFrequencyMs = 10;
+            int64_t fullStateUpdateFrequencyMs = 100;
+    };
+}
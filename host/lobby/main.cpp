@@ -0,0 +1,84 @@
+// Headless lobby load test, runs scripted lobbies of virtual MpCore peers and reports bandwidth, handler cpu and latency:
+//   mpcore-lobby-sim [--scenario <name>|all] [--players 50,126] [--seconds 30] [--seed 1] [--json <path>] [--capture <path>] [--list]
+// --capture records what the first player receives for mpcore-replay, for a run of a single scenario and player count
+#include "Scenarios.hpp"
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace MultiplayerCore::Host::Lobby;
+
+static int Usage(const char* program) {
+    std::cerr << "usage: " << program << " [--scenario <name>|all] [--players 50,126] [--seconds 30] [--seed 1] [--json <path>] [--capture <path>] [--list]\n";
+    return 2;
+}
+
+int main(int argc, char** argv) {
+    std::string_view scenarioName = "all";
+    std::vector<std::size_t> playerCounts = { 50, 126 };
+    int seconds = 30;
+    uint32_t seed = 1;
+    std::string jsonPath;
+    std::string capturePath;
+
+    for (int i = 1; i < argc; i++) {
+        std::string_view arg = argv[i];
+        auto value = [&]() -> const char* { return i + 1 < argc ? argv[++i] : nullptr; };
+        if (arg == "--list") {
+            for (auto& scenario : Scenarios()) std::cout << scenario.name << ": " << scenario.description << '\n';
+            return 0;
+        }
+
+        auto next = value();
+        if (!next) return Usage(argv[0]);
+        if (arg == "--scenario") scenarioName = next;
+        else if (arg == "--seconds") seconds = std::atoi(next);
+        else if (arg == "--seed") seed = std::strtoul(next, nullptr, 10);
+        else if (arg == "--json") jsonPath = next;
+        else if (arg == "--capture") capturePath = next;
+        else if (arg == "--players") {
+            playerCounts.clear();
+            std::stringstream list(next);
+            for (std::string count; std::getline(list, count, ',');) playerCounts.push_back(std::strtoul(count.c_str(), nullptr, 10));
+        } else return Usage(argv[0]);
+    }
+
+    if (!capturePath.empty() && (scenarioName == "all" || playerCounts.size() != 1)) {
+        std::cerr << "--capture needs a single --scenario and a single --players count\n";
+        return 2;
+    }
+
+    std::ofstream json;
+    if (!jsonPath.empty()) json.open(jsonPath, std::ios::app);
+
+    bool ran = false;
+    for (auto& scenario : Scenarios()) {
+        if (scenarioName != "all" && scenarioName != scenario.name) continue;
+        for (auto players : playerCounts) {
+            LobbySimulation lobby(seed);
+            if (!capturePath.empty() && !lobby.CaptureFirstPlayer(capturePath)) {
+                std::cerr << "could not open " << capturePath << '\n';
+                return 1;
+            }
+            scenario.script(lobby, players);
+            lobby.Run(std::chrono::seconds(seconds));
+
+            auto report = lobby.Report(std::string(scenario.name), players);
+            report.Write(std::cout);
+            std::cout << std::endl;
+            if (json.is_open()) report.WriteJson(json);
+            ran = true;
+        }
+    }
+
+    if (!ran) {
+        std::cerr << "unknown scenario '" << scenarioName << "', see --list\n";
+        return 2;
+    }
+    return 0;
+}
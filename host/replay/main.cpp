@@ -0,0 +1,193 @@
+// Feeds a packet capture back through the packet handlers and reports the time spent per packet type, to reproduce lobby hitches
+// and compare handler changes against real traffic:
+//   mpcore-replay <capture> [--speed max|recorded] [--passes 1] [--json <path>]
+// Captures come from MpPacketSerializer::StartCapture in game or from mpcore-lobby-sim --capture. Every packet goes through the serializer's
+// PacketDispatch, decode budgets, decompression and metrics included, and is decoded by the packet's own decoder before the lobby sim's
+// VirtualPeer applies it in place of the game's managers. So a change to the receive path or a decoder shows up in the numbers.
+// Only received packets are replayed, the decode budgets see the recorded times at either speed so they drop the same packets
+#include "VirtualPeer.hpp"
+#include "Networking/PacketCapture.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using namespace MultiplayerCore::Host::Lobby;
+using MultiplayerCore::Networking::CapturedPacket;
+using MultiplayerCore::Networking::PacketCaptureReader;
+using MultiplayerCore::Networking::PacketTypeMetrics;
+
+namespace {
+    /// @brief the replaying peer is not connected to anyone, whatever its handlers send goes nowhere
+    class NullTransport : public Transport {
+        public:
+            void Send(VirtualPeer*, VirtualPeer*, std::vector<uint8_t>, uint64_t) override {}
+            std::span<VirtualPeer* const> ConnectedPlayers(const VirtualPeer*) const override { return {}; }
+    };
+
+    struct ReplayedPacket {
+        std::chrono::microseconds time;
+        std::size_t sender;
+        std::string packetName;
+        uint8_t frameFlags;
+        std::vector<uint8_t> payload;
+    };
+
+    struct TypeReport {
+        uint64_t count = 0;
+        uint64_t bytes = 0;
+        uint64_t dropped = 0;
+        uint64_t nanos = 0;
+        uint64_t maxNanos = 0;
+        /// @brief capture time of the slowest packet, where to look for the hitch
+        std::chrono::microseconds maxAt{0};
+    };
+
+    int Usage(const char* program) {
+        std::cerr << "usage: " << program << " <capture> [--speed max|recorded] [--passes 1] [--json <path>]\n";
+        return 2;
+    }
+}
+
+int main(int argc, char** argv) {
+    std::string capturePath;
+    bool recordedSpeed = false;
+    int passes = 1;
+    std::string jsonPath;
+
+    for (int i = 1; i < argc; i++) {
+        std::string_view arg = argv[i];
+        if (!arg.starts_with("--")) {
+            capturePath = arg;
+            continue;
+        }
+
+        if (i + 1 >= argc) return Usage(argv[0]);
+        std::string_view next = argv[++i];
+        if (arg == "--speed" && (next == "max" || next == "recorded")) recordedSpeed = next == "recorded";
+        else if (arg == "--passes") passes = std::max(1, std::atoi(next.data()));
+        else if (arg == "--json") jsonPath = next;
+        else return Usage(argv[0]);
+    }
+    if (capturePath.empty()) return Usage(argv[0]);
+
+    // read it all up front, so the replay measures handlers and not the disk
+    std::ifstream in(capturePath, std::ios::binary);
+    if (!in) {
+        std::cerr << "could not open " << capturePath << '\n';
+        return 1;
+    }
+
+    std::vector<ReplayedPacket> packets;
+    std::vector<std::string> senders;
+    uint64_t outbound = 0;
+    try {
+        PacketCaptureReader reader(in);
+        std::unordered_map<std::string_view, std::size_t> senderIndices;
+        CapturedPacket packet;
+        try {
+            while (reader.Next(packet)) {
+                if (packet.direction == CapturedPacket::Direction::Outbound) {
+                    outbound++;
+                    continue;
+                }
+                auto sender = senderIndices.try_emplace(packet.peer, senders.size());
+                if (sender.second) senders.emplace_back(packet.peer);
+                packets.push_back({ packet.time, sender.first->second, std::string(packet.packetName), packet.frameFlags, std::move(packet.payload) });
+            }
+        } catch (const std::exception& e) {
+            // what the game wrote before it died is still worth replaying
+            std::cerr << "capture is cut off after " << packets.size() << " received packets: " << e.what() << '\n';
+        }
+    } catch (const std::exception& e) {
+        std::cerr << capturePath << ": " << e.what() << '\n';
+        return 1;
+    }
+
+    NullTransport transport;
+    std::map<std::string, TypeReport> types;
+    uint64_t lagMaxNanos = 0;
+    // packets that failed to decode or whose handler threw
+    uint64_t errors = 0;
+    auto replayStart = std::chrono::steady_clock::now();
+
+    for (int pass = 0; pass < passes; pass++) {
+        // a fresh receiver every pass, so each one starts from the same state the capture did
+        VirtualPeer receiver(0, VirtualPeer::Role::Player, transport);
+        receiver.Initialize();
+        std::vector<std::unique_ptr<VirtualPeer>> senderPeers;
+        for (std::size_t i = 0; i < senders.size(); i++) senderPeers.push_back(std::make_unique<VirtualPeer>(i + 1, VirtualPeer::Role::Player, transport));
+
+        auto passStart = std::chrono::steady_clock::now();
+        for (auto& packet : packets) {
+            if (recordedSpeed) {
+                auto due = passStart + packet.time;
+                std::this_thread::sleep_until(due);
+                lagMaxNanos = std::max<uint64_t>(lagMaxNanos, std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - due).count());
+            }
+
+            auto start = std::chrono::steady_clock::now();
+            receiver.ReceivePayload(senderPeers[packet.sender].get(), packet.packetName, packet.frameFlags, packet.payload, std::chrono::steady_clock::time_point(packet.time));
+            uint64_t nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+            auto& type = types[packet.packetName];
+            type.count++;
+            type.bytes += packet.payload.size();
+            type.nanos += nanos;
+            if (nanos > type.maxNanos) {
+                type.maxNanos = nanos;
+                type.maxAt = packet.time;
+            }
+        }
+
+        receiver.get_metrics().ForEachPacket([&types](std::string_view name, const PacketTypeMetrics& metrics) {
+            auto type = types.find(std::string(name));
+            if (type != types.end()) type->second.dropped += metrics.droppedCount.load(std::memory_order_relaxed);
+        });
+        errors += receiver.get_errorCount();
+    }
+    double wallMillis = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - replayStart).count();
+    double captureSeconds = packets.empty() ? 0 : std::chrono::duration<double>(packets.back().time).count();
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << capturePath << ": " << packets.size() << " received packets from " << senders.size() << " senders over " << captureSeconds << " s, "
+              << outbound << " sent packets not replayed\n";
+    std::cout << "  " << passes << (passes == 1 ? " pass" : " passes") << " at " << (recordedSpeed ? "recorded" : "max") << " speed in " << wallMillis << " ms";
+    if (recordedSpeed) std::cout << ", at most " << lagMaxNanos / 1000.0 << " us behind the recording";
+    std::cout << ", " << errors << " errors\n";
+
+    std::cout << "  " << std::left << std::setw(28) << "packet" << std::right
+              << std::setw(10) << "count" << std::setw(12) << "kB" << std::setw(10) << "dropped"
+              << std::setw(12) << "total ms" << std::setw(10) << "ns/call" << std::setw(10) << "max us" << std::setw(12) << "max at s" << '\n';
+    for (auto& [name, type] : types) {
+        std::cout << "  " << std::left << std::setw(28) << name << std::right
+                  << std::setw(10) << type.count << std::setw(12) << type.bytes / 1000.0 << std::setw(10) << type.dropped
+                  << std::setw(12) << type.nanos / 1e6 << std::setw(10) << (type.count ? type.nanos / type.count : 0)
+                  << std::setw(10) << type.maxNanos / 1000.0 << std::setw(12) << std::chrono::duration<double>(type.maxAt).count() << '\n';
+    }
+
+    if (!jsonPath.empty()) {
+        std::ofstream json(jsonPath, std::ios::app);
+        json << "{\"capture\":\"" << capturePath << "\",\"speed\":\"" << (recordedSpeed ? "recorded" : "max") << "\",\"passes\":" << passes
+             << ",\"packets\":" << packets.size() << ",\"wallMillis\":" << wallMillis << ",\"lagMaxNanos\":" << lagMaxNanos << ",\"errors\":" << errors << ",\"packetTypes\":{";
+        bool first = true;
+        for (auto& [name, type] : types) {
+            if (!first) json << ',';
+            first = false;
+            json << '"' << name << "\":{\"count\":" << type.count << ",\"bytes\":" << type.bytes << ",\"dropped\":" << type.dropped
+                 << ",\"nanos\":" << type.nanos << ",\"maxNanos\":" << type.maxNanos << ",\"maxAtMicros\":" << type.maxAt.count() << '}';
+        }
+        json << "}}\n";
+    }
+    return 0;
+}
@@ -0,0 +1,100 @@
+#include "Beatmaps/Providers/BeatSaverResponse.hpp"
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace MultiplayerCore::Beatmaps::Providers;
+
+namespace {
+    const std::string FoundHash = "b5a0cc4f0b24ab3b2fb7cd4e5bcc1d9c7fa25ba3";
+    const std::string OtherFoundHash = "0f1a9a4b1b2c3d4e5f60718293a4b5c6d7e8f901";
+    const std::string UnknownHash = "ffffffffffffffffffffffffffffffffffffffff";
+
+    // answers of api.beatsaver.com/maps/hash/, trimmed to the fields MpCore reads
+    const std::string SingleMap = R"({
+        "id": "1a2b3",
+        "name": "Some Song",
+        "uploader": { "id": 4284, "name": "Some Mapper" },
+        "metadata": { "bpm": 174.0, "duration": 212, "songName": "Some Song", "songSubName": "", "songAuthorName": "Some Artist", "levelAuthorName": "Some Mapper" },
+        "versions": [ { "hash": "b5a0cc4f0b24ab3b2fb7cd4e5bcc1d9c7fa25ba3", "state": "Published", "diffs": [ { "characteristic": "Standard", "difficulty": "Expert", "chroma": false, "me": false, "ne": true } ] } ]
+    })";
+
+    const std::string SeveralMaps = R"({
+        "B5A0CC4F0B24AB3B2FB7CD4E5BCC1D9C7FA25BA3": { "id": "1a2b3", "name": "Some Song", "versions": [] },
+        "0f1a9a4b1b2c3d4e5f60718293a4b5c6d7e8f901": { "id": "4c5d6", "name": "Other Song", "versions": [] },
+        "ffffffffffffffffffffffffffffffffffffffff": null
+    })";
+
+    const std::string NotFound = R"({ "error": "Not Found" })";
+
+    struct Lookup {
+        // map id by hash
+        std::map<std::string, std::string> maps;
+        std::vector<std::string> missing;
+    };
+
+    Lookup Read(const std::vector<std::string>& hashes, long status, const std::string& body) {
+        Lookup lookup;
+        BeatSaverResponse::ReadHashLookup(hashes, status, body,
+            [&lookup](const std::string& hash, const rapidjson::Value& map){
+                auto id = map.FindMember("id");
+                lookup.maps[hash] = id != map.MemberEnd() && id->value.IsString() ? id->value.GetString() : "";
+            },
+            [&lookup](const std::string& hash){ lookup.missing.push_back(hash); }
+        );
+        return lookup;
+    }
+
+    std::string Upper(std::string hash) {
+        for (auto& c : hash) if (c >= 'a' && c <= 'z') c = c - 'a' + 'A';
+        return hash;
+    }
+}
+
+TEST(BeatSaverResponse, OneHashIsAnsweredWithTheMapItself) {
+    auto lookup = Read({ Upper(FoundHash) }, BeatSaverResponse::HttpOk, SingleMap);
+    EXPECT_EQ(lookup.maps, (std::map<std::string, std::string>{ { FoundHash, "1a2b3" } }));
+    EXPECT_TRUE(lookup.missing.empty());
+}
+
+TEST(BeatSaverResponse, OneUnknownHashIsA404) {
+    auto lookup = Read({ Upper(UnknownHash) }, BeatSaverResponse::HttpNotFound, NotFound);
+    EXPECT_TRUE(lookup.maps.empty());
+    EXPECT_EQ(lookup.missing, std::vector<std::string>{ UnknownHash });
+}
+
+TEST(BeatSaverResponse, SeveralHashesAreAnsweredByHash) {
+    auto lookup = Read({ FoundHash, Upper(OtherFoundHash), UnknownHash }, BeatSaverResponse::HttpOk, SeveralMaps);
+    EXPECT_EQ(lookup.maps, (std::map<std::string, std::string>{ { FoundHash, "1a2b3" }, { OtherFoundHash, "4c5d6" } }));
+    EXPECT_EQ(lookup.missing, std::vector<std::string>{ UnknownHash });
+}
+
+TEST(BeatSaverResponse, HashesLeftOutOfTheAnswerAreNeitherFoundNorMissing) {
+    auto asked = "1111111111111111111111111111111111111111";
+    auto lookup = Read({ FoundHash, asked }, BeatSaverResponse::HttpOk, SeveralMaps);
+    // only what was asked for, the others in the answer are skipped
+    EXPECT_EQ(lookup.maps, (std::map<std::string, std::string>{ { FoundHash, "1a2b3" } }));
+    EXPECT_TRUE(lookup.missing.empty());
+}
+
+TEST(BeatSaverResponse, ErrorAnswersThrow) {
+    std::vector<std::string> several = { FoundHash, UnknownHash };
+    // several unknown hashes aren't a 404, so that is BeatSaver not answering
+    EXPECT_THROW(Read(several, BeatSaverResponse::HttpNotFound, NotFound), std::runtime_error);
+    EXPECT_THROW(Read(several, BeatSaverResponse::HttpOk, NotFound), std::runtime_error);
+    EXPECT_THROW(Read({ FoundHash }, BeatSaverResponse::HttpOk, NotFound), std::runtime_error);
+    EXPECT_THROW(Read({ FoundHash }, 500, "<html><body>Internal Server Error</body></html>"), std::runtime_error);
+    EXPECT_THROW(Read({ FoundHash }, 429, R"({ "error": "Too Many Requests" })"), std::runtime_error);
+    // timed out, nothing came back
+    EXPECT_THROW(Read({ FoundHash }, 0, ""), std::runtime_error);
+}
+
+TEST(BeatSaverResponse, BodiesThatArentAnObjectThrow) {
+    EXPECT_THROW(Read({ FoundHash }, BeatSaverResponse::HttpOk, "null"), std::runtime_error);
+    EXPECT_THROW(Read({ FoundHash }, BeatSaverResponse::HttpOk, "[]"), std::runtime_error);
+    EXPECT_THROW(Read({ FoundHash, UnknownHash }, BeatSaverResponse::HttpOk, SeveralMaps.substr(0, SeveralMaps.size() / 2)), std::runtime_error);
+}
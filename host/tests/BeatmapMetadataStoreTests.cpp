@@ -0,0 +1,232 @@
+#include "Beatmaps/BeatmapMetadataStore.hpp"
+#include "TestFiles.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+using namespace MultiplayerCore::Beatmaps;
+using namespace MultiplayerCore::Tests;
+
+namespace {
+    // records are stored with whole seconds, compaction drops entries that expired by the real clock
+    const auto Now = std::chrono::floor<std::chrono::seconds>(std::chrono::system_clock::now());
+
+    std::string HashOf(char c) { return std::string(40, c); }
+
+    BeatmapMetadata Found(std::string hash) {
+        BeatmapMetadata metadata;
+        metadata.hash = std::move(hash);
+        metadata.found = true;
+        metadata.key = "3a9f";
+        metadata.coverUrl = "https://cdn.beatsaver.com/3a9f.jpg";
+        metadata.songName = "Song";
+        metadata.songSubName = "(Extended Mix)";
+        metadata.songAuthorName = "Some Artist";
+        metadata.levelAuthorName = "Some Mapper";
+        metadata.bpm = 174;
+        metadata.duration = 212.5f;
+        metadata.versions.push_back({ metadata.hash, { { BeatmapMetadata::Difficulty::Chroma }, { BeatmapMetadata::Difficulty::NoodleExtensions } } });
+        metadata.fetched = Now;
+        return metadata;
+    }
+
+    BeatmapMetadata Missing(std::string hash) {
+        BeatmapMetadata metadata;
+        metadata.hash = std::move(hash);
+        metadata.fetched = Now;
+        return metadata;
+    }
+
+    std::size_t RecordBytesOf(const BeatmapMetadata& metadata) {
+        std::vector<uint8_t> record;
+        BeatmapMetadataStore::Encode(metadata, record);
+        return RecordBytes(record.size());
+    }
+}
+
+TEST(BeatmapMetadataStore, KeepsEntriesAcrossSessions) {
+    TempFile file;
+    {
+        BeatmapMetadataStore store(file.path);
+        store.Store(Found(HashOf('A')));
+        store.Store(Missing(HashOf('b')));
+    }
+
+    BeatmapMetadataStore store(file.path);
+    auto found = store.Find(HashOf('a'), Now);
+    ASSERT_TRUE(found.has_value());
+    EXPECT_TRUE(found->found);
+    EXPECT_EQ(found->hash, HashOf('a'));
+    EXPECT_EQ(found->coverUrl, "https://cdn.beatsaver.com/3a9f.jpg");
+    EXPECT_EQ(found->songName, "Song");
+    EXPECT_EQ(found->bpm, 174);
+    ASSERT_EQ(found->versions.size(), 1u);
+    ASSERT_EQ(found->versions[0].diffs.size(), 2u);
+    EXPECT_TRUE(found->versions[0].diffs[0].GetChroma());
+    EXPECT_TRUE(found->versions[0].diffs[1].GetNE());
+    EXPECT_EQ(found->fetched, Now);
+
+    auto missing = store.Find(HashOf('B'), Now);
+    ASSERT_TRUE(missing.has_value());
+    EXPECT_FALSE(missing->found);
+    EXPECT_EQ(store.get_stats().entries, 2u);
+}
+
+TEST(BeatmapMetadataStore, LatestRecordWins) {
+    TempFile file;
+    {
+        BeatmapMetadataStore store(file.path);
+        store.Store(Missing(HashOf('a')));
+        store.Store(Found(HashOf('a')));
+    }
+
+    BeatmapMetadataStore store(file.path);
+    auto entry = store.Find(HashOf('a'), Now);
+    ASSERT_TRUE(entry.has_value());
+    EXPECT_TRUE(entry->found);
+}
+
+TEST(BeatmapMetadataStore, EntriesExpireAfterTheirTtl) {
+    TempFile file;
+    BeatmapMetadataStore store(file.path);
+    store.Store(Found(HashOf('a')));
+    store.Store(Missing(HashOf('b')));
+
+    auto afterMissingTtl = Now + BeatmapMetadataStore::DefaultMissingTtl + std::chrono::seconds(1);
+    EXPECT_TRUE(store.Find(HashOf('a'), afterMissingTtl).has_value());
+    EXPECT_FALSE(store.Find(HashOf('b'), afterMissingTtl).has_value());
+
+    auto afterFoundTtl = Now + BeatmapMetadataStore::DefaultFoundTtl + std::chrono::seconds(1);
+    EXPECT_FALSE(store.Find(HashOf('a'), afterFoundTtl).has_value());
+
+    auto stats = store.get_stats();
+    EXPECT_EQ(stats.hits, 1u);
+    EXPECT_EQ(stats.expired, 2u);
+    EXPECT_EQ(stats.misses, 2u);
+}
+
+TEST(BeatmapMetadataStore, SetTtlAppliesToStoredEntries) {
+    TempFile file;
+    BeatmapMetadataStore store(file.path);
+    store.Store(Found(HashOf('a')));
+    store.Store(Missing(HashOf('b')));
+    store.set_ttl(std::chrono::seconds(10), std::chrono::seconds(5));
+
+    EXPECT_TRUE(store.Find(HashOf('a'), Now + std::chrono::seconds(10)).has_value());
+    EXPECT_FALSE(store.Find(HashOf('a'), Now + std::chrono::seconds(11)).has_value());
+    EXPECT_FALSE(store.Find(HashOf('b'), Now + std::chrono::seconds(6)).has_value());
+}
+
+TEST(BeatmapMetadataStore, TornLogKeepsWholeRecordsAndStaysAppendable) {
+    TempFile file;
+    {
+        BeatmapMetadataStore store(file.path);
+        store.Store(Found(HashOf('a')));
+        store.Store(Found(HashOf('b')));
+    }
+    file.Truncate(3);
+    {
+        BeatmapMetadataStore store(file.path);
+        EXPECT_TRUE(store.Find(HashOf('a'), Now).has_value());
+        EXPECT_FALSE(store.Find(HashOf('b'), Now).has_value());
+        // the torn tail is gone, so this doesn't end up behind it where no one reads it
+        store.Store(Found(HashOf('c')));
+    }
+
+    BeatmapMetadataStore store(file.path);
+    EXPECT_TRUE(store.Find(HashOf('a'), Now).has_value());
+    EXPECT_TRUE(store.Find(HashOf('c'), Now).has_value());
+    EXPECT_EQ(store.get_stats().entries, 2u);
+}
+
+TEST(BeatmapMetadataStore, CorruptRecordDropsTheRestOfTheLog) {
+    TempFile file;
+    {
+        BeatmapMetadataStore store(file.path);
+        store.Store(Found(HashOf('a')));
+        store.Store(Found(HashOf('b')));
+        store.Store(Found(HashOf('c')));
+    }
+    // a byte in the middle of the second record
+    file.FlipByte(LogHeaderBytes + RecordBytesOf(Found(HashOf('a'))) + 10);
+
+    BeatmapMetadataStore store(file.path);
+    EXPECT_TRUE(store.Find(HashOf('a'), Now).has_value());
+    EXPECT_FALSE(store.Find(HashOf('b'), Now).has_value());
+    EXPECT_FALSE(store.Find(HashOf('c'), Now).has_value());
+    EXPECT_EQ(file.Size(), LogHeaderBytes + RecordBytesOf(Found(HashOf('a'))));
+}
+
+TEST(BeatmapMetadataStore, GarbageFileStartsOver) {
+    TempFile file;
+    file.Write({ 'n', 'o', 't', ' ', 'a', ' ', 'l', 'o', 'g' });
+
+    BeatmapMetadataStore store(file.path);
+    EXPECT_EQ(store.get_stats().entries, 0u);
+    EXPECT_EQ(file.Size(), LogHeaderBytes);
+}
+
+TEST(BeatmapMetadataStore, EraseLastsAcrossSessions) {
+    TempFile file;
+    {
+        BeatmapMetadataStore store(file.path);
+        store.Store(Found(HashOf('a')));
+        store.Store(Found(HashOf('b')));
+        store.Erase(HashOf('A'));
+        EXPECT_FALSE(store.Find(HashOf('a'), Now).has_value());
+    }
+    {
+        BeatmapMetadataStore store(file.path);
+        EXPECT_FALSE(store.Find(HashOf('a'), Now).has_value());
+        EXPECT_TRUE(store.Find(HashOf('b'), Now).has_value());
+        EXPECT_EQ(store.get_stats().entries, 1u);
+        EXPECT_TRUE(store.Compact(Now));
+        EXPECT_EQ(file.Size(), LogHeaderBytes + RecordBytesOf(Found(HashOf('b'))));
+        // stored again after it was erased
+        store.Store(Missing(HashOf('a')));
+    }
+
+    BeatmapMetadataStore store(file.path);
+    auto entry = store.Find(HashOf('a'), Now);
+    ASSERT_TRUE(entry.has_value());
+    EXPECT_FALSE(entry->found);
+}
+
+TEST(BeatmapMetadataStore, CompactionDropsExpiredEntries) {
+    TempFile file;
+    {
+        BeatmapMetadataStore store(file.path);
+        store.Store(Found(HashOf('a')));
+        store.Store(Missing(HashOf('b')));
+
+        EXPECT_TRUE(store.Compact(Now + BeatmapMetadataStore::DefaultMissingTtl + std::chrono::seconds(1)));
+        EXPECT_EQ(store.get_stats().entries, 1u);
+        EXPECT_EQ(file.Size(), LogHeaderBytes + RecordBytesOf(Found(HashOf('a'))));
+    }
+
+    BeatmapMetadataStore store(file.path);
+    EXPECT_TRUE(store.Find(HashOf('a'), Now).has_value());
+    EXPECT_FALSE(store.Find(HashOf('b'), Now).has_value());
+}
+
+TEST(BeatmapMetadataStore, CompactsALogOfReplacedRecords) {
+    TempFile file;
+    auto recordBytes = RecordBytesOf(Found(HashOf('a')));
+    {
+        BeatmapMetadataStore store(file.path);
+        for (int i = 0; i < 1000; i++) store.Store(Found(HashOf('a')));
+        // rewritten whenever it held a few hundred records of the one entry
+        EXPECT_LT(file.Size(), LogHeaderBytes + 300 * recordBytes);
+        EXPECT_EQ(store.get_stats().logBytes, file.Size());
+
+        EXPECT_TRUE(store.Compact());
+        EXPECT_EQ(file.Size(), LogHeaderBytes + recordBytes);
+    }
+
+    BeatmapMetadataStore store(file.path);
+    EXPECT_TRUE(store.Find(HashOf('a'), Now).has_value());
+    EXPECT_EQ(store.get_stats().entries, 1u);
+}
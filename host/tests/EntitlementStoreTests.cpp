@@ -0,0 +1,182 @@
+#include "Objects/EntitlementStore.hpp"
+#include "TestFiles.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <string>
+
+using namespace MultiplayerCore::Objects;
+using namespace MultiplayerCore::Tests;
+using Status = EntitlementDecision::Status;
+
+namespace {
+    constexpr uint64_t ModSet = 0x1234;
+    constexpr uint64_t OtherModSet = 0x5678;
+    constexpr int64_t FolderTime = 1'700'000'000;
+    // verdicts for levels that aren't installed
+    constexpr int64_t Remote = 0;
+
+    std::string HashOf(char c) { return std::string(40, c); }
+}
+
+TEST(EntitlementStore, KeepsVerdictsAcrossSessions) {
+    TempFile file;
+    {
+        EntitlementStore store(file.path, ModSet);
+        store.Store(HashOf('A'), Status::Ok, FolderTime);
+        store.Store(HashOf('b'), Status::NotOwned, Remote);
+    }
+
+    EntitlementStore store(file.path, ModSet);
+    EXPECT_EQ(store.Find(HashOf('a'), FolderTime), Status::Ok);
+    EXPECT_EQ(store.Find(HashOf('B'), Remote), Status::NotOwned);
+    EXPECT_EQ(store.get_stats().entries, 2u);
+}
+
+TEST(EntitlementStore, UnknownIsNotStored) {
+    TempFile file;
+    EntitlementStore store(file.path, ModSet);
+    store.Store(HashOf('a'), Status::Unknown, FolderTime);
+    EXPECT_FALSE(store.Find(HashOf('a'), FolderTime).has_value());
+    EXPECT_EQ(store.get_stats().stores, 0u);
+}
+
+TEST(EntitlementStore, TouchedSongFolderInvalidatesTheVerdict) {
+    TempFile file;
+    EntitlementStore store(file.path, ModSet);
+    store.Store(HashOf('a'), Status::Ok, FolderTime);
+
+    EXPECT_FALSE(store.Find(HashOf('a'), FolderTime + 1).has_value());
+    // deleted since
+    EXPECT_FALSE(store.Find(HashOf('a'), Remote).has_value());
+    EXPECT_EQ(store.get_stats().stale, 2u);
+    EXPECT_EQ(store.Find(HashOf('a'), FolderTime), Status::Ok);
+}
+
+TEST(EntitlementStore, InstalledVerdictDoesNotExpire) {
+    TempFile file;
+    EntitlementStore store(file.path, ModSet);
+    store.Store(HashOf('a'), Status::Ok, FolderTime);
+
+    auto muchLater = std::chrono::system_clock::now() + std::chrono::hours(24 * 365);
+    EXPECT_EQ(store.Find(HashOf('a'), FolderTime, muchLater), Status::Ok);
+}
+
+TEST(EntitlementStore, RemoteVerdictExpiresAfterTheTtl) {
+    TempFile file;
+    EntitlementStore store(file.path, ModSet);
+    auto stored = std::chrono::system_clock::now();
+    store.Store(HashOf('a'), Status::NotDownloaded, Remote);
+
+    EXPECT_EQ(store.Find(HashOf('a'), Remote, stored), Status::NotDownloaded);
+    auto afterTtl = stored + EntitlementStore::DefaultRemoteTtl + std::chrono::seconds(1);
+    EXPECT_FALSE(store.Find(HashOf('a'), Remote, afterTtl).has_value());
+
+    store.set_remoteTtl(std::chrono::seconds(10));
+    EXPECT_FALSE(store.Find(HashOf('a'), Remote, stored + std::chrono::seconds(11)).has_value());
+}
+
+TEST(EntitlementStore, StoringARemoteVerdictAgainRenewsIt) {
+    TempFile file;
+    EntitlementStore store(file.path, ModSet);
+    store.set_remoteTtl(std::chrono::seconds(10));
+    store.Store(HashOf('a'), Status::NotDownloaded, Remote);
+    auto renewed = std::chrono::system_clock::now();
+    store.Store(HashOf('a'), Status::NotDownloaded, Remote);
+
+    EXPECT_EQ(store.Find(HashOf('a'), Remote, renewed + std::chrono::seconds(9)), Status::NotDownloaded);
+    EXPECT_EQ(store.get_stats().stores, 2u);
+}
+
+TEST(EntitlementStore, OtherModSetDropsEveryVerdict) {
+    TempFile file;
+    {
+        EntitlementStore store(file.path, ModSet);
+        store.Store(HashOf('a'), Status::Ok, FolderTime);
+    }
+    {
+        EntitlementStore store(file.path, OtherModSet);
+        EXPECT_FALSE(store.Find(HashOf('a'), FolderTime).has_value());
+        EXPECT_EQ(store.get_stats().entries, 0u);
+    }
+    // gone from the log as well, going back to the old mods doesn't bring it back
+    EXPECT_EQ(file.Size(), LogHeaderBytes);
+    EntitlementStore store(file.path, ModSet);
+    EXPECT_FALSE(store.Find(HashOf('a'), FolderTime).has_value());
+}
+
+TEST(EntitlementStore, EraseAndClearLastAcrossSessions) {
+    TempFile file;
+    {
+        EntitlementStore store(file.path, ModSet);
+        store.Store(HashOf('a'), Status::Ok, FolderTime);
+        store.Store(HashOf('b'), Status::Ok, FolderTime);
+        store.Erase(HashOf('A'));
+    }
+    {
+        EntitlementStore store(file.path, ModSet);
+        EXPECT_FALSE(store.Find(HashOf('a'), FolderTime).has_value());
+        EXPECT_EQ(store.Find(HashOf('b'), FolderTime), Status::Ok);
+        store.Clear();
+    }
+
+    EntitlementStore store(file.path, ModSet);
+    EXPECT_EQ(store.get_stats().entries, 0u);
+    EXPECT_EQ(file.Size(), LogHeaderBytes);
+}
+
+TEST(EntitlementStore, TornLogKeepsWholeRecordsAndStaysAppendable) {
+    TempFile file;
+    {
+        EntitlementStore store(file.path, ModSet);
+        store.Store(HashOf('a'), Status::Ok, FolderTime);
+        store.Store(HashOf('b'), Status::Ok, FolderTime);
+    }
+    file.Truncate(3);
+    {
+        EntitlementStore store(file.path, ModSet);
+        EXPECT_EQ(store.Find(HashOf('a'), FolderTime), Status::Ok);
+        EXPECT_FALSE(store.Find(HashOf('b'), FolderTime).has_value());
+        store.Store(HashOf('c'), Status::NotOwned, Remote);
+    }
+
+    EntitlementStore store(file.path, ModSet);
+    EXPECT_EQ(store.Find(HashOf('a'), FolderTime), Status::Ok);
+    EXPECT_EQ(store.Find(HashOf('c'), Remote), Status::NotOwned);
+}
+
+TEST(EntitlementStore, CorruptRecordDropsTheRestOfTheLog) {
+    TempFile file;
+    {
+        EntitlementStore store(file.path, ModSet);
+        store.Store(HashOf('a'), Status::Ok, FolderTime);
+        store.Store(HashOf('b'), Status::Ok, FolderTime);
+    }
+    // the status byte of the second record, the checksum no longer matches
+    auto firstRecord = (file.Size() - LogHeaderBytes) / 2;
+    file.FlipByte(LogHeaderBytes + firstRecord + 1);
+
+    EntitlementStore store(file.path, ModSet);
+    EXPECT_EQ(store.Find(HashOf('a'), FolderTime), Status::Ok);
+    EXPECT_FALSE(store.Find(HashOf('b'), FolderTime).has_value());
+    EXPECT_EQ(file.Size(), LogHeaderBytes + firstRecord);
+}
+
+TEST(EntitlementStore, CompactsALogOfReplacedRecords) {
+    TempFile file;
+    std::size_t recordBytes = 0;
+    {
+        EntitlementStore store(file.path, ModSet);
+        store.Store(HashOf('a'), Status::Ok, FolderTime);
+        recordBytes = file.Size() - LogHeaderBytes;
+        // a folder touched over and over, every verdict replaces the last one
+        for (int i = 1; i < 1000; i++) store.Store(HashOf('a'), Status::Ok, FolderTime + i);
+        EXPECT_LT(file.Size(), LogHeaderBytes + 300 * recordBytes);
+        EXPECT_EQ(store.get_stats().logBytes, file.Size());
+    }
+
+    EntitlementStore store(file.path, ModSet);
+    EXPECT_EQ(store.Find(HashOf('a'), FolderTime + 999), Status::Ok);
+    EXPECT_EQ(store.get_stats().entries, 1u);
+}
@@ -0,0 +1,152 @@
+#include "Utils/RecordLog.hpp"
+#include "TestFiles.hpp"
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <vector>
+
+using namespace MultiplayerCore::Utils;
+using namespace MultiplayerCore::Tests;
+
+namespace {
+    constexpr RecordLog::Magic TestMagic = { 'T', 'E', 'S', 'T' };
+    constexpr uint8_t TestVersion = 1;
+
+    using Records = std::vector<std::vector<uint8_t>>;
+
+    Records ReadAll(RecordLog& log, bool* appendable = nullptr) {
+        Records records;
+        bool opened = log.Open([&records](std::span<const uint8_t> payload){ records.emplace_back(payload.begin(), payload.end()); });
+        if (appendable) *appendable = opened;
+        return records;
+    }
+
+    /// @brief a fresh log at path holding records
+    void WriteLog(const TempFile& file, const Records& records) {
+        RecordLog log(file.path, TestMagic, TestVersion);
+        ASSERT_TRUE(log.Rewrite([&log, &records](){
+            for (auto& record : records) log.Append(record);
+        }));
+    }
+
+    const Records ThreeRecords = { { 1, 2, 3 }, { 4, 5, 6 }, { 7, 8, 9 } };
+}
+
+TEST(RecordLog, MissingLogHasToBeRewritten) {
+    TempFile file;
+    RecordLog log(file.path, TestMagic, TestVersion);
+    bool appendable = true;
+    EXPECT_TRUE(ReadAll(log, &appendable).empty());
+    EXPECT_FALSE(appendable);
+}
+
+TEST(RecordLog, ReadsBackWhatWasAppended) {
+    TempFile file;
+    WriteLog(file, { ThreeRecords[0] });
+    {
+        RecordLog log(file.path, TestMagic, TestVersion);
+        ReadAll(log);
+        log.Append(ThreeRecords[1]);
+        log.Append(ThreeRecords[2]);
+        EXPECT_EQ(log.get_records(), 3u);
+        EXPECT_EQ(log.get_bytes(), LogHeaderBytes + 3 * RecordBytes(3));
+    }
+
+    RecordLog log(file.path, TestMagic, TestVersion);
+    bool appendable = false;
+    EXPECT_EQ(ReadAll(log, &appendable), ThreeRecords);
+    EXPECT_TRUE(appendable);
+    EXPECT_EQ(log.get_records(), 3u);
+}
+
+TEST(RecordLog, TornRecordKeepsEverythingBeforeIt) {
+    TempFile file;
+    WriteLog(file, ThreeRecords);
+    file.Truncate(2);
+
+    RecordLog log(file.path, TestMagic, TestVersion);
+    bool appendable = true;
+    EXPECT_EQ(ReadAll(log, &appendable), Records(ThreeRecords.begin(), ThreeRecords.begin() + 2));
+    EXPECT_FALSE(appendable);
+}
+
+TEST(RecordLog, CorruptRecordStopsReading) {
+    TempFile file;
+    WriteLog(file, ThreeRecords);
+    // first payload byte of the second record
+    file.FlipByte(LogHeaderBytes + RecordBytes(3) + 1);
+
+    RecordLog log(file.path, TestMagic, TestVersion);
+    bool appendable = true;
+    EXPECT_EQ(ReadAll(log, &appendable), Records{ ThreeRecords[0] });
+    EXPECT_FALSE(appendable);
+}
+
+TEST(RecordLog, OversizedLengthIsCorrupt) {
+    TempFile file;
+    WriteLog(file, { ThreeRecords[0] });
+    auto content = file.Read();
+    // a varint claiming more than MaxRecordBytes, followed by nothing
+    content.insert(content.end(), { 0xff, 0xff, 0xff, 0x7f });
+    file.Write(content);
+
+    RecordLog log(file.path, TestMagic, TestVersion);
+    bool appendable = true;
+    EXPECT_EQ(ReadAll(log, &appendable), Records{ ThreeRecords[0] });
+    EXPECT_FALSE(appendable);
+}
+
+TEST(RecordLog, OtherVersionIsNotRead) {
+    TempFile file;
+    WriteLog(file, ThreeRecords);
+
+    RecordLog log(file.path, TestMagic, TestVersion + 1);
+    bool appendable = true;
+    EXPECT_TRUE(ReadAll(log, &appendable).empty());
+    EXPECT_FALSE(appendable);
+}
+
+TEST(RecordLog, OtherMagicIsNotRead) {
+    TempFile file;
+    WriteLog(file, ThreeRecords);
+
+    RecordLog log(file.path, { 'O', 'T', 'H', 'R' }, TestVersion);
+    EXPECT_TRUE(ReadAll(log).empty());
+}
+
+TEST(RecordLog, RecordTheOwnerCantReadIsCorrupt) {
+    TempFile file;
+    WriteLog(file, ThreeRecords);
+
+    RecordLog log(file.path, TestMagic, TestVersion);
+    std::size_t read = 0;
+    bool appendable = log.Open([&read](std::span<const uint8_t> payload){
+        if (payload[0] == 4) throw std::runtime_error("unreadable");
+        read++;
+    });
+    EXPECT_EQ(read, 1u);
+    EXPECT_FALSE(appendable);
+}
+
+TEST(RecordLog, RewriteReplacesTheLog) {
+    TempFile file;
+    WriteLog(file, ThreeRecords);
+    file.Truncate(2);
+    {
+        // what a store does with a log it can't append to
+        RecordLog log(file.path, TestMagic, TestVersion);
+        auto records = ReadAll(log);
+        ASSERT_TRUE(log.Rewrite([&log, &records](){
+            for (auto& record : records) log.Append(record);
+        }));
+        log.Append(ThreeRecords[2]);
+    }
+
+    RecordLog log(file.path, TestMagic, TestVersion);
+    bool appendable = false;
+    EXPECT_EQ(ReadAll(log, &appendable), ThreeRecords);
+    EXPECT_TRUE(appendable);
+    EXPECT_EQ(file.Size(), LogHeaderBytes + 3 * RecordBytes(3));
+    EXPECT_FALSE(std::filesystem::exists(file.path.string() + ".tmp"));
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "Utils/VarInt.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace MultiplayerCore::Tests {
+    /// @brief a file in the temp directory named after the running test, removed before and after it
+    struct TempFile {
+        TempFile() {
+            auto test = ::testing::UnitTest::GetInstance()->current_test_info();
+            path = std::filesystem::temp_directory_path() / (std::string("mpcore-test-") + test->test_suite_name() + "-" + test->name() + ".log");
+            Remove();
+        }
+        ~TempFile() { Remove(); }
+
+        TempFile(const TempFile&) = delete;
+        TempFile& operator=(const TempFile&) = delete;
+
+        std::vector<uint8_t> Read() const {
+            std::ifstream in(path, std::ios::binary);
+            return { std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>() };
+        }
+
+        void Write(const std::vector<uint8_t>& content) const {
+            std::ofstream out(path, std::ios::binary | std::ios::trunc);
+            out.write(reinterpret_cast<const char*>(content.data()), content.size());
+        }
+
+        /// @brief cuts the last bytes off, like the game dying while appending
+        void Truncate(std::size_t bytes) const {
+            auto content = Read();
+            content.resize(content.size() - std::min(bytes, content.size()));
+            Write(content);
+        }
+
+        void FlipByte(std::size_t offset) const {
+            auto content = Read();
+            content.at(offset) ^= 0xff;
+            Write(content);
+        }
+
+        std::size_t Size() const { return std::filesystem::file_size(path); }
+
+        std::filesystem::path path;
+
+        private:
+            void Remove() {
+                std::error_code error;
+                std::filesystem::remove(path, error);
+                auto temporary = path;
+                temporary += ".tmp";
+                std::filesystem::remove(temporary, error);
+            }
+    };
+
+    /// @brief bytes a record of payloadBytes takes in a RecordLog, with its length and checksum
+    constexpr std::size_t RecordBytes(std::size_t payloadBytes) { return Utils::VarInt::Size(payloadBytes) + payloadBytes + 4; }
+    /// @brief magic and version
+    constexpr std::size_t LogHeaderBytes = 5;
+}
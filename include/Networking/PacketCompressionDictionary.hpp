@@ -0,0 +1,17 @@
+#pragma once
+
+#include <string_view>
+
+namespace MultiplayerCore::Networking {
+    /// @brief LZ4 dictionary for compressed MpCore packets, primes the compressor with strings that show up in most beatmap and player packets.
+    /// Peers have to agree on this byte for byte, so never change it, add a new compression flag with a new dictionary instead.
+    /// The most common strings are at the end where offsets into the dictionary are shortest
+    inline constexpr std::string_view PacketCompressionDictionary =
+        "https://cdn.beatsaver.com/https://beatsaver.com/maps/cover.jpgcover.pngicon.pngavatar.png"
+        "ArtistComposerAudioEditingLightshowLightingLighterPlaytestingPlaytesterMappingMapper"
+        "Vivify HeckCinemaCustom ColorsBetter Note SpawnNoodle ExtensionsMapping ExtensionsChroma"
+        "LightshowLawless90Degree360DegreeNoArrowsOneSaberLegacyStandard"
+        "EasyNormalHardExpertExpertPlus"
+        "MpPlayerDataMpNodePoseSyncStatePacketMpCompactBeatmapPacketMpBeatmapPacket"
+        "custom_level_0123456789ABCDEF";
+}
@@ -0,0 +1,184 @@
+#pragma once
+
+#include "PacketFraming.hpp"
+#include "Networking/DecodeBudget.hpp"
+#include "Networking/DecodeLimits.hpp"
+#include "Networking/PacketCapture.hpp"
+#include "Networking/PacketKey.hpp"
+#include "Networking/PacketMetrics.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <exception>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+
+namespace MultiplayerCore::Networking {
+    /// @brief the receive side of MpPacketSerializer, independent of the game types: frame headers, compact ids, decode budgets, metrics,
+    /// decompression, batches and chunked transfers. The lobby sim and the replay tool run it with the host stand-ins.
+    /// TContext is the serializer, with its packetRegistry, packetHandlers, decodeBudget, incomingTransfers and metrics, and
+    ///  - Now(), the time budgets and transfers are measured in
+    ///  - GetSenderMetrics(peer)
+    ///  - get_capturing() and CapturePacket(direction, peer, packetName, frameFlags, payload)
+    ///  - WithBuffer(length, fn), calls fn(std::span<uint8_t> buffer, reader over that buffer) with a buffer the handlers may keep
+    ///  - OnPacketError(peer, packetName, exception), for everything but DecodeLimitExceeded
+    ///  - HasOwnSenderBudget(packetKey), true for packets whose handler limits senders itself, like the ones of a channel
+    struct PacketDispatch {
+        /// @brief counts a message against the sender's packet rate, recording it as dropped if it goes over.
+        /// Packets with a sender budget of their own don't count, so a chatty mod can't use up the rate MpCore's own packets need
+        template<typename TContext, typename TPeer>
+        static bool AcceptSender(TContext& context, TPeer peer, PacketKey packetKey, std::size_t length) {
+            if (context.HasOwnSenderBudget(packetKey)) return true;
+            return ChargeSender(context, peer, length);
+        }
+
+        /// @brief a message of the serializer's message type, length bytes at the reader position
+        template<typename TContext, typename TReader, typename TPeer>
+        static void Receive(TContext& context, TReader reader, int length, TPeer peer) {
+            ReadFrame(context, reader, length, peer, true);
+        }
+
+        /// @brief one frame without counting it against the sender's packet rate, for frames out of batches and chunked transfers
+        template<typename TContext, typename TReader, typename TPeer>
+        static void Frame(TContext& context, TReader reader, int length, TPeer peer) {
+            ReadFrame(context, reader, length, peer, false);
+        }
+
+        /// @brief hands a payload whose frame header was already read to its handler, what a packet capture stores is replayed through here
+        /// @param frameBytes size of the whole frame, what the metrics count as received
+        template<typename TContext, typename TReader, typename TPeer>
+        static void Dispatch(TContext& context, TReader reader, int length, TPeer peer, std::string_view packetId, PacketKey packetKey, uint8_t frameFlags, std::size_t frameBytes) {
+            auto start = reader->get_Position();
+            PacketTypeMetrics* packetMetrics = nullptr;
+            auto sender = context.GetSenderMetrics(peer);
+            try {
+                // names come from the peer, only the ones we handle get an entry of their own
+                auto handler = context.packetHandlers.find(packetKey);
+                packetMetrics = handler && *handler ? context.metrics->ForPacket(packetId) : context.metrics->ForUnknownPacket();
+                context.metrics->RecordReceived(packetMetrics, sender, frameBytes);
+
+                if (handler && *handler) {
+                    if (context.decodeBudget.CheckPacket(peer, packetKey, length, context.Now()) != DecodeBudget<TPeer>::Verdict::Accept) {
+                        context.metrics->RecordDropped(packetMetrics, sender);
+                    } else {
+                        auto handleStart = std::chrono::steady_clock::now();
+                        if (frameFlags == PacketFraming::FramePlain) (*handler)(reader, length, peer);
+                        else Decompressed(context, *handler, packetKey, reader, length, peer, frameFlags);
+                        context.metrics->RecordHandled(packetMetrics, std::chrono::steady_clock::now() - handleStart);
+                    }
+                }
+            }
+            catch (const DecodeLimitExceeded&) {
+                // expected from hostile or broken peers and possibly many per second, not worth a log line each
+                context.metrics->RecordDropped(packetMetrics, sender);
+            }
+            catch (const std::exception& e) {
+                context.OnPacketError(peer, packetId, e);
+            }
+            int processedBytes = reader->get_Position() - start;
+            reader->SkipBytes(length - processedBytes);
+        }
+
+        /// @brief handler of MpPacketBatch, every frame in it is dispatched like a packet of its own
+        template<typename TContext, typename TReader, typename TPeer>
+        static void Batch(TContext& context, TReader reader, int length, TPeer peer) {
+            // we never batch batches, and a batch in a batch in a reassembled chunk would recurse as deep as the transfer is long
+            static thread_local bool inBatch = false;
+            if (inBatch) throw std::runtime_error("Batches can't be nested");
+
+            auto end = reader->get_Position() + length;
+            auto frameCount = PacketFraming::ReadBatchFrameCount(reader, length);
+            inBatch = true;
+            try {
+                for (std::size_t i = 0; i < frameCount; i++) {
+                    int frameLength = PacketFraming::ReadBatchFrameLength(reader, end);
+                    // a bad frame only loses itself
+                    Frame(context, reader, frameLength, peer);
+                }
+            } catch (...) {
+                inBatch = false;
+                throw;
+            }
+            inBatch = false;
+        }
+
+        /// @brief handler of MpPacketChunk, the frame a chunk completes is dispatched like any other packet
+        template<typename TContext, typename TReader, typename TPeer>
+        static void Chunk(TContext& context, TReader reader, int length, TPeer peer) {
+            auto [transferId, totalLength, offset, chunkLength] = PacketFraming::ReadChunkHeader(reader, length);
+
+            std::span<const uint8_t> chunk(reader->get_RawData().begin() + reader->get_Position(), chunkLength);
+            auto frame = context.incomingTransfers.Add(peer, transferId, totalLength, offset, chunk, context.Now());
+            reader->SkipBytes(chunkLength);
+            if (frame.empty()) return;
+
+            context.WithBuffer(frame.size(), [&context, &frame, peer](std::span<uint8_t> buffer, auto frameReader){
+                std::copy(frame.begin(), frame.end(), buffer.begin());
+                Frame(context, frameReader, frame.size(), peer);
+            });
+        }
+
+        private:
+            template<typename TContext, typename THandler, typename TReader, typename TPeer>
+            static void Decompressed(TContext& context, const THandler& handler, PacketKey packetKey, TReader reader, int length, TPeer peer, uint8_t frameFlags) {
+                auto [payloadLength, compressedLength] = PacketFraming::ReadCompressedHeader(reader, length, frameFlags);
+                // a few compressed bytes can claim a large payload, check it before allocating for it
+                if (context.decodeBudget.CheckPacketSize(packetKey, payloadLength) != DecodeBudget<TPeer>::Verdict::Accept)
+                    throw DecodeLimitExceeded("Decompressed packet exceeds its decode budget");
+
+                context.WithBuffer(payloadLength, [&, payloadLength = payloadLength, compressedLength = compressedLength](std::span<uint8_t> payload, auto payloadReader){
+                    PacketFraming::Decompress(reader, compressedLength, payload);
+                    handler(payloadReader, payloadLength, peer);
+                });
+            }
+            template<typename TContext, typename TPeer>
+            static bool ChargeSender(TContext& context, TPeer peer, std::size_t length) {
+                if (context.decodeBudget.CheckSender(peer, context.Now()) == DecodeBudget<TPeer>::Verdict::Accept) return true;
+                auto sender = context.GetSenderMetrics(peer);
+                context.metrics->RecordReceived(nullptr, sender, length);
+                context.metrics->RecordDropped(nullptr, sender);
+                return false;
+            }
+
+            /// @param countSender whether the frame is a message of its own, which counts against the sender's packet rate
+            template<typename TContext, typename TReader, typename TPeer>
+            static void ReadFrame(TContext& context, TReader reader, int length, TPeer peer, bool countSender) {
+                std::string_view packetId = "null";
+                PacketKey packetKey = 0;
+                auto start = reader->get_Position();
+                PacketFraming::Header header;
+                try {
+                    header = PacketFraming::ReadHeader(reader);
+                    packetId = header.name;
+                    if (header.compact()) {
+                        // compact frame, resolve the id through the registry this player sent us, which comes with the keys already computed
+                        auto resolved = context.packetRegistry.ResolveIncoming(peer, header.compactId);
+                        packetId = resolved.name;
+                        packetKey = resolved.key;
+                        if (packetId.empty()) packetId = "null";
+                    } else packetKey = KeyOf(packetId);
+                } catch (const std::exception& e) {
+                    // a broken header still counts against the sender, so a flood of them can't flood the log
+                    if (!countSender || ChargeSender(context, peer, length)) context.OnPacketError(peer, packetId, e);
+                    reader->SkipBytes(length - (reader->get_Position() - start));
+                    return;
+                }
+                int payloadLength = length - (reader->get_Position() - start);
+
+                // captured before the budget checks, so a replay of it gets to drop the same packets
+                if (context.get_capturing()) {
+                    auto available = std::clamp(payloadLength, 0, reader->get_AvailableBytes());
+                    context.CapturePacket(CapturedPacket::Direction::Inbound, peer, packetId, header.flags, { reader->get_RawData().begin() + reader->get_Position(), std::size_t(available) });
+                }
+                // the header is a view into the message and a table lookup, cheap enough to read before the sender's rate is known
+                if (countSender && !AcceptSender(context, peer, packetKey, length)) {
+                    reader->SkipBytes(payloadLength);
+                    return;
+                }
+                Dispatch(context, reader, payloadLength, peer, packetId, packetKey, header.flags, length);
+            }
+    };
+}
@@ -0,0 +1,224 @@
+#pragma once
+
+#include "PacketCompressionDictionary.hpp"
+#include "Utils/Lz4.hpp"
+#include "Utils/VarInt.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace MultiplayerCore::Networking {
+    /// @brief framing of MpCore packets inside the base game's message type, independent of the game types.
+    /// Every frame starts with a LiteNetLib string, either the packet name, or a null string followed by
+    /// a varint compact id and a flag byte for peers that acknowledged our packet registry.
+    /// Works with anything shaped like a LiteNetLib NetDataWriter / NetDataReader
+    struct PacketFraming {
+        // flag byte following the id of compact frames
+        enum FrameFlags : uint8_t {
+            FramePlain = 0,
+            // varint decompressed size followed by an LZ4 block using PacketCompressionDictionary
+            FrameLz4 = 1
+        };
+
+        // anything claiming to be bigger than this once decompressed is dropped before allocating for it
+        static constexpr uint32_t MaxDecompressedBytes = 256 * 1024;
+        // same for reassembled chunked transfers
+        static constexpr uint32_t MaxTransferBytes = 1024 * 1024;
+
+        struct Header {
+            /// @brief packet name, empty for compact frames
+            std::string_view name;
+            uint32_t compactId = 0;
+            uint8_t flags = FramePlain;
+
+            bool compact() const { return name.empty(); }
+        };
+
+        /// @brief header of an MpPacketChunk, the chunk data follows it
+        struct ChunkHeader {
+            uint32_t transferId;
+            uint32_t totalLength;
+            uint32_t offset;
+            int length;
+        };
+
+        static std::span<const uint8_t> CompressionDictionary() {
+            return { reinterpret_cast<const uint8_t*>(PacketCompressionDictionary.data()), PacketCompressionDictionary.size() };
+        }
+
+        /// @brief name frame header, byte for byte what LiteNetLib writes for a utf8 string
+        template<typename TWriter>
+        static inline void WriteNameHeader(TWriter writer, std::string_view name) {
+            writer->Put(static_cast<int32_t>(name.size()));
+            for (char c : name) writer->Put(static_cast<uint8_t>(c));
+        }
+
+        /// @brief compact frame header, a null string followed by the id and a plain flag byte
+        /// @return position of the flag byte, for CompressPayload
+        template<typename TWriter>
+        static inline int WriteCompactHeader(TWriter writer, uint32_t compactId) {
+            // LiteNetLib writes null strings as a byte count of 0
+            writer->Put(int32_t(0));
+            Utils::VarInt::Write(writer, compactId);
+            int flagPosition = writer->get_Length();
+            writer->Put(uint8_t(FramePlain));
+            return flagPosition;
+        }
+
+        /// @brief reads a LiteNetLib string as a view into the reader buffer, empty for null and empty strings
+        template<typename TReader>
+        static inline std::string_view ReadName(TReader reader) {
+            // LiteNetLib strings are an int byte count followed by utf8 bytes, null and empty strings are written with a count of 0
+            int byteCount = reader->GetInt();
+            if (byteCount <= 0) return {};
+            if (byteCount > reader->get_AvailableBytes()) throw std::runtime_error("Packet name length exceeds available bytes");
+
+            auto data = reader->get_RawData();
+            std::string_view name(reinterpret_cast<const char*>(&data[reader->get_Position()]), byteCount);
+            reader->SkipBytes(byteCount);
+            return name;
+        }
+
+        template<typename TReader>
+        static inline Header ReadHeader(TReader reader) {
+            Header header;
+            header.name = ReadName(reader);
+            if (header.compact()) {
+                header.compactId = Utils::VarInt::Read(reader);
+                header.flags = reader->GetByte();
+            }
+            return header;
+        }
+
+        /// @brief replaces the payload that was just written with its compressed form if that is smaller, and updates the frame flag to match
+        /// @return whether the payload was compressed
+        template<typename TWriter>
+        static bool CompressPayload(TWriter writer, int flagPosition, int payloadStart, std::size_t threshold) {
+            uint32_t payloadLength = writer->get_Length() - payloadStart;
+            if (payloadLength < threshold || payloadLength > MaxDecompressedBytes) return false;
+
+            auto data = writer->get_Data();
+            static thread_local std::vector<uint8_t> compressed;
+            compressed.resize(Utils::Lz4::CompressBound(payloadLength));
+            auto compressedLength = Utils::Lz4::Compress({ data.begin() + payloadStart, payloadLength }, compressed, CompressionDictionary());
+
+            // size header + compressed data has to beat the plain payload, otherwise it goes out as is
+            if (compressedLength == 0 || Utils::VarInt::Size(payloadLength) + compressedLength >= payloadLength) return false;
+
+            // the compressed frame is smaller than what's already in the writer, so it can be written over it in place
+            data[flagPosition] = FrameLz4;
+            writer->SetPosition(payloadStart);
+            Utils::VarInt::Write(writer, payloadLength);
+            int compressedStart = writer->get_Length();
+            std::copy_n(compressed.begin(), compressedLength, data.begin() + compressedStart);
+            writer->SetPosition(compressedStart + compressedLength);
+            return true;
+        }
+
+        /// @brief reads the size header of a compressed payload of length bytes
+        /// @return decompressed size and the number of compressed bytes following the header
+        template<typename TReader>
+        static std::pair<uint32_t, std::size_t> ReadCompressedHeader(TReader reader, int length, uint8_t flags) {
+            if (flags != FrameLz4) throw std::runtime_error("Unknown frame flags");
+
+            auto start = reader->get_Position();
+            auto payloadLength = Utils::VarInt::Read(reader);
+            if (payloadLength > MaxDecompressedBytes) throw std::runtime_error("Compressed packet is too large");
+            int compressedLength = length - (reader->get_Position() - start);
+            if (compressedLength < 0 || compressedLength > reader->get_AvailableBytes()) throw std::runtime_error("Compressed packet length exceeds available bytes");
+            return { payloadLength, std::size_t(compressedLength) };
+        }
+
+        /// @brief decompresses the compressedLength bytes at the reader position into payload, which has to be sized to the decompressed size
+        template<typename TReader>
+        static void Decompress(TReader reader, std::size_t compressedLength, std::span<uint8_t> payload) {
+            auto data = reader->get_RawData();
+            if (!Utils::Lz4::Decompress({ data.begin() + reader->get_Position(), compressedLength }, payload, CompressionDictionary()))
+                throw std::runtime_error("Compressed packet is corrupt");
+            reader->SkipBytes(compressedLength);
+        }
+
+        /// @brief reads the frame count of an MpPacketBatch payload of length bytes
+        template<typename TReader>
+        static uint32_t ReadBatchFrameCount(TReader reader, int length) {
+            auto start = reader->get_Position();
+            auto frameCount = Utils::VarInt::Read(reader);
+            // every frame takes at least its length byte, so counts larger than what's left are garbage
+            if (frameCount > static_cast<uint32_t>(std::max(0, length - (reader->get_Position() - start)))) throw std::runtime_error("Batch frame count exceeds batch size");
+            return frameCount;
+        }
+
+        /// @brief reads the length of the next frame of a batch that ends at end, the frame follows at the reader position
+        template<typename TReader>
+        static int ReadBatchFrameLength(TReader reader, int end) {
+            int frameLength = Utils::VarInt::Read(reader);
+            if (frameLength <= 0 || frameLength > end - reader->get_Position()) throw std::runtime_error("Batched packet length exceeds batch size");
+            return frameLength;
+        }
+
+        /// @brief reads the header of an MpPacketChunk payload of length bytes
+        template<typename TReader>
+        static ChunkHeader ReadChunkHeader(TReader reader, int length) {
+            auto start = reader->get_Position();
+            ChunkHeader header;
+            header.transferId = Utils::VarInt::Read(reader);
+            header.totalLength = Utils::VarInt::Read(reader);
+            header.offset = Utils::VarInt::Read(reader);
+            header.length = length - (reader->get_Position() - start);
+            if (header.length <= 0 || header.length > reader->get_AvailableBytes()) throw std::runtime_error("Chunk length exceeds available bytes");
+            if (header.totalLength > MaxTransferBytes) throw std::runtime_error("Chunked transfer is too large");
+            return header;
+        }
+
+        /// @brief just enough of a NetDataReader over a frame in memory for the functions above
+        struct SpanReader {
+            std::span<const uint8_t> data;
+            int position = 0;
+
+            uint8_t GetByte() {
+                if (position >= static_cast<int>(data.size())) throw std::runtime_error("Frame ends within its header");
+                return data[position++];
+            }
+
+            int32_t GetInt() {
+                uint32_t value = 0;
+                for (int i = 0; i < 4; i++) value |= uint32_t(GetByte()) << (8 * i);
+                return static_cast<int32_t>(value);
+            }
+
+            std::span<const uint8_t> get_RawData() const { return data; }
+            int get_Position() const { return position; }
+            int get_AvailableBytes() const { return static_cast<int>(data.size()) - position; }
+            void SkipBytes(int count) { position += count; }
+        };
+
+        /// @brief the same packet as a name frame, for a queued compact frame whose receivers don't all know its id anymore.
+        /// Name frames can't be compressed, so a compressed payload is decompressed
+        static std::vector<uint8_t> ToNameFrame(std::span<const uint8_t> frame, std::string_view name) {
+            SpanReader reader{ frame };
+            auto header = ReadHeader(&reader);
+            if (!header.compact()) return { frame.begin(), frame.end() };
+
+            std::vector<uint8_t> nameFrame;
+            nameFrame.reserve(sizeof(int32_t) + name.size() + reader.get_AvailableBytes());
+            for (int i = 0; i < 4; i++) nameFrame.push_back(uint8_t(uint32_t(name.size()) >> (8 * i)));
+            nameFrame.insert(nameFrame.end(), name.begin(), name.end());
+            if (header.flags == FramePlain) {
+                nameFrame.insert(nameFrame.end(), frame.begin() + reader.get_Position(), frame.end());
+                return nameFrame;
+            }
+
+            auto [payloadLength, compressedLength] = ReadCompressedHeader(&reader, reader.get_AvailableBytes(), header.flags);
+            auto payloadStart = nameFrame.size();
+            nameFrame.resize(payloadStart + payloadLength);
+            Decompress(&reader, compressedLength, std::span<uint8_t>(nameFrame).subspan(payloadStart));
+            return nameFrame;
+        }
+    };
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "Networking/Abstractions/MpPacket.hpp"
+#include <vector>
+
+// container for several already framed MpCore packets, unpacked in place by the serializer on receive
+DECLARE_CLASS_CUSTOM(MultiplayerCore::Networking::Packets, MpPacketBatch, MultiplayerCore::Networking::Abstractions::MpPacket,
+    DECLARE_OVERRIDE_METHOD_MATCH(void, Serialize, &LiteNetLib::Utils::INetSerializable::Serialize, LiteNetLib::Utils::NetDataWriter* writer);
+
+    DECLARE_CTOR(ctor);
+    public:
+        uint32_t frameCount;
+        /// @brief frames back to back, each prefixed with its varint length
+        std::vector<uint8_t> frames;
+
+    DECLARE_PACKET_NAME(MpPacketBatch);
+)
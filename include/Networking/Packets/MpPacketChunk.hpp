@@ -0,0 +1,19 @@
+#pragma once
+
+#include "Networking/Abstractions/MpPacket.hpp"
+
+// one piece of an already framed MpCore packet that was too large to send in one go, reassembled by the serializer on receive
+DECLARE_CLASS_CUSTOM(MultiplayerCore::Networking::Packets, MpPacketChunk, MultiplayerCore::Networking::Abstractions::MpPacket,
+    DECLARE_INSTANCE_FIELD(uint32_t, transferId);
+    DECLARE_INSTANCE_FIELD(uint32_t, totalLength);
+    DECLARE_INSTANCE_FIELD(uint32_t, offset);
+    DECLARE_INSTANCE_FIELD(uint32_t, length);
+    /// @brief the whole framed packet, this chunk is data[offset, offset + length)
+    DECLARE_INSTANCE_FIELD(ArrayW<uint8_t>, data);
+
+    DECLARE_OVERRIDE_METHOD_MATCH(void, Serialize, &LiteNetLib::Utils::INetSerializable::Serialize, LiteNetLib::Utils::NetDataWriter* writer);
+
+    DECLARE_CTOR(ctor);
+
+    DECLARE_PACKET_NAME(MpPacketChunk);
+)
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "Networking/Abstractions/MpPacket.hpp"
+
+// acknowledges how many entries of the receiver's packet registry we know about
+DECLARE_CLASS_CUSTOM(MultiplayerCore::Networking::Packets, MpPacketRegistryAckPacket, MultiplayerCore::Networking::Abstractions::MpPacket,
+    DECLARE_INSTANCE_FIELD(uint32_t, packetCount);
+
+    DECLARE_OVERRIDE_METHOD_MATCH(void, Serialize, &LiteNetLib::Utils::INetSerializable::Serialize, LiteNetLib::Utils::NetDataWriter* writer);
+    DECLARE_OVERRIDE_METHOD_MATCH(void, Deserialize, &LiteNetLib::Utils::INetSerializable::Deserialize, LiteNetLib::Utils::NetDataReader* reader);
+
+    DECLARE_CTOR(ctor);
+
+    DECLARE_PACKET_NAME(MpPacketRegistryAckPacket);
+)
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "Networking/Abstractions/MpPacket.hpp"
+#include <string>
+#include <vector>
+
+// sent to peers so they can map the compact packet ids we use on the wire back to packet names
+DECLARE_CLASS_CUSTOM(MultiplayerCore::Networking::Packets, MpPacketRegistryPacket, MultiplayerCore::Networking::Abstractions::MpPacket,
+    DECLARE_OVERRIDE_METHOD_MATCH(void, Serialize, &LiteNetLib::Utils::INetSerializable::Serialize, LiteNetLib::Utils::NetDataWriter* writer);
+    DECLARE_OVERRIDE_METHOD_MATCH(void, Deserialize, &LiteNetLib::Utils::INetSerializable::Deserialize, LiteNetLib::Utils::NetDataReader* reader);
+
+    DECLARE_CTOR(ctor);
+    public:
+        /// @brief packet names indexed by their compact id
+        std::vector<std::string> packetNames;
+
+    DECLARE_PACKET_NAME(MpPacketRegistryPacket);
+)
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "Networking/DecodeLimits.hpp"
+#include "Utils/VarInt.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+namespace MultiplayerCore::Networking::Packets {
+    /// @brief payloads of MpPacketRegistryPacket and MpPacketRegistryAckPacket as Deserialize reads them,
+    /// templated on the reader and the packet so the fuzz targets decode them with the same code as the game
+    struct MpPacketRegistryPacketEncoding {
+        template<typename TReader, typename TPacket>
+        static inline void Read(TReader reader, TPacket& packet) {
+            auto count = DecodeLimits::CheckCount(Utils::VarInt::Read(reader), DecodeLimits::MaxPacketNames);
+            packet.packetNames.clear();
+            // a name takes at least a byte, a made up count can't reserve more than the packet holds
+            packet.packetNames.reserve(std::min<uint32_t>(count, reader->get_AvailableBytes()));
+            for (std::size_t i = 0; i < count; i++)
+                packet.packetNames.emplace_back(reader->GetString());
+        }
+
+        template<typename TReader, typename TPacket>
+        static inline void ReadAck(TReader reader, TPacket& packet) {
+            packet.packetCount = Utils::VarInt::Read(reader);
+        }
+    };
+}
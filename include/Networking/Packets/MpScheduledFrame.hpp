@@ -0,0 +1,13 @@
+#pragma once
+
+#include "Networking/Abstractions/MpPacket.hpp"
+
+// an MpCore packet that was framed when it was sent and waited in the send queue, the serializer writes the frame as is.
+// Never appears on the wire under its own name, so it has no packet name
+DECLARE_CLASS_CUSTOM(MultiplayerCore::Networking::Packets, MpScheduledFrame, MultiplayerCore::Networking::Abstractions::MpPacket,
+    DECLARE_INSTANCE_FIELD(ArrayW<uint8_t>, frame);
+
+    DECLARE_OVERRIDE_METHOD_MATCH(void, Serialize, &LiteNetLib::Utils::INetSerializable::Serialize, LiteNetLib::Utils::NetDataWriter* writer);
+
+    DECLARE_CTOR(ctor);
+)
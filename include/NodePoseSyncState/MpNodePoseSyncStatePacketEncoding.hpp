@@ -0,0 +1,12 @@
+#pragma once
+
+namespace MultiplayerCore::NodePoseSyncState {
+    /// @brief payload of MpNodePoseSyncStatePacket as Deserialize reads it, templated on the reader and the packet so the fuzz targets decode it with the same code as the game
+    struct MpNodePoseSyncStatePacketEncoding {
+        template<typename TReader, typename TPacket>
+        static inline void Read(TReader reader, TPacket& packet) {
+            packet.deltaUpdateFrequencyMs = reader->GetLong();
+            packet.fullStateUpdateFrequencyMs = reader->GetLong();
+        }
+    };
+}
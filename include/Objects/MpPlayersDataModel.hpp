@@ -9,10 +9,14 @@
 #include "Networking/MpPacketSerializer.hpp"
 #include "Beatmaps/Providers/MpBeatmapLevelProvider.hpp"
 #include "Beatmaps/Packets/MpBeatmapPacket.hpp"
+#include "Beatmaps/Packets/MpCompactBeatmapPacket.hpp"
 
 DECLARE_CLASS_CODEGEN(MultiplayerCore::Objects, MpPlayersDataModel, GlobalNamespace::LobbyPlayersDataModel,
     DECLARE_INSTANCE_FIELD_PRIVATE(Networking::MpPacketSerializer*, _packetSerializer);
     DECLARE_INSTANCE_FIELD_PRIVATE(Beatmaps::Providers::MpBeatmapLevelProvider*, _beatmapLevelProvider);
+    DECLARE_INSTANCE_FIELD_PRIVATE(Beatmaps::Packets::MpBeatmapPacket*, _localBeatmapPacket);
+    DECLARE_INSTANCE_FIELD_PRIVATE(Beatmaps::Packets::MpCompactBeatmapPacket*, _localCompactBeatmapPacket);
+    DECLARE_INSTANCE_FIELD_PRIVATE(GlobalNamespace::IPreviewBeatmapLevel*, _localBeatmapPacketLevel);
 
     DECLARE_INSTANCE_METHOD(void, Activate_override);
     DECLARE_INSTANCE_METHOD(void, Deactivate_override);
@@ -23,4 +27,16 @@ DECLARE_CLASS_CODEGEN(MultiplayerCore::Objects, MpPlayersDataModel, GlobalNamesp
     DECLARE_INSTANCE_METHOD(void, HandleMpexBeatmapPacket, Beatmaps::Packets::MpBeatmapPacket* packet, GlobalNamespace::IConnectedPlayer* player);
     DECLARE_OVERRIDE_METHOD_MATCH(void, Dispose, &::System::IDisposable::Dispose);
     DECLARE_CTOR(ctor, Networking::MpPacketSerializer* packetSerializer, Beatmaps::Providers::MpBeatmapLevelProvider* beatmapLevelProvider);
+
+    private:
+        /// @brief tells the lobby and the other players about the local selection, once its level is resolved
+        void ApplyLocalBeatmapLevel(GlobalNamespace::PreviewDifficultyBeatmap* beatmapLevel);
+        /// @brief packet for the local selection, reused while the selection doesn't change so its payload cache entry stays valid.
+        /// The payload cache goes by instance, so a new level instance for the same id, like a resolved BeatSaver preview, gets a new packet as well
+        Beatmaps::Packets::MpBeatmapPacket* GetLocalBeatmapPacket(GlobalNamespace::PreviewDifficultyBeatmap* beatmapLevel);
+        /// @brief send the local selection, compact to players that support it and the old format to everyone else
+        void SendLocalBeatmapPacket(GlobalNamespace::PreviewDifficultyBeatmap* beatmapLevel);
+        std::string _localBeatmapPacketKey;
+        /// @brief counts local selections, a BeatSaver lookup only sends its result if no newer selection came in while it ran
+        uint64_t _localSelection = 0;
 )
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+
+namespace MultiplayerCore::Beatmaps::Abstractions {
+    /// @brief wire format of DifficultyColors, a byte with a bit per present color followed by r, g, b floats of each present color
+    /// works on anything with the seven optional color members of DifficultyColors, so it can be used without the game types
+    struct DifficultyColorsEncoding {
+        static constexpr std::size_t ColorCount = 7;
+
+        /// @brief color members in bit order
+        template<typename TColors>
+        static constexpr std::array Members = {
+            &TColors::colorLeft,
+            &TColors::colorRight,
+            &TColors::envColorLeft,
+            &TColors::envColorRight,
+            &TColors::envColorLeftBoost,
+            &TColors::envColorRightBoost,
+            &TColors::obstacleColor
+        };
+
+        template<typename TColors>
+        static constexpr uint8_t Mask(const TColors& colors) {
+            uint8_t mask = 0;
+            for (std::size_t i = 0; i < ColorCount; i++)
+                if ((colors.*Members<TColors>[i]).has_value()) mask |= 1 << i;
+            return mask;
+        }
+
+        static constexpr bool Has(uint8_t mask, std::size_t index) { return (mask >> index) & 1; }
+
+        template<typename TWriter, typename TColors>
+        static inline void Write(TWriter writer, const TColors& colors) {
+            writer->Put(Mask(colors));
+            for (auto member : Members<TColors>) {
+                const auto& color = colors.*member;
+                if (!color.has_value()) continue;
+                writer->Put(color->r);
+                writer->Put(color->g);
+                writer->Put(color->b);
+            }
+        }
+
+        /// @brief read colors written by Write, colors missing from the mask are reset
+        template<typename TReader, typename TColors>
+        static inline void Read(TReader reader, TColors& colors) {
+            uint8_t mask = reader->GetByte();
+            for (std::size_t i = 0; i < ColorCount; i++) {
+                auto& color = colors.*Members<TColors>[i];
+                if (!Has(mask, i)) {
+                    color.reset();
+                    continue;
+                }
+                // separate statements, the reads have to happen in order
+                float r = reader->GetFloat();
+                float g = reader->GetFloat();
+                float b = reader->GetFloat();
+                color.emplace(r, g, b);
+            }
+        }
+    };
+}
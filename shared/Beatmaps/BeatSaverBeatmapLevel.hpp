@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Abstractions/MpBeatmapLevel.hpp"
+#include "BeatmapMetadataStore.hpp"
 #include "songdownloader/shared/Types/BeatSaver/Beatmap.hpp"
 
 DECLARE_CLASS_CUSTOM(MultiplayerCore::Beatmaps, BeatSaverBeatmapLevel, Abstractions::MpBeatmapLevel,
@@ -15,7 +16,8 @@ DECLARE_CLASS_CUSTOM(MultiplayerCore::Beatmaps, BeatSaverBeatmapLevel, Abstracti
 
     DECLARE_CTOR(ctor_1, StringW hash);
     public:
+        static BeatSaverBeatmapLevel* Make(const std::string& hash, const BeatmapMetadata& metadata);
         static BeatSaverBeatmapLevel* Make(const std::string& hash, const BeatSaver::Beatmap& beatmap);
     protected:
-        BeatSaver::Beatmap beatmap;
+        BeatmapMetadata metadata;
 )
@@ -0,0 +1,121 @@
+#pragma once
+
+#include "../_config.h"
+#include "../Utils/RecordLog.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace MultiplayerCore::Beatmaps {
+    /// @brief the part of a BeatSaver map MpCore uses, small enough to keep every map we've seen on disk
+    struct BeatmapMetadata {
+        struct Difficulty {
+            enum Requirement : uint8_t {
+                Chroma = 1 << 0,
+                MappingExtensions = 1 << 1,
+                NoodleExtensions = 1 << 2
+            };
+            uint8_t requirements = 0;
+
+            // named like the songdownloader types, so EntitlementDecision takes either
+            bool GetChroma() const { return requirements & Chroma; }
+            bool GetME() const { return requirements & MappingExtensions; }
+            bool GetNE() const { return requirements & NoodleExtensions; }
+        };
+
+        struct Version {
+            std::string hash;
+            std::vector<Difficulty> diffs;
+
+            const std::string& GetHash() const { return hash; }
+            const std::vector<Difficulty>& GetDiffs() const { return diffs; }
+        };
+
+        /// @brief hash the map was looked up by, lower case
+        std::string hash;
+        /// @brief false if BeatSaver doesn't know the hash, those are remembered as well but not for as long
+        bool found = false;
+        std::string key;
+        /// @brief cover of the version the map was looked up by, so a cached map's cover needs no lookup
+        std::string coverUrl;
+        std::string songName;
+        std::string songSubName;
+        std::string songAuthorName;
+        std::string levelAuthorName;
+        float bpm = 0;
+        float duration = 0;
+        std::vector<Version> versions;
+        std::chrono::system_clock::time_point fetched;
+    };
+
+    /// @brief BeatmapMetadata by level hash, kept in memory and in a RecordLog on disk so it outlives the game session.
+    /// One record per Store or Erase, the latest record of a hash wins.
+    /// Safe to use from any thread
+    class MPCORE_EXPORT BeatmapMetadataStore {
+        public:
+            static constexpr Utils::RecordLog::Magic Magic = { 'M', 'P', 'B', 'M' };
+            static constexpr uint8_t Version = 2;
+
+            // maps get new versions. A miss may be a WIP that gets uploaded any time, or BeatSaver not answering
+            static constexpr std::chrono::seconds DefaultFoundTtl = std::chrono::hours(24 * 7);
+            static constexpr std::chrono::seconds DefaultMissingTtl = std::chrono::minutes(10);
+
+            struct Stats {
+                uint64_t hits = 0;
+                uint64_t misses = 0;
+                /// @brief lookups that found an entry past its TTL, those count as misses as well
+                uint64_t expired = 0;
+                uint64_t stores = 0;
+                std::size_t entries = 0;
+                uint64_t logBytes = 0;
+            };
+
+            /// @brief read the log at path, or start a new one if there is none or it can't be read
+            explicit BeatmapMetadataStore(std::filesystem::path path);
+
+            /// @return the entry for hash if it is younger than its TTL, nullopt otherwise
+            std::optional<BeatmapMetadata> Find(std::string_view hash, std::chrono::system_clock::time_point now = std::chrono::system_clock::now());
+            /// @brief add or replace the entry of metadata.hash, and append it to the log
+            void Store(BeatmapMetadata metadata);
+            /// @brief forget the entry of hash until it is stored again, in the log as well
+            void Erase(std::string_view hash);
+
+            void set_ttl(std::chrono::seconds found, std::chrono::seconds missing);
+            Stats get_stats() const;
+
+            /// @brief rewrite the log with only the latest record of every hash and without the entries that expired by now,
+            /// happens on its own when the log is mostly replaced records
+            bool Compact(std::chrono::system_clock::time_point now = std::chrono::system_clock::now());
+
+            /// @brief the entry part of a record, appended to record
+            static void Encode(const BeatmapMetadata& metadata, std::vector<uint8_t>& record);
+            /// @brief throws std::runtime_error if the record is cut short or doesn't make sense
+            static BeatmapMetadata Decode(std::span<const uint8_t> record);
+
+        private:
+            static void EncodeErased(std::string_view hash, std::vector<uint8_t>& record);
+            /// @return the hash of an Erase record, nullopt for any other record
+            static std::optional<std::string> DecodeErased(std::span<const uint8_t> record);
+
+            void Append(const BeatmapMetadata& metadata);
+            bool IsExpired(const BeatmapMetadata& metadata, std::chrono::system_clock::time_point now) const;
+            bool CompactLocked(std::chrono::system_clock::time_point now);
+
+            mutable std::mutex mutex;
+            Utils::RecordLog log;
+            std::unordered_map<std::string, BeatmapMetadata> entries;
+            std::chrono::seconds foundTtl = DefaultFoundTtl;
+            std::chrono::seconds missingTtl = DefaultMissingTtl;
+            Stats stats;
+            std::vector<uint8_t> record;
+    };
+}
@@ -5,7 +5,13 @@
 #include "songdownloader/shared/Types/BeatSaver/Beatmap.hpp"
 
 DECLARE_CLASS_CUSTOM(MultiplayerCore::Beatmaps, NetworkBeatmapLevel, Abstractions::MpBeatmapLevel,
-    DECLARE_INSTANCE_FIELD_PRIVATE(Packets::MpBeatmapPacket*, _packet);
+    // packets are pooled, so everything we need from the packet gets copied out of it
+    DECLARE_INSTANCE_FIELD_PRIVATE(StringW, _songName);
+    DECLARE_INSTANCE_FIELD_PRIVATE(StringW, _songSubName);
+    DECLARE_INSTANCE_FIELD_PRIVATE(StringW, _songAuthorName);
+    DECLARE_INSTANCE_FIELD_PRIVATE(StringW, _levelAuthorName);
+    DECLARE_INSTANCE_FIELD_PRIVATE(float, _beatsPerMinute);
+    DECLARE_INSTANCE_FIELD_PRIVATE(float, _songDuration);
 
     DECLARE_OVERRIDE_METHOD_MATCH(StringW, get_songName, &GlobalNamespace::IPreviewBeatmapLevel::get_songName);
 	DECLARE_OVERRIDE_METHOD_MATCH(StringW, get_songSubName, &GlobalNamespace::IPreviewBeatmapLevel::get_songSubName);
@@ -21,9 +27,11 @@ DECLARE_CLASS_CUSTOM(MultiplayerCore::Beatmaps, NetworkBeatmapLevel, Abstraction
     DECLARE_CTOR(ctor_1, Packets::MpBeatmapPacket*);
 
     public:
-        const std::unordered_map<uint8_t, std::list<std::string>>& get_requirements() { return _packet->requirements; };
-        const std::unordered_map<uint8_t, MultiplayerCore::Beatmaps::Abstractions::DifficultyColors>& get_mapColors() { return _packet->mapColors; };
-        const std::vector<const MultiplayerCore::Utils::ExtraSongData::Contributor>& get_contributors() { return _packet->contributors; };
+        const std::unordered_map<uint8_t, std::list<std::string>>& get_requirements() { return requirements[_characteristic]; };
+        const std::unordered_map<uint8_t, MultiplayerCore::Beatmaps::Abstractions::DifficultyColors>& get_mapColors() { return difficultyColors[_characteristic]; };
+        const std::vector<const MultiplayerCore::Utils::ExtraSongData::Contributor>& get_contributors() { return contributors; };
+    private:
+        std::string _characteristic;
 )
 
 #undef SONGDOWNLOADER_INCLUDED
@@ -1,14 +1,14 @@
 #pragma once
 
 #include "custom-types/shared/macros.hpp"
-#include "../../Networking/Abstractions/MpPacket.hpp"
+#include "../../Networking/Abstractions/MpPoolablePacket.hpp"
 #include "../../Utils/ExtraSongData.hpp"
 #include "../Abstractions/DifficultyColors.hpp"
 
 #include "GlobalNamespace/PreviewDifficultyBeatmap.hpp"
 #include <list>
 
-DECLARE_CLASS_CUSTOM(MultiplayerCore::Beatmaps::Packets, MpBeatmapPacket, MultiplayerCore::Networking::Abstractions::MpPacket,
+DECLARE_CLASS_CUSTOM(MultiplayerCore::Beatmaps::Packets, MpBeatmapPacket, MultiplayerCore::Networking::Abstractions::MpPoolablePacket,
     DECLARE_INSTANCE_FIELD(StringW, levelHash);
     DECLARE_INSTANCE_FIELD(StringW, songName);
     DECLARE_INSTANCE_FIELD(StringW, songSubName);
@@ -29,4 +29,12 @@ DECLARE_CLASS_CUSTOM(MultiplayerCore::Beatmaps::Packets, MpBeatmapPacket, Multip
         std::unordered_map<uint8_t, std::list<std::string>> requirements;
         std::unordered_map<uint8_t, MultiplayerCore::Beatmaps::Abstractions::DifficultyColors> mapColors;
         std::vector<const MultiplayerCore::Utils::ExtraSongData::Contributor> contributors;
+
+        /// @brief whether all requirements fit in the DecodeLimits, a packet with more would have receivers play the map without some of them
+        bool RequirementsFit() const;
+    protected:
+        /// @brief Serialize writes at most what DecodeLimits allow, this logs what it leaves out
+        void LogDroppedElements() const;
+
+    DECLARE_PACKET_NAME(MpBeatmapPacket);
 )
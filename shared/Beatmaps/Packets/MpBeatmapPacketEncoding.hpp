@@ -0,0 +1,62 @@
+#pragma once
+
+#include "../Abstractions/DifficultyColorsEncoding.hpp"
+#include "../../Networking/DecodeLimits.hpp"
+
+#include <cstddef>
+#include <utility>
+
+namespace MultiplayerCore::Beatmaps::Packets {
+    /// @brief payload of MpBeatmapPacket as Deserialize reads it, templated on the reader and the packet so the fuzz targets decode it with the same code as the game.
+    /// TPacket needs the members of MpBeatmapPacket, its strings have to be assignable from what the reader's GetString() returns
+    struct MpBeatmapPacketEncoding {
+        template<typename TReader, typename TPacket>
+        static inline void Read(TReader reader, TPacket& packet) {
+            using Networking::DecodeLimits;
+
+            packet.levelHash = reader->GetString();
+            packet.songName = reader->GetString();
+            packet.songSubName = reader->GetString();
+            packet.songAuthorName = reader->GetString();
+            packet.levelAuthorName = reader->GetString();
+            packet.beatsPerMinute = reader->GetFloat();
+            packet.songDuration = reader->GetFloat();
+
+            packet.characteristic = reader->GetString();
+            packet.difficulty = reader->GetUInt();
+
+            // pooled instances still hold whatever the previous packet left in them
+            packet.requirements.clear();
+            packet.contributors.clear();
+            packet.mapColors.clear();
+
+            // counts are checked before reading what they count, so a bad packet is dropped without building anything for it
+            auto& budget = Networking::ElementBudget::get();
+            auto maxRequirements = budget.get_maxRequirementsPerDifficulty();
+            auto difficultyCount = DecodeLimits::CheckCount(reader->GetByte(), DecodeLimits::MaxDifficulties);
+            for (std::size_t i = 0; i < difficultyCount; i++) {
+                auto difficulty = reader->GetByte();
+                auto& reqsForDifficulty = packet.requirements[difficulty];
+                // a difficulty listed twice adds to the same list, which has to stay within the limit as a whole
+                auto reqCount = DecodeLimits::CheckCount(reader->GetByte(), maxRequirements - reqsForDifficulty.size());
+                for (std::size_t j = 0; j < reqCount; j++)
+                    reqsForDifficulty.emplace_back(reader->GetString());
+            }
+
+            auto contributorCount = DecodeLimits::CheckCount(reader->GetByte(), budget.get_maxContributors());
+            for (std::size_t i = 0; i < contributorCount; i++) {
+                // separate statements, the reads have to happen in order
+                auto name = reader->GetString();
+                auto role = reader->GetString();
+                auto iconPath = reader->GetString();
+                packet.contributors.emplace_back(std::move(name), std::move(role), std::move(iconPath));
+            }
+
+            auto colorCount = DecodeLimits::CheckCount(reader->GetByte(), budget.get_maxMapColors());
+            for (std::size_t i = 0; i < colorCount; i++) {
+                auto difficulty = reader->GetByte();
+                Abstractions::DifficultyColorsEncoding::Read(reader, packet.mapColors[difficulty]);
+            }
+        }
+    };
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "custom-types/shared/macros.hpp"
+#include "MpBeatmapPacket.hpp"
+
+// Same data as MpBeatmapPacket in a smaller encoding: varint counts and string lengths, the level hash as raw bytes,
+// requirements as indices into a string table and colors as RGB8 (or half floats when they are outside 0..1).
+// It has its own packet name, so it's only sent to players that registered a handler for it and everyone else gets the MpBeatmapPacket
+DECLARE_CLASS_CUSTOM(MultiplayerCore::Beatmaps::Packets, MpCompactBeatmapPacket, MultiplayerCore::Beatmaps::Packets::MpBeatmapPacket,
+    DECLARE_OVERRIDE_METHOD_MATCH(void, Serialize, &LiteNetLib::Utils::INetSerializable::Serialize, LiteNetLib::Utils::NetDataWriter* writer);
+    DECLARE_OVERRIDE_METHOD_MATCH(void, Deserialize, &LiteNetLib::Utils::INetSerializable::Deserialize, LiteNetLib::Utils::NetDataReader* reader);
+
+    DECLARE_CTOR(New);
+    public:
+        /// @brief copy of an existing beatmap packet, to send the same selection in the compact encoding
+        static MpCompactBeatmapPacket* New_1(MpBeatmapPacket* packet);
+
+    DECLARE_PACKET_NAME(MpCompactBeatmapPacket);
+)
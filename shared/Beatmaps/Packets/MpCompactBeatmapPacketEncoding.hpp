@@ -0,0 +1,111 @@
+#pragma once
+
+#include "../Abstractions/DifficultyColorsEncoding.hpp"
+#include "../../Networking/DecodeLimits.hpp"
+#include "../../Utils/CompactEncoding.hpp"
+#include "../../Utils/VarInt.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace MultiplayerCore::Beatmaps::Packets {
+    /// @brief payload of MpCompactBeatmapPacket as Deserialize reads it, templated on the reader and the packet so the fuzz targets decode it with the same code as the game.
+    /// TPacket needs the members of MpCompactBeatmapPacket, its strings have to be assignable from std::string
+    struct MpCompactBeatmapPacketEncoding {
+        // flags byte at the start of the packet
+        static constexpr uint8_t RawLevelHashFlag = 1 << 0;
+
+        static constexpr std::size_t LevelHashBytes = 20;
+
+        template<typename TReader, typename TPacket>
+        static inline void Read(TReader reader, TPacket& packet) {
+            using namespace Utils;
+            using Networking::DecodeLimits;
+
+            auto flags = reader->GetByte();
+            if (flags & RawLevelHashFlag) {
+                std::array<uint8_t, LevelHashBytes> rawHash;
+                for (auto& b : rawHash) b = reader->GetByte();
+                packet.levelHash = HexBytes::Encode(rawHash.data(), rawHash.size());
+            } else {
+                packet.levelHash = CompactString::Read(reader);
+            }
+
+            packet.songName = CompactString::Read(reader);
+            packet.songSubName = CompactString::Read(reader);
+            packet.songAuthorName = CompactString::Read(reader);
+            packet.levelAuthorName = CompactString::Read(reader);
+            packet.beatsPerMinute = reader->GetFloat();
+            packet.songDuration = reader->GetFloat();
+
+            packet.characteristic = CompactString::Read(reader);
+            packet.difficulty = VarInt::Read(reader);
+
+            // pooled instances still hold whatever the previous packet left in them
+            packet.requirements.clear();
+            packet.contributors.clear();
+            packet.mapColors.clear();
+
+            // every entry takes at least a byte, so counts larger than what's left are garbage
+            auto readCount = [reader](uint32_t max) {
+                auto count = VarInt::Read(reader);
+                if (count > static_cast<uint32_t>(reader->get_AvailableBytes())) throw std::runtime_error("Count exceeds available bytes");
+                return DecodeLimits::CheckCount(count, max);
+            };
+
+            auto& budget = Networking::ElementBudget::get();
+            auto maxRequirements = budget.get_maxRequirementsPerDifficulty();
+
+            std::vector<std::string> stringTable(readCount(DecodeLimits::MaxRequirementStrings));
+            for (auto& str : stringTable) str = CompactString::Read(reader);
+
+            auto difficultyCount = readCount(DecodeLimits::MaxDifficulties);
+            for (std::size_t i = 0; i < difficultyCount; i++) {
+                auto& reqsForDifficulty = packet.requirements[reader->GetByte()];
+                // a difficulty listed twice adds to the same list, which has to stay within the limit as a whole
+                auto reqCount = readCount(maxRequirements - reqsForDifficulty.size());
+                for (std::size_t j = 0; j < reqCount; j++) {
+                    auto index = VarInt::Read(reader);
+                    if (index >= stringTable.size()) throw std::runtime_error("Requirement index out of range");
+                    reqsForDifficulty.emplace_back(stringTable[index]);
+                }
+            }
+
+            auto contributorCount = readCount(budget.get_maxContributors());
+            packet.contributors.reserve(contributorCount);
+            for (std::size_t i = 0; i < contributorCount; i++) {
+                auto name = CompactString::Read(reader);
+                auto role = CompactString::Read(reader);
+                auto iconPath = CompactString::Read(reader);
+                packet.contributors.emplace_back(std::move(name), std::move(role), std::move(iconPath));
+            }
+
+            auto colorCount = readCount(budget.get_maxMapColors());
+            for (std::size_t i = 0; i < colorCount; i++) {
+                auto& colors = packet.mapColors[reader->GetByte()];
+                constexpr auto& members = Abstractions::DifficultyColorsEncoding::Members<std::remove_reference_t<decltype(colors)>>;
+                uint8_t present = reader->GetByte();
+                uint8_t wide = reader->GetByte();
+                for (std::size_t j = 0; j < members.size(); j++) {
+                    if ((present & (1 << j)) == 0) continue;
+                    float r, g, b;
+                    if (wide & (1 << j)) {
+                        r = HalfFloat::ToFloat(reader->GetUShort());
+                        g = HalfFloat::ToFloat(reader->GetUShort());
+                        b = HalfFloat::ToFloat(reader->GetUShort());
+                    } else {
+                        r = UnitFloat8::ToFloat(reader->GetByte());
+                        g = UnitFloat8::ToFloat(reader->GetByte());
+                        b = UnitFloat8::ToFloat(reader->GetByte());
+                    }
+                    (colors.*members[j]).emplace(r, g, b);
+                }
+            }
+        }
+    };
+}
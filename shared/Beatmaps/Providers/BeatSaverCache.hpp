@@ -0,0 +1,45 @@
+#pragma once
+
+#include "../../_config.h"
+#include "../BeatmapMetadataStore.hpp"
+#include "songdownloader/shared/Types/BeatSaver/Beatmap.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace MultiplayerCore::Beatmaps::Providers {
+    /// @brief every BeatSaver lookup of MpCore goes through here, a map is fetched once and served from disk in later sessions until its TTL runs out.
+    /// Covers are kept on disk next to the metadata. Safe to call from any thread, everything blocks on BeatSaver when it isn't cached.
+    /// Callers asking for the same hash while its request runs wait for that request instead of sending their own,
+    /// and maps looked up within a few milliseconds of each other are asked for in one request
+    struct MPCORE_EXPORT BeatSaverCache {
+        struct RequestStats {
+            /// @brief requests sent to BeatSaver, maps and covers
+            uint64_t requests = 0;
+            /// @brief lookups that waited on a request already running for their hash
+            uint64_t coalesced = 0;
+            /// @brief map lookups that went out in the request of another hash
+            uint64_t batched = 0;
+            std::size_t inFlight = 0;
+        };
+
+        /// @return metadata of the map with hash, nullopt if BeatSaver doesn't have it or didn't answer
+        static std::optional<BeatmapMetadata> GetMetadata(const std::string& hash);
+        /// @brief the map as BeatSaver returns it, for downloading it. The store only keeps BeatmapMetadata,
+        /// so this asks BeatSaver even for cached maps and only skips the request for maps we know BeatSaver doesn't have
+        static std::optional<BeatSaver::Beatmap> GetBeatmap(const std::string& hash);
+        /// @return bytes of the cover image of the map, empty if there is none. Downloaded from the cover url of its metadata,
+        /// which is only looked up if the map isn't cached
+        static std::vector<uint8_t> GetCoverImage(const std::string& hash);
+
+        static BeatmapMetadataStore& get_store();
+        static RequestStats get_requestStats();
+
+        /// @brief where the BeatSaver API is, can point to a local server for testing
+        static std::string get_apiUrl();
+        static void set_apiUrl(std::string url);
+        static BeatmapMetadata ToMetadata(const std::string& hash, const BeatSaver::Beatmap& beatmap);
+    };
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "../../_config.h"
+
+#if __has_include("beatsaber-hook/shared/rapidjson/include/rapidjson/document.h")
+#include "beatsaber-hook/shared/rapidjson/include/rapidjson/document.h"
+#else
+#include "rapidjson/document.h"
+#endif
+
+#include <functional>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace MultiplayerCore::Beatmaps::Providers {
+    /// @brief reads BeatSaver's answers, independent of the songdownloader types so the host build can test it on recorded responses
+    struct MPCORE_EXPORT BeatSaverResponse {
+        static constexpr long HttpOk = 200;
+        static constexpr long HttpNotFound = 404;
+
+        using MapCallback = std::function<void(const std::string& hash, const rapidjson::Value& map)>;
+        using MissingCallback = std::function<void(const std::string& hash)>;
+
+        /// @brief reads the answer to maps/hash/<hashes>. One hash is answered with the map itself or a 404,
+        /// several with an object of hash to map that has null for the hashes BeatSaver doesn't know.
+        /// Calls onMap for every hash BeatSaver has a map for and onMissing for every hash it answered it doesn't have,
+        /// hashes it didn't answer for get neither. Hashes are passed lower case, only the ones asked for are passed.
+        /// Throws std::runtime_error if BeatSaver didn't answer the lookup: any other status, or a body that isn't a json object
+        /// @param status http status, 0 if the request didn't get an answer
+        static void ReadHashLookup(std::span<const std::string> hashes, long status, std::string_view body, const MapCallback& onMap, const MissingCallback& onMissing);
+    };
+}
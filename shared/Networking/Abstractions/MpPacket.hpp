@@ -1,5 +1,6 @@
 #pragma once
 #include "custom-types/shared/macros.hpp"
+#include "../PacketKey.hpp"
 
 #include "LiteNetLib/Utils/NetDataReader.hpp"
 #include "LiteNetLib/Utils/NetDataWriter.hpp"
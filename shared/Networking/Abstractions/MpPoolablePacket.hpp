@@ -0,0 +1,47 @@
+#pragma once
+#include "../../_config.h"
+#include "MpPacket.hpp"
+
+#include "GlobalNamespace/IPoolablePacket.hpp"
+
+// MpPacket that can be reused by the packet serializer instead of allocating a new instance for every received packet.
+// Received instances are only released after your handler returns if it was registered with RegisterPooledCallback,
+// handlers registered with RegisterCallback get a retained instance they are free to keep
+DECLARE_CLASS_CUSTOM_INTERFACES(MultiplayerCore::Networking::Abstractions, MpPoolablePacket, MultiplayerCore::Networking::Abstractions::MpPacket, std::vector<Il2CppClass*>({classof(GlobalNamespace::IPoolablePacket*)}),
+    DECLARE_OVERRIDE_METHOD_MATCH(void, Release, &GlobalNamespace::IPoolablePacket::Release);
+
+    DECLARE_CTOR(ctor);
+    public:
+        [[nodiscard]] GlobalNamespace::IPoolablePacket* i_IPoolablePacket() { return reinterpret_cast<GlobalNamespace::IPoolablePacket*>(this); }
+
+        /// @brief keep this instance out of the pool, Release will not return it anymore
+        void Retain() { retained = true; }
+        bool get_retained() const { return retained; }
+    private:
+        friend struct MpPacketPool;
+        bool retained;
+        // guards against returning the same instance twice
+        bool pooled;
+)
+
+namespace MultiplayerCore::Networking::Abstractions {
+    /// @brief Per thread pool of released MpPoolablePacket instances, keyed by their class
+    struct MPCORE_EXPORT MpPacketPool {
+        template<typename TPacket>
+        requires(std::is_pointer_v<TPacket> && std::is_base_of_v<MpPoolablePacket, std::remove_pointer_t<TPacket>>)
+        static TPacket Obtain() {
+            if (auto packet = Obtain(classof(TPacket))) return reinterpret_cast<TPacket>(packet);
+            return il2cpp_utils::NewSpecific<TPacket>();
+        }
+
+        /// @brief take a pooled instance of the given class
+        /// @return the instance, or nullptr if the pool for that class is empty
+        static MpPoolablePacket* Obtain(Il2CppClass* packetClass);
+
+        /// @brief put a packet back into the pool for its class
+        static void Return(MpPoolablePacket* packet);
+
+        /// @brief max amount of instances kept per class and thread
+        static constexpr std::size_t MaxPooledPerClass = 32;
+    };
+}
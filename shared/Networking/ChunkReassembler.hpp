@@ -0,0 +1,74 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+namespace MultiplayerCore::Networking {
+    /// @brief reassembly of the chunked transfers peers send to an MpPacketSerializer, independent of the game types.
+    /// TPeer identifies a connected player, transfers of different players never mix
+    template<typename TPeer>
+    class ChunkReassembler {
+        public:
+            // limits for reassembly, transfers going over these are dropped
+            static constexpr std::size_t MaxTransfersPerPeer = 4;
+            static constexpr std::chrono::seconds Timeout{10};
+
+            /// @brief adds a chunk of a transfer, totalLength has to be checked against the transfer size limit before
+            /// @return the reassembled frame if this chunk completed its transfer, empty otherwise
+            std::vector<uint8_t> Add(TPeer peer, uint32_t transferId, uint32_t totalLength, uint32_t offset, std::span<const uint8_t> chunk, std::chrono::steady_clock::time_point now) {
+                auto& peerTransfers = transfers[peer];
+                auto transfer = peerTransfers.find(transferId);
+                if (transfer == peerTransfers.end()) {
+                    // chunks arrive in order on the reliable channel, so this is a transfer that started before we joined
+                    if (offset != 0) return {};
+                    if (peerTransfers.size() >= MaxTransfersPerPeer) throw std::runtime_error("Too many concurrent chunked transfers");
+                    transfer = peerTransfers.emplace(transferId, Transfer{totalLength, {}, {}}).first;
+                }
+
+                // the buffer only grows by what actually arrived, a transfer claiming to be large costs nothing up front
+                auto& incoming = transfer->second;
+                if (offset != incoming.data.size() || totalLength != incoming.totalLength || incoming.data.size() + chunk.size() > totalLength) {
+                    peerTransfers.erase(transfer);
+                    throw std::runtime_error("Chunk does not continue its transfer");
+                }
+
+                incoming.data.insert(incoming.data.end(), chunk.begin(), chunk.end());
+                incoming.lastChunk = now;
+                if (incoming.data.size() < incoming.totalLength) return {};
+
+                auto frame = std::move(incoming.data);
+                peerTransfers.erase(transfer);
+                return frame;
+            }
+
+            /// @brief drop transfers that did not get a chunk within Timeout, calling onExpired(transferId, receivedBytes, totalLength) for each
+            template<typename TFunc>
+            void Expire(std::chrono::steady_clock::time_point now, TFunc&& onExpired) {
+                for (auto& [peer, peerTransfers] : transfers) {
+                    std::erase_if(peerTransfers, [now, &onExpired](auto& x){
+                        if (now - x.second.lastChunk <= Timeout) return false;
+                        onExpired(x.first, x.second.data.size(), x.second.totalLength);
+                        return true;
+                    });
+                }
+            }
+
+            void RemovePeer(TPeer peer) { transfers.erase(peer); }
+            void clear() { transfers.clear(); }
+            bool empty() const { return transfers.empty(); }
+
+        private:
+            struct Transfer {
+                uint32_t totalLength;
+                std::vector<uint8_t> data;
+                std::chrono::steady_clock::time_point lastChunk;
+            };
+
+            std::unordered_map<TPeer, std::unordered_map<uint32_t, Transfer>> transfers;
+    };
+}
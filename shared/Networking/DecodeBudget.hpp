@@ -0,0 +1,133 @@
+#pragma once
+
+#include "PacketHandlerTable.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace MultiplayerCore::Networking {
+    /// @brief token bucket holding up to a second worth of packets, the rate is passed on every call so it can change at runtime
+    class RateLimiter {
+        public:
+            /// @brief take a token if there is one, a rate of 0 is unlimited
+            bool TryTake(uint32_t perSecond, std::chrono::steady_clock::time_point now) {
+                if (perSecond == 0) return true;
+
+                if (!started) {
+                    // a new sender starts out with a full bucket
+                    tokens = perSecond;
+                    started = true;
+                } else {
+                    auto elapsed = std::chrono::duration<double>(now - last).count();
+                    tokens = std::min<double>(perSecond, tokens + std::max(0.0, elapsed) * perSecond);
+                }
+                last = now;
+
+                if (tokens < 1) return false;
+                tokens -= 1;
+                return true;
+            }
+
+        private:
+            double tokens = 0;
+            std::chrono::steady_clock::time_point last;
+            bool started = false;
+    };
+
+    /// @brief runtime limits on what peers may make an MpPacketSerializer decode, independent of the game types.
+    /// Everything in here is checked before a packet is allocated or decoded, so going over budget costs a table lookup.
+    /// TPeer identifies a connected player, every player gets budgets of their own
+    template<typename TPeer>
+    class DecodeBudget {
+        public:
+            // packets of all types a sender may send per second, high enough for a chunked transfer at 120 fps
+            static constexpr uint32_t DefaultSenderPacketsPerSecond = 1000;
+
+            /// @brief limits of one packet type, 0 is unlimited
+            struct PacketLimits {
+                /// @brief largest payload, after decompression
+                uint32_t maxBytes = 0;
+                /// @brief packets a single sender may send per second
+                uint32_t maxPerSecond = 0;
+            };
+
+            enum class Verdict : uint8_t {
+                Accept,
+                SenderRate,
+                PacketRate,
+                PacketSize
+            };
+
+            /// @brief packets per second a single sender may send in total, 0 is unlimited
+            void set_senderPacketsPerSecond(uint32_t value) { senderPacketsPerSecond = value; }
+            uint32_t get_senderPacketsPerSecond() const { return senderPacketsPerSecond; }
+
+            void SetPacketLimits(std::string_view packetName, PacketLimits limits) {
+                if (auto existing = packetLimits.find(packetName)) {
+                    existing->limits = limits;
+                    return;
+                }
+                packetLimits.set(packetName, Entry{limits, nextSlot++});
+            }
+
+            /// @return the limits of a packet type, unlimited if none were set
+            PacketLimits GetPacketLimits(std::string_view packetName) const {
+                auto entry = packetLimits.find(packetName);
+                return entry ? entry->limits : PacketLimits{};
+            }
+
+            /// @brief counts a message from peer against their total rate, before anything of it is read
+            Verdict CheckSender(TPeer peer, std::chrono::steady_clock::time_point now) {
+                if (senderPacketsPerSecond == 0) return Verdict::Accept;
+                return peers[peer].packets.TryTake(senderPacketsPerSecond, now) ? Verdict::Accept : Verdict::SenderRate;
+            }
+
+            /// @brief counts a packet from peer against the limits of its type, once its header was read
+            /// @param payloadBytes payload size on the wire, compressed payloads get checked again with CheckPacketSize once their decompressed size is known
+            Verdict CheckPacket(TPeer peer, PacketKey packetKey, std::size_t payloadBytes, std::chrono::steady_clock::time_point now) {
+                auto entry = packetLimits.find(packetKey);
+                if (!entry) return Verdict::Accept;
+                // size first, an oversized packet shouldn't use up the rate of legitimate ones
+                if (entry->limits.maxBytes && payloadBytes > entry->limits.maxBytes) return Verdict::PacketSize;
+                if (entry->limits.maxPerSecond == 0) return Verdict::Accept;
+
+                auto& types = peers[peer].packetTypes;
+                if (types.size() <= entry->slot) types.resize(entry->slot + 1);
+                return types[entry->slot].TryTake(entry->limits.maxPerSecond, now) ? Verdict::Accept : Verdict::PacketRate;
+            }
+
+            /// @brief only checks the size, for decompressed payloads that CheckPacket already counted against the rate
+            Verdict CheckPacketSize(PacketKey packetKey, std::size_t payloadBytes) const {
+                auto entry = packetLimits.find(packetKey);
+                return entry && entry->limits.maxBytes && payloadBytes > entry->limits.maxBytes ? Verdict::PacketSize : Verdict::Accept;
+            }
+
+            Verdict CheckPacket(TPeer peer, std::string_view packetName, std::size_t payloadBytes, std::chrono::steady_clock::time_point now) { return CheckPacket(peer, KeyOf(packetName), payloadBytes, now); }
+            Verdict CheckPacketSize(std::string_view packetName, std::size_t payloadBytes) const { return CheckPacketSize(KeyOf(packetName), payloadBytes); }
+
+            void RemovePeer(TPeer peer) { peers.erase(peer); }
+            void clear() { peers.clear(); }
+
+        private:
+            struct Entry {
+                PacketLimits limits;
+                // index into the per peer rate limiters
+                std::size_t slot = 0;
+            };
+
+            struct PeerBudget {
+                RateLimiter packets;
+                std::vector<RateLimiter> packetTypes;
+            };
+
+            uint32_t senderPacketsPerSecond = DefaultSenderPacketsPerSecond;
+            PacketHandlerTable<Entry> packetLimits;
+            std::size_t nextSlot = 0;
+            std::unordered_map<TPeer, PeerBudget> peers;
+    };
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "../_config.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+
+namespace MultiplayerCore::Networking {
+    /// @brief thrown when a packet goes over a decode limit or budget, MpPacketSerializer drops those without logging and counts them in its metrics
+    struct DecodeLimitExceeded : std::runtime_error {
+        using std::runtime_error::runtime_error;
+    };
+
+    /// @brief hard caps on what a single MpCore packet may decode into.
+    /// Counts read off the wire are checked against these before anything is allocated for them,
+    /// so a hostile peer can't make the receive path build huge collections or loop for long
+    struct DecodeLimits {
+        // BeatmapDifficulty has 5 values, a little headroom for whatever mods add
+        static constexpr uint32_t MaxDifficulties = 8;
+        static constexpr uint32_t MaxRequirementsPerDifficulty = 32;
+        static constexpr uint32_t MaxContributors = 64;
+        static constexpr uint32_t MaxMapColors = MaxDifficulties;
+        /// @brief distinct requirement strings of MpCompactBeatmapPacket
+        static constexpr uint32_t MaxRequirementStrings = MaxDifficulties * MaxRequirementsPerDifficulty;
+        static constexpr uint32_t MaxPacketNames = 1024;
+
+        /// @brief count, if it is within max
+        static inline uint32_t CheckCount(uint32_t count, uint32_t max) {
+            if (count > max) throw DecodeLimitExceeded("Packet count exceeds its decode limit");
+            return count;
+        }
+    };
+
+    /// @brief element counts the beatmap packets accept, adjustable at runtime but never above the hard caps of DecodeLimits.
+    /// Packets have no way to reach a serializer while decoding, so there is one budget for the whole mod
+    class MPCORE_EXPORT ElementBudget {
+        public:
+            static ElementBudget& get();
+
+            uint32_t get_maxRequirementsPerDifficulty() const { return maxRequirementsPerDifficulty.load(std::memory_order_relaxed); }
+            void set_maxRequirementsPerDifficulty(uint32_t value) { maxRequirementsPerDifficulty.store(std::min(value, DecodeLimits::MaxRequirementsPerDifficulty), std::memory_order_relaxed); }
+
+            uint32_t get_maxContributors() const { return maxContributors.load(std::memory_order_relaxed); }
+            void set_maxContributors(uint32_t value) { maxContributors.store(std::min(value, DecodeLimits::MaxContributors), std::memory_order_relaxed); }
+
+            uint32_t get_maxMapColors() const { return maxMapColors.load(std::memory_order_relaxed); }
+            void set_maxMapColors(uint32_t value) { maxMapColors.store(std::min(value, DecodeLimits::MaxMapColors), std::memory_order_relaxed); }
+
+        private:
+            std::atomic<uint32_t> maxRequirementsPerDifficulty = DecodeLimits::MaxRequirementsPerDifficulty;
+            std::atomic<uint32_t> maxContributors = DecodeLimits::MaxContributors;
+            std::atomic<uint32_t> maxMapColors = DecodeLimits::MaxMapColors;
+    };
+}
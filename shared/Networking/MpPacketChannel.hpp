@@ -0,0 +1,143 @@
+#pragma once
+
+#include "../_config.h"
+#include "MpPacketSerializer.hpp"
+#include "DecodeBudget.hpp"
+#include "PacketHandlerTable.hpp"
+#include "PacketKey.hpp"
+#include "PacketMetrics.hpp"
+#include "PacketPriority.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace MultiplayerCore::Networking {
+    /// @brief a mod's own namespace of packets on an MpPacketSerializer, get one with MpPacketSerializer::GetChannel.
+    /// Packets of a channel go out named "<channel>/<packet name>", so they can't collide with the packets of other channels or of MpCore itself,
+    /// and the channel has handlers, metrics, rate limits and a priority of its own.
+    /// A packet type belongs to a single channel, the first one it was registered or sent on
+    class MPCORE_EXPORT MpPacketChannel {
+        public:
+            static constexpr char Separator = '/';
+
+            MpPacketChannel(MpPacketSerializer* serializer, std::string name, uint32_t id);
+
+            const std::string& get_name() const { return name; }
+            /// @brief sub-id of the channel on its serializer, channels are numbered from 1 in the order they were created, 0 is MpCore's own packets
+            uint32_t get_id() const { return id; }
+            /// @brief name packets of the channel go by on the wire
+            std::string WireName(std::string_view packetName) const;
+
+            /// @return false if the packet type already belongs to another channel or its wire name has the same key as another packet, see RegisterCallback of MpPacketSerializer
+            template<::MultiplayerCore::INetSerializable TPacket>
+            requires(std::is_pointer_v<TPacket>)
+            bool RegisterCallback(std::function<void(TPacket)> callback) { return RegisterCallback([callback](TPacket packet, GlobalNamespace::IConnectedPlayer* player){ callback(packet); }); }
+
+            template<::MultiplayerCore::INetSerializable TPacket>
+            requires(std::is_pointer_v<TPacket>)
+            bool RegisterCallback(std::function<void(TPacket, GlobalNamespace::IConnectedPlayer*)> callback) {
+                return RegisterHandler(classof(TPacket), reinterpret_cast<Il2CppReflectionType*>(csTypeOf(TPacket)), MpPacketSerializer::NameOfPacket<TPacket>(),
+                    [callback](LiteNetLib::Utils::NetDataReader* reader, int size, GlobalNamespace::IConnectedPlayer* player){
+                        PacketDecoding::Dispatch<TPacket>(callback, reader, size, player);
+                    }
+                );
+            }
+
+            /// @brief see RegisterAsyncCallback of MpPacketSerializer
+            template<::MultiplayerCore::INetSerializable TPacket, typename TResult>
+            requires(std::is_pointer_v<TPacket>)
+            bool RegisterAsyncCallback(std::function<TResult(TPacket, GlobalNamespace::IConnectedPlayer*)> work, std::function<void(TResult, GlobalNamespace::IConnectedPlayer*)> apply) {
+                auto packetName = MpPacketSerializer::NameOfPacket<TPacket>();
+                return RegisterHandler(classof(TPacket), reinterpret_cast<Il2CppReflectionType*>(csTypeOf(TPacket)), packetName,
+                    serializer->MakeAsyncHandler(KeyOf(WireName(packetName)), &PacketDecoding::DecodeObject<TPacket>, PacketDecoding::MakeAsyncWork<TPacket, TResult>(std::move(work), std::move(apply)))
+                );
+            }
+
+            template<::MultiplayerCore::INetSerializable TPacket>
+            requires(std::is_pointer_v<TPacket>)
+            void UnregisterCallback() { UnregisterHandler(reinterpret_cast<Il2CppReflectionType*>(csTypeOf(TPacket)), MpPacketSerializer::NameOfPacket<TPacket>()); }
+
+            template<::MultiplayerCore::INetSerializable TPacket>
+            requires(std::is_pointer_v<TPacket>)
+            void Send(TPacket packet) { if (Claim<TPacket>()) serializer->Send(packet); }
+
+            template<::MultiplayerCore::INetSerializable TPacket>
+            requires(std::is_pointer_v<TPacket>)
+            void SendUnreliable(TPacket packet) { if (Claim<TPacket>()) serializer->SendUnreliable(packet); }
+
+            template<::MultiplayerCore::INetSerializable TPacket>
+            requires(std::is_pointer_v<TPacket>)
+            void SendTo(GlobalNamespace::IConnectedPlayer* player, TPacket packet) { if (Claim<TPacket>()) serializer->SendTo(player, packet); }
+
+            template<::MultiplayerCore::INetSerializable TPacket>
+            requires(std::is_pointer_v<TPacket>)
+            void SendToMany(std::span<GlobalNamespace::IConnectedPlayer* const> players, TPacket packet) { if (Claim<TPacket>()) serializer->SendToMany(players, packet); }
+
+            /// @brief whether a player registered a handler for a packet type on this channel, only known once their packet registry arrived
+            template<::MultiplayerCore::INetSerializable TPacket>
+            requires(std::is_pointer_v<TPacket>)
+            bool PlayerHandles(GlobalNamespace::IConnectedPlayer* player) const { return serializer->PlayerHandles(player, WireName(MpPacketSerializer::NameOfPacket<TPacket>())); }
+
+            /// @brief limit the payload size of a packet type of this channel and how many of them a single player may send per second, 0 is unlimited
+            template<::MultiplayerCore::INetSerializable TPacket>
+            requires(std::is_pointer_v<TPacket>)
+            void SetDecodeBudget(uint32_t maxBytes, uint32_t maxPerSecond) { decodeBudget.SetPacketLimits(WireName(MpPacketSerializer::NameOfPacket<TPacket>()), { maxBytes, maxPerSecond }); }
+
+            /// @brief how many packets of this channel a single player may send per second, 0 is unlimited.
+            /// They count against this limit instead of the one of the serializer, so a chatty mod gets throttled without touching anyone else's packets
+            void set_senderPacketsPerSecond(uint32_t value) { decodeBudget.set_senderPacketsPerSecond(value); }
+            uint32_t get_senderPacketsPerSecond() const { return decodeBudget.get_senderPacketsPerSecond(); }
+
+            /// @brief priority of everything sent on this channel, MpCore's own packets are Normal
+            void set_priority(PacketPriority value) { priority = value; }
+            PacketPriority get_priority() const { return priority; }
+
+            /// @brief counters of this channel's packets only, by the name they were registered with.
+            /// The metrics of the serializer count them as well, under their wire names
+            const PacketMetrics& get_metrics() const { return *metrics; }
+
+        private:
+            friend class MpPacketSerializer;
+
+            struct Handler {
+                PacketHandler handle;
+                PacketTypeMetrics* metrics = nullptr;
+            };
+
+            bool RegisterHandler(Il2CppClass* packetClass, Il2CppReflectionType* packetType, std::string_view packetName, PacketHandler handler);
+            void UnregisterHandler(Il2CppReflectionType* packetType, std::string_view packetName);
+
+            /// @brief makes sure packets of TPacket go out under this channel's name
+            template<::MultiplayerCore::INetSerializable TPacket>
+            requires(std::is_pointer_v<TPacket>)
+            bool Claim() {
+                if (serializer->ChannelOf(classof(TPacket)) == this) return true;
+                return Claim(classof(TPacket), MpPacketSerializer::NameOfPacket<TPacket>());
+            }
+            bool Claim(Il2CppClass* packetClass, std::string_view packetName);
+
+            /// @brief handler the serializer calls for every packet of this channel, after the packet limits of the serializer, the sender limit is the channel's own
+            void Dispatch(PacketKey packetKey, LiteNetLib::Utils::NetDataReader* reader, int length, GlobalNamespace::IConnectedPlayer* player);
+            /// @brief counts a packet sent by the serializer
+            void RecordSent(std::string_view wireName, std::size_t bytes);
+            void RemovePeer(GlobalNamespace::IConnectedPlayer* player);
+            void ClearPeers();
+
+            SenderMetrics* GetSenderMetrics(GlobalNamespace::IConnectedPlayer* player);
+
+            MpPacketSerializer* serializer;
+            std::string name;
+            uint32_t id;
+            PacketPriority priority = PacketPriority::Normal;
+            // keyed by wire name, the key the serializer dispatches by as well
+            PacketHandlerTable<Handler> handlers;
+            DecodeBudget<GlobalNamespace::IConnectedPlayer*> decodeBudget;
+            std::unique_ptr<PacketMetrics> metrics = std::make_unique<PacketMetrics>();
+            std::unordered_map<GlobalNamespace::IConnectedPlayer*, SenderMetrics*> senderMetrics;
+    };
+}
@@ -10,30 +10,47 @@
 #include "LiteNetLib/Utils/NetDataWriter.hpp"
 #include "LiteNetLib/Utils/NetDataReader.hpp"
 #include "LiteNetLib/Utils/INetSerializable.hpp"
-#include "GlobalNamespace/IPoolablePacket.hpp"
 
 #include "System/IDisposable.hpp"
 #include "System/Type.hpp"
+#include "System/Action_1.hpp"
 #include "Zenject/IInitializable.hpp"
+#include "Zenject/ITickable.hpp"
 
 #include "GlobalNamespace/MultiplayerSessionManager.hpp"
-#include "GlobalNamespace/ThreadStaticPacketPool_1.hpp"
+#include "ChunkReassembler.hpp"
+#include "DecodeBudget.hpp"
+#include "PacketCapture.hpp"
+#include "PacketDecoding.hpp"
+#include "PacketHandlerTable.hpp"
+#include "PacketKey.hpp"
+#include "PacketMetrics.hpp"
+#include "PacketPriority.hpp"
+#include "PacketRegistry.hpp"
+#include "RegisteredTypeSet.hpp"
+#include "SendScheduler.hpp"
+#include "../Utils/WorkerPool.hpp"
 
 #include <type_traits>
-#include <map>
+#include <atomic>
+#include <chrono>
 #include <list>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace MultiplayerCore::Networking::Packets {
+    class MpPacketRegistryPacket;
+    class MpPacketRegistryAckPacket;
+}
 
-namespace MultiplayerCore {
-    template<typename TPacket>
-    concept INetSerializable = requires(TPacket t) {
-        {t->i_INetSerializable()} -> std::same_as<LiteNetLib::Utils::INetSerializable*>;
-    };
-
-    template<typename TPacket>
-    concept IPoolablePacket = INetSerializable<TPacket> && requires(TPacket t) {
-        {t->i_IPoolablePacket()} -> std::same_as<GlobalNamespace::IPoolablePacket*>;
-        {GlobalNamespace::ThreadStaticPacketPool_1<TPacket>::get_pool()->Obtain()} -> std::same_as<TPacket>;
-    };
+namespace MultiplayerCore::Networking {
+    class MpPacketChannel;
 }
 
 using PacketHandler = std::function<void (LiteNetLib::Utils::NetDataReader*, int, GlobalNamespace::IConnectedPlayer*)>;
@@ -71,9 +88,10 @@ struct ::il2cpp_utils::il2cpp_type_check::MetadataGetter<static_cast<bool (Globa
 };
 
 DECLARE_CLASS_CODEGEN_INTERFACES(MultiplayerCore::Networking, MpPacketSerializer, System::Object,
-    std::vector<Il2CppClass*>({classof(GlobalNamespace::INetworkPacketSubSerializer_1<GlobalNamespace::IConnectedPlayer*>*), classof(::Zenject::IInitializable*), classof(System::IDisposable*)}),
+    std::vector<Il2CppClass*>({classof(GlobalNamespace::INetworkPacketSubSerializer_1<GlobalNamespace::IConnectedPlayer*>*), classof(::Zenject::IInitializable*), classof(::Zenject::ITickable*), classof(System::IDisposable*)}),
 
     DECLARE_OVERRIDE_METHOD_MATCH(void, Initialize, &::Zenject::IInitializable::Initialize);
+    DECLARE_OVERRIDE_METHOD_MATCH(void, Tick, &::Zenject::ITickable::Tick);
     DECLARE_OVERRIDE_METHOD_MATCH(void, Dispose, &::System::IDisposable::Dispose);
     DECLARE_OVERRIDE_METHOD_MATCH(void, Serialize, &GlobalNamespace::INetworkPacketSubSerializer_1<GlobalNamespace::IConnectedPlayer*>::Serialize, LiteNetLib::Utils::NetDataWriter* writer, LiteNetLib::Utils::INetSerializable* packet);
     DECLARE_OVERRIDE_METHOD_MATCH(void, Deserialize, &GlobalNamespace::INetworkPacketSubSerializer_1<GlobalNamespace::IConnectedPlayer*>::Deserialize, LiteNetLib::Utils::NetDataReader* reader, int length, GlobalNamespace::IConnectedPlayer* data);
@@ -82,96 +100,400 @@ DECLARE_CLASS_CODEGEN_INTERFACES(MultiplayerCore::Networking, MpPacketSerializer
     static const uint8_t ID = 100u;
 
     DECLARE_INSTANCE_FIELD_PRIVATE(GlobalNamespace::MultiplayerSessionManager*, _sessionManager);
+    DECLARE_INSTANCE_FIELD_PRIVATE(System::Action_1<GlobalNamespace::IConnectedPlayer*>*, _playerConnectedAction);
+    DECLARE_INSTANCE_FIELD_PRIVATE(System::Action_1<GlobalNamespace::IConnectedPlayer*>*, _playerDisconnectedAction);
+    DECLARE_INSTANCE_FIELD_PRIVATE(LiteNetLib::Utils::NetDataWriter*, _batchWriter);
+    DECLARE_INSTANCE_FIELD_PRIVATE(LiteNetLib::Utils::NetDataWriter*, _chunkWriter);
+    DECLARE_INSTANCE_FIELD_PRIVATE(LiteNetLib::Utils::NetDataWriter*, _scheduleWriter);
 
     DECLARE_CTOR(ctor, GlobalNamespace::IMultiplayerSessionManager* sessionManager);
 
     public:
         GlobalNamespace::INetworkPacketSubSerializer_1<GlobalNamespace::IConnectedPlayer*>* i_INetworkPacketSubSerializer_1_IConnectedPlayer() { return reinterpret_cast<GlobalNamespace::INetworkPacketSubSerializer_1<GlobalNamespace::IConnectedPlayer*>*>(this); }
         Zenject::IInitializable* i_IInitializable() { return reinterpret_cast<::Zenject::IInitializable*>(this); }
+        Zenject::ITickable* i_ITickable() { return reinterpret_cast<::Zenject::ITickable*>(this); }
         System::IDisposable* i_IDisposable() { return reinterpret_cast<::System::IDisposable*>(this); }
 
-        template<::MultiplayerCore::IPoolablePacket TPacket>
+        template<::MultiplayerCore::INetSerializable TPacket>
         requires(std::is_pointer_v<TPacket>)
-        static TPacket ObtainPacket() {
-            return GlobalNamespace::ThreadStaticPacketPool_1<TPacket>::get_pool()->Obtain();
-        }
+        static TPacket ObtainPacket() { return PacketDecoding::Obtain<TPacket>(); }
+
+        template<::MultiplayerCore::INetSerializable TPacket>
+        requires(std::is_pointer_v<TPacket>)
+        static TPacket DeserializePacket(LiteNetLib::Utils::NetDataReader* reader, int size) { return PacketDecoding::Decode<TPacket>(reader, size); }
 
+        /// @brief Name a packet type goes by on the wire, known at compile time for packets that DECLARE_PACKET_NAME and asked from il2cpp for any other
         template<::MultiplayerCore::INetSerializable TPacket>
-        requires(std::is_pointer_v<TPacket> && !::MultiplayerCore::IPoolablePacket<TPacket>)
-        static TPacket ObtainPacket() {
-            return il2cpp_utils::NewSpecific<TPacket>();
+        requires(std::is_pointer_v<TPacket>)
+        static std::string NameOfPacket() {
+            if constexpr (NamedPacket<TPacket>) return std::string(PacketNameOf<TPacket>);
+            else return std::string(csTypeOf(TPacket)->NameOrDefault);
         }
 
+        /// @brief Key handlers of a packet type are registered and dispatched by, see PacketKey
         template<::MultiplayerCore::INetSerializable TPacket>
         requires(std::is_pointer_v<TPacket>)
-        static TPacket DeserializePacket(LiteNetLib::Utils::NetDataReader* reader, int size) {
-            auto packet = ObtainPacket<TPacket>();
-            if (!packet) {
-                reader->SkipBytes(size);
-            } else packet->Deserialize(reader);
-            return packet;
+        static PacketKey KeyOfPacket() {
+            if constexpr (NamedPacket<TPacket>) return PacketKeyOf<TPacket>;
+            else return KeyOf(NameOfPacket<TPacket>());
         }
 
+        /// @return false if the name of TPacket has the same key as another registered packet name, the callback is not registered then
         template<::MultiplayerCore::INetSerializable TPacket>
         requires(std::is_pointer_v<TPacket>)
-        void RegisterCallback(std::function<void(TPacket)> callback) { RegisterCallback([callback](TPacket packet, GlobalNamespace::IConnectedPlayer* player){ callback(packet); }); }
+        bool RegisterCallback(std::function<void(TPacket)> callback) { return RegisterCallback([callback](TPacket packet, GlobalNamespace::IConnectedPlayer* player){ callback(packet); }); }
 
         template<::MultiplayerCore::INetSerializable TPacket>
         requires(std::is_pointer_v<TPacket>)
-        void RegisterCallback(std::function<void(TPacket, GlobalNamespace::IConnectedPlayer*)> callback) {
-            System::Type* packetType = csTypeOf(TPacket);
-            registeredTypes.emplace_back(reinterpret_cast<Il2CppReflectionType*>(packetType));
-            std::string packetId(packetType->NameOrDefault);
+        bool RegisterCallback(std::function<void(TPacket, GlobalNamespace::IConnectedPlayer*)> callback) {
+            auto packetName = NameOfPacket<TPacket>();
+            return RegisterHandler(classof(TPacket), reinterpret_cast<Il2CppReflectionType*>(csTypeOf(TPacket)), KeyOfPacket<TPacket>(), packetName, packetName,
+                [callback](LiteNetLib::Utils::NetDataReader* reader, int size, GlobalNamespace::IConnectedPlayer* player){
+                    PacketDecoding::Dispatch<TPacket>(callback, reader, size, player);
+                }
+            );
+        }
 
-            packetHandlers[packetId] = [callback](LiteNetLib::Utils::NetDataReader* reader, int size, GlobalNamespace::IConnectedPlayer* player){
-                callback(DeserializePacket<TPacket>(reader, size), player);
-            };
+        /// @brief Like RegisterCallback, but the packet goes back to its pool when the callback returns, the callback must copy what it keeps
+        /// @return false if the name of TPacket has the same key as another registered packet name, the callback is not registered then
+        template<::MultiplayerCore::INetSerializable TPacket>
+        requires(std::is_pointer_v<TPacket> && ::MultiplayerCore::MpPoolablePacket<TPacket>)
+        bool RegisterPooledCallback(std::function<void(TPacket, GlobalNamespace::IConnectedPlayer*)> callback) {
+            auto packetName = NameOfPacket<TPacket>();
+            return RegisterHandler(classof(TPacket), reinterpret_cast<Il2CppReflectionType*>(csTypeOf(TPacket)), KeyOfPacket<TPacket>(), packetName, packetName,
+                [callback](LiteNetLib::Utils::NetDataReader* reader, int size, GlobalNamespace::IConnectedPlayer* player){
+                    PacketDecoding::Dispatch<TPacket>(callback, reader, size, player, true);
+                }
+            );
         }
 
         template<::MultiplayerCore::INetSerializable TPacket>
         requires(std::is_pointer_v<TPacket>)
-        void RegisterCallback(const std::string& packetId, std::function<void(TPacket)> callback) { RegisterCallback(packetId, [callback](TPacket packet, GlobalNamespace::IConnectedPlayer* player){ callback(packet); }); }
+        bool RegisterCallback(const std::string& packetId, std::function<void(TPacket)> callback) { return RegisterCallback(packetId, [callback](TPacket packet, GlobalNamespace::IConnectedPlayer* player){ callback(packet); }); }
 
         template<::MultiplayerCore::INetSerializable TPacket>
         requires(std::is_pointer_v<TPacket>)
-        void RegisterCallback(const std::string& packetId, std::function<void(TPacket, GlobalNamespace::IConnectedPlayer*)> callback) {
-            Il2CppReflectionType* packetType = csTypeOf(TPacket);
-            registeredTypes.emplace_back(reinterpret_cast<Il2CppReflectionType*>(packetType));
+        bool RegisterCallback(const std::string& packetId, std::function<void(TPacket, GlobalNamespace::IConnectedPlayer*)> callback) {
+            // outgoing packets are always framed with their type name, so that's what peers need to know about
+            return RegisterHandler(classof(TPacket), reinterpret_cast<Il2CppReflectionType*>(csTypeOf(TPacket)), KeyOf(packetId), packetId, NameOfPacket<TPacket>(),
+                [callback](LiteNetLib::Utils::NetDataReader* reader, int size, GlobalNamespace::IConnectedPlayer* player){
+                    PacketDecoding::Dispatch<TPacket>(callback, reader, size, player);
+                }
+            );
+        }
+
+        /// @brief Like RegisterCallback, but work runs on a worker thread and apply gets its result on the main thread, hold il2cpp objects in TResult in a SafePtr
+        /// @return false if the name of TPacket has the same key as another registered packet name, the callback is not registered then
+        template<::MultiplayerCore::INetSerializable TPacket, typename TResult>
+        requires(std::is_pointer_v<TPacket>)
+        bool RegisterAsyncCallback(std::function<TResult(TPacket, GlobalNamespace::IConnectedPlayer*)> work, std::function<void(TResult, GlobalNamespace::IConnectedPlayer*)> apply) {
+            auto packetName = NameOfPacket<TPacket>();
+            return RegisterHandler(classof(TPacket), reinterpret_cast<Il2CppReflectionType*>(csTypeOf(TPacket)), KeyOfPacket<TPacket>(), packetName, packetName,
+                MakeAsyncHandler(KeyOfPacket<TPacket>(), &PacketDecoding::DecodeObject<TPacket>, PacketDecoding::MakeAsyncWork<TPacket, TResult>(std::move(work), std::move(apply)))
+            );
+        }
 
-            packetHandlers[packetId] = [callback](LiteNetLib::Utils::NetDataReader* reader, int size, GlobalNamespace::IConnectedPlayer* player){
-                callback(DeserializePacket<TPacket>(reader, size), player);
-            };
+        /// @brief run work on a worker thread, in order per strand, and apply with its result on the main thread
+        template<typename TResult>
+        void RunAsync(uint64_t strand, std::function<TResult()> work, std::function<void(TResult)> apply) {
+            PostWork(strand, [work = std::move(work), apply = std::move(apply)](){
+                try {
+                    RunOnMainThread([result = work(), apply](){ apply(result); });
+                } catch (const std::exception& e) {
+                    WARNING("An exception was thrown by background work: {}", e.what());
+                }
+            });
         }
 
+        /// @brief jobs of async callbacks and RunAsync waiting for a worker thread
+        std::size_t get_pendingAsyncWork() const { return workers.get_pending(); }
+
         template<::MultiplayerCore::INetSerializable TPacket>
         requires(std::is_pointer_v<TPacket>)
         void UnregisterCallback() {
-            System::Type* packetType = csTypeOf(TPacket);
-            std::string packetId(packetType->NameOrDefault);
-
-            std::erase(registeredTypes, reinterpret_cast<Il2CppReflectionType*>(packetType));
-            packetHandlers.erase(packetId);
+            registeredTypes.erase(reinterpret_cast<Il2CppReflectionType*>(csTypeOf(TPacket)));
+            packetHandlers.erase(KeyOfPacket<TPacket>());
+            DeactivateAsyncHandler(KeyOfPacket<TPacket>());
         }
 
         template<::MultiplayerCore::INetSerializable TPacket>
         requires(std::is_pointer_v<TPacket>)
         void Send(TPacket packet) {
-            /* TODO: try catch, logging? */
-            if (_sessionManager) {
-                _sessionManager->Send(packet->i_INetSerializable());
+            if (_sessionManager && !TrySendChunked(packet->i_INetSerializable(), nullptr) && !TryQueuePacket(packet->i_INetSerializable(), true)) {
+                Submit(packet->i_INetSerializable(), nullptr, true, PriorityOf(classof(TPacket)));
             }
         }
 
         template<::MultiplayerCore::INetSerializable TPacket>
         requires(std::is_pointer_v<TPacket>)
         void SendUnreliable(TPacket packet) {
-            /* TODO: try catch, logging? */
-            if (_sessionManager) {
-                _sessionManager->SendUnreliable(packet->i_INetSerializable());
+            if (_sessionManager && !TryQueuePacket(packet->i_INetSerializable(), false)) {
+                Submit(packet->i_INetSerializable(), nullptr, false, PriorityOf(classof(TPacket)));
             }
         }
 
+        /// @brief Send a packet to a single player instead of the whole lobby, never batched
+        template<::MultiplayerCore::INetSerializable TPacket>
+        requires(std::is_pointer_v<TPacket>)
+        void SendTo(GlobalNamespace::IConnectedPlayer* player, TPacket packet) {
+            if (_sessionManager && player && !TrySendChunked(packet->i_INetSerializable(), player)) {
+                Submit(packet->i_INetSerializable(), player, true, PriorityOf(classof(TPacket)));
+            }
+        }
+
+        /// @brief Send a packet to each of the given players
+        template<::MultiplayerCore::INetSerializable TPacket>
+        requires(std::is_pointer_v<TPacket>)
+        void SendToMany(std::span<GlobalNamespace::IConnectedPlayer* const> players, TPacket packet) {
+            if (!_sessionManager) return;
+            for (auto player : players)
+                if (player && !TrySendChunked(packet->i_INetSerializable(), player)) Submit(packet->i_INetSerializable(), player, true, PriorityOf(classof(TPacket)));
+        }
+
+        /// @brief Whether a player registered a handler for a packet type, only known once their packet registry arrived
+        template<::MultiplayerCore::INetSerializable TPacket>
+        requires(std::is_pointer_v<TPacket>)
+        bool PlayerHandles(GlobalNamespace::IConnectedPlayer* player) const {
+            return PlayerHandles(player, KeyOfPacket<TPacket>());
+        }
+        bool PlayerHandles(GlobalNamespace::IConnectedPlayer* player, PacketKey packetKey) const;
+        bool PlayerHandles(GlobalNamespace::IConnectedPlayer* player, std::string_view packetName) const { return PlayerHandles(player, KeyOf(packetName)); }
+
+        /// @brief Send packet to the players that handle its type and fallback to everyone else
+        template<::MultiplayerCore::INetSerializable TPacket, ::MultiplayerCore::INetSerializable TFallback>
+        requires(std::is_pointer_v<TPacket> && std::is_pointer_v<TFallback>)
+        void SendWithFallback(TPacket packet, TFallback fallback) {
+            if (!_sessionManager) return;
+            SendWithFallback(KeyOfPacket<TPacket>(), packet->i_INetSerializable(), fallback->i_INetSerializable());
+        }
+
+        /// @brief Opt-in batching of packets sent within one batch window, only used while every connected player supports batches
+        void set_batchingEnabled(bool value);
+        bool get_batchingEnabled() const;
+
+        /// @brief How long a packet may wait for more packets to batch with, 0 sends a batch every frame
+        void set_batchWindow(std::chrono::milliseconds value);
+        std::chrono::milliseconds get_batchWindow() const;
+
+        /// @brief Mark a packet type as latest-value-wins, a queued packet of this type gets replaced instead of sent twice
+        template<::MultiplayerCore::INetSerializable TPacket>
+        requires(std::is_pointer_v<TPacket>)
+        void SetCoalescing(bool coalesce = true) { SetCoalescing(classof(TPacket), coalesce); }
+
+        /// @brief Send everything that is currently queued
+        void FlushBatches();
+
+        /// @brief Opt-in payload caching for a packet type, the payload is reused when the same instance is sent again until InvalidateCachedPayload
+        template<::MultiplayerCore::INetSerializable TPacket>
+        requires(std::is_pointer_v<TPacket>)
+        void SetPayloadCaching(bool cache = true) { SetPayloadCaching(classof(TPacket), cache); }
+
+        /// @brief Drop the cached payload of a packet, call this when changing a packet after it was sent
+        void InvalidateCachedPayload(LiteNetLib::Utils::INetSerializable* packet);
+
+        struct PayloadCacheStats {
+            uint64_t hits;
+            uint64_t misses;
+        };
+        PayloadCacheStats get_payloadCacheStats() const;
+
+        /// @brief Opt-in chunking for a packet type, large reliable sends of it go out a few chunks per Tick
+        template<::MultiplayerCore::INetSerializable TPacket>
+        requires(std::is_pointer_v<TPacket>)
+        void SetChunking(bool chunk = true) { SetChunking(classof(TPacket), chunk); }
+
+        /// @brief Opt-in LZ4 compression of payloads of at least compressionThreshold bytes of a packet type, for players that know our packet registry
+        template<::MultiplayerCore::INetSerializable TPacket>
+        requires(std::is_pointer_v<TPacket>)
+        void SetCompression(bool compress = true) { SetCompression(classof(TPacket), compress); }
+
+        void set_compressionThreshold(std::size_t value);
+        std::size_t get_compressionThreshold() const;
+
+        /// @brief Limit the decompressed payload size of a packet type and how many of them a single player may send per second, 0 is unlimited
+        template<::MultiplayerCore::INetSerializable TPacket>
+        requires(std::is_pointer_v<TPacket>)
+        void SetDecodeBudget(uint32_t maxBytes, uint32_t maxPerSecond) {
+            decodeBudget.SetPacketLimits(NameOfPacket<TPacket>(), { maxBytes, maxPerSecond });
+        }
+
+        /// @brief How many packets of any type a single player may send per second before the rest are dropped, 0 is unlimited
+        void set_senderPacketsPerSecond(uint32_t value);
+        uint32_t get_senderPacketsPerSecond() const;
+
+        /// @brief Per packet type and per sender counters, safe to read from any thread
+        const PacketMetrics& get_metrics() const { return *metrics; }
+
+        /// @brief Append a json snapshot of the metrics to path every interval, an interval of 0 stops dumping
+        void SetMetricsDump(std::string path, std::chrono::seconds interval);
+
+        /// @brief Record every packet sent and received into a capture at path, see PacketCaptureFormat
+        /// @return false if path could not be opened
+        bool StartCapture(const std::string& path);
+        void StopCapture();
+        bool get_capturing() const { return capture.get_active(); }
+
+        /// @brief Opt-in send scheduling, at most bytesPerFrame bytes go out per Tick, most urgent first. 0 sends right away
+        void set_sendBudget(std::size_t bytesPerFrame);
+        std::size_t get_sendBudget() const;
+
+        /// @brief Priority of a packet type in the send queue, Normal unless set otherwise
+        template<::MultiplayerCore::INetSerializable TPacket>
+        requires(std::is_pointer_v<TPacket>)
+        void SetPriority(PacketPriority priority) { SetPriority(classof(TPacket), priority); }
+
+        using SendQueueStats = SendScheduler<GlobalNamespace::IConnectedPlayer*>::QueueStats;
+        /// @brief Depth and waiting times of the send queue of a priority, safe to call from any thread
+        SendQueueStats get_sendQueueStats(PacketPriority priority) const;
+
+        /// @brief The channel called name, created on first use, see MpPacketChannel
+        /// @return nullptr if name is empty or contains MpPacketChannel::Separator
+        MpPacketChannel* GetChannel(std::string_view name);
+
     private:
-        std::list<Il2CppReflectionType*> registeredTypes;
-        std::map<std::string, PacketHandler> packetHandlers;
+        /// @brief handler for RegisterAsyncCallback, results of packets that arrived before the callback was unregistered are dropped
+        PacketHandler MakeAsyncHandler(PacketKey packetKey, PacketDecoding::Decoder decode, PacketDecoding::AsyncWork work);
+        std::shared_ptr<std::atomic<bool>> ActivateAsyncHandler(PacketKey packetKey);
+        void DeactivateAsyncHandler(PacketKey packetKey);
+        /// @brief packets of one type from one player share a strand, so they are worked on in order
+        static uint64_t AsyncStrand(PacketKey packetKey, GlobalNamespace::IConnectedPlayer* player) { return packetKey ^ (reinterpret_cast<uintptr_t>(player) * 0x9e3779b97f4a7c15ull); }
+        void PostWork(uint64_t strand, std::function<void()> job);
+        static void RunOnMainThread(std::function<void()> action);
+
+        static constexpr std::size_t AsyncWorkerCount = 2;
+        // il2cpp_aware_thread attaches the workers, they touch managed objects
+        Utils::WorkerPool<il2cpp_utils::il2cpp_aware_thread> workers{AsyncWorkerCount};
+        std::mutex asyncHandlerMutex;
+        // cleared when a callback is unregistered, so work that is still in flight doesn't reach its owner anymore
+        std::unordered_map<PacketKey, std::shared_ptr<std::atomic<bool>>> asyncHandlers;
+
+        friend class MpPacketChannel;
+        // the receive side, shared with the host build
+        friend struct PacketDispatch;
+
+        RegisteredTypeSet<Il2CppReflectionType> registeredTypes;
+        PacketHandlerTable<PacketHandler> packetHandlers;
+
+        /// @brief registers handler under handlerKey, the key of handlerName, and packetName as the name packets of packetClass go out as
+        /// @return false, with an error logged, if a different name is already registered under handlerKey
+        bool RegisterHandler(Il2CppClass* packetClass, Il2CppReflectionType* packetType, PacketKey handlerKey, std::string_view handlerName, const std::string& packetName, PacketHandler handler);
+        /// @brief assigns the next compact id to a packet class if it does not have one yet, ids are never reused
+        void RegisterPacketId(Il2CppClass* packetClass, const std::string& packetName);
+        void SendPacketRegistry();
+        void UpdateCompactPacketIdLimit();
+
+        /// @brief the clock of the decode budgets and chunked transfers, for PacketDispatch
+        std::chrono::steady_clock::time_point Now() const { return std::chrono::steady_clock::now(); }
+        /// @brief calls fn(span, reader) with a managed buffer of length bytes and a reader over it, for PacketDispatch
+        template<typename TFunc>
+        void WithBuffer(std::size_t length, TFunc&& fn) {
+            ArrayW<uint8_t> buffer(il2cpp_array_size_t(length));
+            fn(std::span<uint8_t>(buffer.begin(), length), LiteNetLib::Utils::NetDataReader::New_ctor(buffer));
+        }
+        /// @brief logs a packet that could not be read or whose handler threw
+        void OnPacketError(GlobalNamespace::IConnectedPlayer* player, std::string_view packetId, const std::exception& e);
+        /// @brief packets of a channel count against the sender limit of their channel instead of ours
+        bool HasOwnSenderBudget(PacketKey packetKey) const { return channelPackets.contains(packetKey); }
+
+        DecodeBudget<GlobalNamespace::IConnectedPlayer*> decodeBudget;
+
+        void HandlePlayerConnected(GlobalNamespace::IConnectedPlayer* player);
+        void HandlePlayerDisconnected(GlobalNamespace::IConnectedPlayer* player);
+        void HandlePacketRegistry(Packets::MpPacketRegistryPacket* packet, GlobalNamespace::IConnectedPlayer* player);
+        void HandlePacketRegistryAck(Packets::MpPacketRegistryAckPacket* packet, GlobalNamespace::IConnectedPlayer* player);
+
+        // our own compact ids, the ones peers sent us and what they acknowledged of ours
+        PacketRegistry<Il2CppClass*, GlobalNamespace::IConnectedPlayer*> packetRegistry;
+
+        /// @return the channel packets of packetClass are sent on, nullptr for packets of no channel
+        MpPacketChannel* ChannelOf(Il2CppClass* packetClass) const;
+        /// @brief packets of packetClass go out as wireName from now on
+        /// @return false, with an error logged, if packetClass is already registered under another name
+        bool AssignChannel(Il2CppClass* packetClass, MpPacketChannel* channel, const std::string& wireName);
+
+        // shared_ptr, so this header doesn't need the channel to be complete
+        std::vector<std::shared_ptr<MpPacketChannel>> channels;
+        std::unordered_map<Il2CppClass*, MpPacketChannel*> channelTypes;
+        // wire names of the packets channels handle
+        PacketHandlerTable<MpPacketChannel*> channelPackets;
+
+        /// @brief serializes the packet into the batch for its channel
+        /// @return false if the packet should be sent on its own instead
+        bool TryQueuePacket(LiteNetLib::Utils::INetSerializable* packet, bool reliable);
+        void SetCoalescing(Il2CppClass* packetClass, bool coalesce);
+        void SetPayloadCaching(Il2CppClass* packetClass, bool cache);
+        /// @brief writes the packet body, from the payload cache if possible
+        void SerializePayload(LiteNetLib::Utils::NetDataWriter* writer, LiteNetLib::Utils::INetSerializable* packet);
+        /// @brief per connection send, framed for what that specific player knows about our registry
+        void SendWithFallback(PacketKey packetKey, LiteNetLib::Utils::INetSerializable* packet, LiteNetLib::Utils::INetSerializable* fallback);
+        void SendToPlayer(LiteNetLib::Utils::INetSerializable* packet, GlobalNamespace::IConnectedPlayer* player);
+
+        /// @brief hands a packet to the session manager, through the send queue when there is a send budget. A null target is the whole lobby
+        void Submit(LiteNetLib::Utils::INetSerializable* packet, GlobalNamespace::IConnectedPlayer* target, bool reliable, PacketPriority priority);
+        void SendImmediately(LiteNetLib::Utils::INetSerializable* packet, GlobalNamespace::IConnectedPlayer* target, bool reliable);
+        /// @brief sends this frame's share of the send queue
+        void DrainSendQueue();
+        void SetPriority(Il2CppClass* packetClass, PacketPriority priority);
+        PacketPriority PriorityOf(Il2CppClass* packetClass) const;
+
+        std::unordered_map<Il2CppClass*, PacketPriority> packetPriorities;
+        mutable std::mutex sendQueueMutex;
+        SendScheduler<GlobalNamespace::IConnectedPlayer*> sendScheduler;
+        std::atomic<std::size_t> sendBudget = 0;
+
+        // queued packets and outgoing chunked transfers, defined where they are used
+        struct Batches;
+        struct Transfers;
+        std::shared_ptr<Batches> batches;
+        std::shared_ptr<Transfers> transfers;
+
+        struct CachedPayload {
+            // keeping the packet alive also keeps its address from being reused by another packet
+            SafePtr<System::Object> packet;
+            SafePtr<Array<uint8_t>> bytes;
+        };
+
+        static constexpr std::size_t MaxCachedPayloads = 16;
+
+        std::unordered_set<Il2CppClass*> cachedPayloadTypes;
+        // least recently used first
+        std::vector<CachedPayload> payloadCache;
+        std::mutex payloadCacheMutex;
+        std::atomic<uint64_t> payloadCacheHits = 0;
+        std::atomic<uint64_t> payloadCacheMisses = 0;
+
+        static constexpr std::size_t DefaultCompressionThreshold = 256;
+
+        void SetCompression(Il2CppClass* packetClass, bool compress);
+        /// @brief replaces the payload that was just written with its compressed form if that is smaller, and updates the frame flag to match
+        void CompressPayload(LiteNetLib::Utils::NetDataWriter* writer, int flagPosition, int payloadStart);
+
+        std::unordered_set<Il2CppClass*> compressedTypes;
+        std::atomic<std::size_t> compressionThreshold = DefaultCompressionThreshold;
+
+        void SetChunking(Il2CppClass* packetClass, bool chunk);
+        /// @brief queue packet as a chunked transfer if its type is chunked and it is large enough
+        /// @return whether the packet was queued, if not it should be sent normally
+        bool TrySendChunked(LiteNetLib::Utils::INetSerializable* packet, GlobalNamespace::IConnectedPlayer* target);
+        void ExpireIncomingTransfers();
+
+        ChunkReassembler<GlobalNamespace::IConnectedPlayer*> incomingTransfers;
+
+        SenderMetrics* GetSenderMetrics(GlobalNamespace::IConnectedPlayer* player);
+        /// @brief frees the sender entry of a player that left, so players coming and going in a long session don't fill the table
+        static void RemoveSenderMetrics(PacketMetrics& metrics, GlobalNamespace::IConnectedPlayer* player);
+        void DumpMetrics();
+
+        std::unique_ptr<PacketMetrics> metrics = std::make_unique<PacketMetrics>();
+        std::unordered_map<GlobalNamespace::IConnectedPlayer*, SenderMetrics*> senderMetrics;
+        std::string metricsDumpPath;
+        std::chrono::seconds metricsDumpInterval{0};
+        std::chrono::steady_clock::time_point lastMetricsDump;
+
+        void CapturePacket(CapturedPacket::Direction direction, GlobalNamespace::IConnectedPlayer* peer, std::string_view packetName, uint8_t frameFlags, std::span<const uint8_t> payload);
+
+        PacketCaptureWriter capture;
+        // not captured themselves, the frames in them are
+        std::string batchPacketName;
+        std::string chunkPacketName;
 )
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "../_config.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <fstream>
+#include <istream>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace MultiplayerCore::Networking {
+    /// @brief one packet out of a capture
+    struct CapturedPacket {
+        enum class Direction : uint8_t {
+            Inbound,
+            Outbound
+        };
+
+        Direction direction;
+        /// @brief time since the capture started
+        std::chrono::microseconds time;
+        /// @brief user id of the sender of inbound packets, of the target of outbound ones, empty for packets sent to the whole lobby
+        std::string_view peer;
+        std::string_view packetName;
+        /// @brief PacketFraming flags of the frame, the payload is still compressed if they say so
+        uint8_t frameFlags;
+        std::vector<uint8_t> payload;
+    };
+
+    /// @brief binary log of MpCore packets, written by the capture mode of MpPacketSerializer and read by mpcore-replay.
+    /// Magic and version, then records starting with their kind:
+    ///   Name:               varint length, bytes. Peers and packet names refer to these by index, in the order they were written
+    ///   Inbound / Outbound: varint microseconds since the previous packet, varint peer, varint packet name, frame flags, varint length, payload
+    struct PacketCaptureFormat {
+        static constexpr std::array<uint8_t, 4> Magic = { 'M', 'P', 'C', 'P' };
+        static constexpr uint8_t Version = 1;
+
+        enum RecordKind : uint8_t {
+            Name,
+            Inbound,
+            Outbound
+        };
+    };
+
+    class MPCORE_EXPORT PacketCaptureWriter {
+        public:
+            /// @brief start a new capture at path, replacing the one that is running
+            /// @param now what packet times are measured from, the host tools pass their simulated time
+            /// @return false if the file could not be opened
+            bool Start(const std::string& path, std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now());
+            void Stop();
+            bool get_active() const { return active.load(std::memory_order_relaxed); }
+
+            /// @brief append a packet, safe to call from any thread
+            void Record(CapturedPacket::Direction direction, std::string_view peer, std::string_view packetName, uint8_t frameFlags, std::span<const uint8_t> payload,
+                        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now());
+            /// @brief write out what was recorded since the last flush
+            void Flush();
+
+        private:
+            struct StringHash {
+                using is_transparent = void;
+                std::size_t operator()(std::string_view value) const { return std::hash<std::string_view>()(value); }
+            };
+
+            /// @brief index of value in the string table, writing a name record for it first if it's new
+            uint32_t Intern(std::string_view value);
+
+            std::atomic<bool> active = false;
+            std::mutex mutex;
+            std::ofstream out;
+            bool dirty = false;
+            std::vector<uint8_t> record;
+            std::unordered_map<std::string, uint32_t, StringHash, std::equal_to<>> strings;
+            std::chrono::steady_clock::time_point lastPacket;
+    };
+
+    class MPCORE_EXPORT PacketCaptureReader {
+        public:
+            /// @brief throws std::runtime_error if in doesn't start with a capture this version can read
+            explicit PacketCaptureReader(std::istream& in);
+
+            /// @brief read the next packet, the names it points to stay valid as long as the reader
+            /// @return false at the end of the capture, throws std::runtime_error if it ends within a record
+            bool Next(CapturedPacket& packet);
+
+            /// @brief next byte of the capture, throws std::runtime_error at its end
+            uint8_t GetByte();
+
+        private:
+            std::istream& in;
+            // deque, so views of the strings stay valid while more get added
+            std::deque<std::string> strings;
+            std::chrono::microseconds time{0};
+    };
+}
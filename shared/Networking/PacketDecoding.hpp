@@ -0,0 +1,105 @@
+#pragma once
+
+#include "GlobalNamespace/IConnectedPlayer.hpp"
+#include "GlobalNamespace/IPoolablePacket.hpp"
+#include "GlobalNamespace/ThreadStaticPacketPool_1.hpp"
+#include "LiteNetLib/Utils/INetSerializable.hpp"
+#include "LiteNetLib/Utils/NetDataReader.hpp"
+#include "System/Object.hpp"
+#include "Abstractions/MpPoolablePacket.hpp"
+
+#include <functional>
+#include <type_traits>
+
+namespace MultiplayerCore {
+    template<typename TPacket>
+    concept INetSerializable = requires(TPacket t) {
+        {t->i_INetSerializable()} -> std::same_as<LiteNetLib::Utils::INetSerializable*>;
+    };
+
+    template<typename TPacket>
+    concept IPoolablePacket = INetSerializable<TPacket> && requires(TPacket t) {
+        {t->i_IPoolablePacket()} -> std::same_as<GlobalNamespace::IPoolablePacket*>;
+        {GlobalNamespace::ThreadStaticPacketPool_1<TPacket>::get_pool()->Obtain()} -> std::same_as<TPacket>;
+    };
+
+    template<typename TPacket>
+    concept MpPoolablePacket = INetSerializable<TPacket> && std::is_base_of_v<Networking::Abstractions::MpPoolablePacket, std::remove_pointer_t<TPacket>>;
+}
+
+// how MpPacketSerializer and MpPacketChannel decode packets for their handlers, templates they instantiate in mods registering callbacks
+namespace MultiplayerCore::Networking::PacketDecoding {
+    /// @brief instance to deserialize a received packet into, from its pool if it has one
+    template<::MultiplayerCore::MpPoolablePacket TPacket>
+    requires(std::is_pointer_v<TPacket>)
+    TPacket Obtain() {
+        return Abstractions::MpPacketPool::Obtain<TPacket>();
+    }
+
+    template<::MultiplayerCore::IPoolablePacket TPacket>
+    requires(std::is_pointer_v<TPacket> && !::MultiplayerCore::MpPoolablePacket<TPacket>)
+    TPacket Obtain() {
+        return GlobalNamespace::ThreadStaticPacketPool_1<TPacket>::get_pool()->Obtain();
+    }
+
+    template<::MultiplayerCore::INetSerializable TPacket>
+    requires(std::is_pointer_v<TPacket> && !::MultiplayerCore::IPoolablePacket<TPacket> && !::MultiplayerCore::MpPoolablePacket<TPacket>)
+    TPacket Obtain() {
+        return il2cpp_utils::NewSpecific<TPacket>();
+    }
+
+    /// @return the packet, or nullptr with its bytes skipped if there was no instance to read it into
+    template<::MultiplayerCore::INetSerializable TPacket>
+    requires(std::is_pointer_v<TPacket>)
+    TPacket Decode(LiteNetLib::Utils::NetDataReader* reader, int size) {
+        auto packet = Obtain<TPacket>();
+        if (!packet) {
+            reader->SkipBytes(size);
+        } else packet->Deserialize(reader);
+        return packet;
+    }
+
+    /// @brief decode and hand the packet to the callback. With pooled, an MpPoolablePacket goes back to its pool once the callback returns, otherwise the callback owns it.
+    /// It goes back when decoding throws either way, a packet going over its decode limits shouldn't cost us a pooled instance
+    template<::MultiplayerCore::INetSerializable TPacket>
+    requires(std::is_pointer_v<TPacket>)
+    void Dispatch(const std::function<void(TPacket, GlobalNamespace::IConnectedPlayer*)>& callback, LiteNetLib::Utils::NetDataReader* reader, int size, GlobalNamespace::IConnectedPlayer* player, bool pooled = false) {
+        auto packet = Obtain<TPacket>();
+        if (!packet) {
+            reader->SkipBytes(size);
+        } else {
+            try {
+                packet->Deserialize(reader);
+            } catch (...) {
+                if constexpr (::MultiplayerCore::MpPoolablePacket<TPacket>) packet->Release();
+                throw;
+            }
+            if constexpr (::MultiplayerCore::MpPoolablePacket<TPacket>) {
+                if (!pooled) packet->Retain();
+            }
+        }
+        callback(packet, player);
+        if constexpr (::MultiplayerCore::MpPoolablePacket<TPacket>) {
+            if (packet && pooled) packet->Release();
+        }
+    }
+
+    /// @brief the typed halves of an async callback, erased so the serializer can run them without being a template itself
+    using Decoder = System::Object* (*)(LiteNetLib::Utils::NetDataReader* reader, int size);
+    /// @brief runs on a worker thread, returns what to run on the main thread
+    using AsyncWork = std::function<std::function<void()>(System::Object* packet, GlobalNamespace::IConnectedPlayer* player)>;
+
+    template<::MultiplayerCore::INetSerializable TPacket>
+    requires(std::is_pointer_v<TPacket>)
+    System::Object* DecodeObject(LiteNetLib::Utils::NetDataReader* reader, int size) {
+        return reinterpret_cast<System::Object*>(Decode<TPacket>(reader, size));
+    }
+
+    template<::MultiplayerCore::INetSerializable TPacket, typename TResult>
+    requires(std::is_pointer_v<TPacket>)
+    AsyncWork MakeAsyncWork(std::function<TResult(TPacket, GlobalNamespace::IConnectedPlayer*)> work, std::function<void(TResult, GlobalNamespace::IConnectedPlayer*)> apply) {
+        return [work = std::move(work), apply = std::move(apply)](System::Object* packet, GlobalNamespace::IConnectedPlayer* player) -> std::function<void()> {
+            return [apply, player, result = work(reinterpret_cast<TPacket>(packet), player)](){ apply(result, player); };
+        };
+    }
+}
@@ -0,0 +1,139 @@
+#pragma once
+
+#include "PacketKey.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace MultiplayerCore::Networking {
+    /// @brief open addressing (linear probing) map from packet key to handler.
+    /// Lookups only compare keys, names are kept so that two names hashing to the same key are caught when they are registered instead of
+    /// one of them silently getting the other's packets. Lookups by name hash it straight out of the reader buffer without building a string
+    template<typename THandler>
+    class PacketHandlerTable {
+        public:
+            static constexpr PacketKey Hash(std::string_view name) { return KeyOf(name); }
+
+            /// @brief find the handler registered for key
+            /// @return pointer to the handler, or nullptr if there is none
+            THandler* find(PacketKey key) {
+                auto slot = findSlot(key);
+                return slot ? &slot->value : nullptr;
+            }
+
+            const THandler* find(PacketKey key) const { return const_cast<PacketHandlerTable*>(this)->find(key); }
+            THandler* find(std::string_view name) { return find(Hash(name)); }
+            const THandler* find(std::string_view name) const { return find(Hash(name)); }
+
+            bool contains(PacketKey key) const { return find(key) != nullptr; }
+            bool contains(std::string_view name) const { return find(name) != nullptr; }
+
+            /// @return the name registered under key, empty if there is none
+            std::string_view nameOf(PacketKey key) const {
+                auto slot = const_cast<PacketHandlerTable*>(this)->findSlot(key);
+                return slot ? std::string_view(slot->name) : std::string_view();
+            }
+
+            /// @brief insert or overwrite the handler for name
+            /// @return false if a different name with the same key is already registered, which keeps its handler
+            bool set(std::string_view name, THandler value) { return set(Hash(name), name, std::move(value)); }
+
+            /// @brief set with a key computed ahead of time, which has to be the Hash of name
+            bool set(PacketKey key, std::string_view name, THandler value) {
+                if (auto existing = findSlot(key)) {
+                    if (existing->name != name) return false;
+                    existing->value = std::move(value);
+                    return true;
+                }
+
+                // keep load (including tombstones) at or below one half so probe chains stay short
+                if ((used + 1) * 2 > slots.size()) rehash(std::max<std::size_t>(8, (count + 1) * 4));
+
+                auto mask = slots.size() - 1;
+                for (auto i = key & mask;; i = (i + 1) & mask) {
+                    auto& slot = slots[i];
+                    if (slot.state == SlotState::Full) continue;
+                    if (slot.state == SlotState::Empty) used++;
+                    slot.state = SlotState::Full;
+                    slot.key = key;
+                    slot.name = name;
+                    slot.value = std::move(value);
+                    count++;
+                    return true;
+                }
+            }
+
+            /// @brief remove the handler for key
+            /// @return whether a handler was removed
+            bool erase(PacketKey key) {
+                auto slot = findSlot(key);
+                if (!slot) return false;
+                slot->state = SlotState::Deleted;
+                slot->name.clear();
+                slot->value = THandler();
+                count--;
+                return true;
+            }
+
+            bool erase(std::string_view name) { return erase(Hash(name)); }
+
+            void clear() {
+                slots.clear();
+                count = 0;
+                used = 0;
+            }
+
+            std::size_t size() const { return count; }
+            bool empty() const { return count == 0; }
+
+        private:
+            enum class SlotState : uint8_t { Empty, Full, Deleted };
+            struct Slot {
+                SlotState state = SlotState::Empty;
+                PacketKey key = 0;
+                std::string name;
+                THandler value;
+            };
+
+            Slot* findSlot(PacketKey key) {
+                if (slots.empty()) return nullptr;
+                auto mask = slots.size() - 1;
+                for (auto i = key & mask;; i = (i + 1) & mask) {
+                    auto& slot = slots[i];
+                    if (slot.state == SlotState::Empty) return nullptr;
+                    if (slot.state == SlotState::Full && slot.key == key) return &slot;
+                }
+            }
+
+            void rehash(std::size_t minCapacity) {
+                std::size_t capacity = 8;
+                while (capacity < minCapacity) capacity <<= 1;
+
+                auto old = std::exchange(slots, std::vector<Slot>(capacity));
+                count = 0;
+                used = 0;
+                auto mask = capacity - 1;
+                for (auto& slot : old) {
+                    if (slot.state != SlotState::Full) continue;
+                    for (auto i = slot.key & mask;; i = (i + 1) & mask) {
+                        if (slots[i].state != SlotState::Empty) continue;
+                        slots[i] = std::move(slot);
+                        count++;
+                        used++;
+                        break;
+                    }
+                }
+            }
+
+            std::vector<Slot> slots;
+            // live entries
+            std::size_t count = 0;
+            // live entries + tombstones
+            std::size_t used = 0;
+    };
+}
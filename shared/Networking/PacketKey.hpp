@@ -0,0 +1,38 @@
+#pragma once
+
+#include "../Utils/Hash.hpp"
+
+#include <concepts>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+/// @brief declares the name a custom-types packet class goes by on the wire, which is its C# type name, so the class name given to DECLARE_CLASS_CUSTOM.
+/// Put it in the class body, packets declaring their name are registered and dispatched without asking il2cpp for the name:
+///   DECLARE_PACKET_NAME(MpBeatmapPacket);
+#define DECLARE_PACKET_NAME(name_)                                  \
+    public:                                                         \
+        using PacketNameOwner = name_;                              \
+        static constexpr std::string_view PacketName = #name_
+
+namespace MultiplayerCore::Networking {
+    /// @brief 64 bit FNV-1a of a packet name, what MpPacketSerializer registers and dispatches handlers by.
+    /// Stable across builds and platforms, so mods can compute the keys of any packet from its name
+    using PacketKey = uint64_t;
+
+    constexpr PacketKey KeyOf(std::string_view packetName) { return Utils::Fnv1a64(packetName); }
+
+    /// @brief packet types that declared their name with DECLARE_PACKET_NAME.
+    /// Derived packets go by a name of their own, so the name a base class declared doesn't count for them
+    template<typename TPacket>
+    concept NamedPacket = requires {
+        typename std::remove_pointer_t<TPacket>::PacketNameOwner;
+        { std::remove_pointer_t<TPacket>::PacketName } -> std::convertible_to<std::string_view>;
+    } && std::same_as<typename std::remove_pointer_t<TPacket>::PacketNameOwner, std::remove_pointer_t<TPacket>>;
+
+    template<NamedPacket TPacket>
+    inline constexpr std::string_view PacketNameOf = std::remove_pointer_t<TPacket>::PacketName;
+
+    template<NamedPacket TPacket>
+    inline constexpr PacketKey PacketKeyOf = KeyOf(PacketNameOf<TPacket>);
+}
@@ -0,0 +1,217 @@
+#pragma once
+
+#include "../_config.h"
+#include "../Utils/Hash.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <ostream>
+#include <string_view>
+#include <utility>
+
+namespace MultiplayerCore::Networking {
+    /// @brief histogram with power of two buckets, bucket i counts values in [2^i, 2^(i+1)), 0 goes in bucket 0 and the last bucket takes everything above
+    struct LatencyHistogram {
+        static constexpr std::size_t BucketCount = 24;
+
+        static constexpr std::size_t BucketFor(uint64_t value) {
+            return std::min<std::size_t>(std::bit_width(value | 1) - 1, BucketCount - 1);
+        }
+
+        /// @brief smallest value that lands in bucket
+        static constexpr uint64_t BucketStart(std::size_t bucket) { return bucket == 0 ? 0 : uint64_t(1) << bucket; }
+
+        void Record(uint64_t value) { buckets[BucketFor(value)].fetch_add(1, std::memory_order_relaxed); }
+
+        uint64_t Count(std::size_t bucket) const { return buckets[bucket].load(std::memory_order_relaxed); }
+
+        /// @brief upper bound of the bucket the given fraction (0..1) of recorded values falls into, 0 when nothing was recorded
+        uint64_t Percentile(double fraction) const {
+            uint64_t total = 0;
+            for (auto& bucket : buckets) total += bucket.load(std::memory_order_relaxed);
+            if (total == 0) return 0;
+
+            auto target = std::max<uint64_t>(1, static_cast<uint64_t>(fraction * total));
+            uint64_t seen = 0;
+            for (std::size_t i = 0; i < BucketCount; i++) {
+                seen += buckets[i].load(std::memory_order_relaxed);
+                if (seen >= target) return (uint64_t(1) << (i + 1)) - 1;
+            }
+            return (uint64_t(1) << BucketCount) - 1;
+        }
+
+        std::array<std::atomic<uint64_t>, BucketCount> buckets{};
+    };
+
+    struct PacketTypeMetrics {
+        std::atomic<uint64_t> sentCount = 0;
+        std::atomic<uint64_t> sentBytes = 0;
+        std::atomic<uint64_t> receivedCount = 0;
+        std::atomic<uint64_t> receivedBytes = 0;
+        /// @brief received packets that went over a decode limit or budget and were never handled
+        std::atomic<uint64_t> droppedCount = 0;
+        /// @brief time spent in the handler, in microseconds
+        LatencyHistogram handlerMicros;
+    };
+
+    struct SenderMetrics {
+        std::atomic<uint64_t> receivedCount = 0;
+        std::atomic<uint64_t> receivedBytes = 0;
+        std::atomic<uint64_t> droppedCount = 0;
+    };
+
+    /// @brief fixed capacity map from name to metrics entry, entries are created on first use and stay until they are removed.
+    /// Lookups and inserts are lock free, so any thread can record into it while another one reads it
+    template<typename TEntry, std::size_t Capacity>
+    class MetricsTable {
+        static_assert(std::has_single_bit(Capacity), "Capacity has to be a power of two");
+        public:
+            static constexpr std::size_t MaxNameLength = 63;
+
+            /// @brief entry for name, created if it doesn't exist yet
+            /// @return the entry, or nullptr when the table is full
+            TEntry* get(std::string_view name) {
+                auto hash = Utils::Fnv1a64(name) | 1;
+                auto mask = Capacity - 1;
+                Slot* removed = nullptr;
+                for (std::size_t i = hash & mask, probes = 0; probes < Capacity; i = (i + 1) & mask, probes++) {
+                    auto& slot = slots[i];
+                    auto current = slot.hash.load(std::memory_order_acquire);
+                    if (current == hash) return &slot.entry;
+                    if (current == Removed && !removed) removed = &slot;
+                    if (current != Free) continue;
+
+                    // not in the table, a removed slot on the way is reused before a free one
+                    if (removed && Claim(*removed, Removed, hash, name)) return &removed->entry;
+                    uint64_t expected = Free;
+                    if (Claim(slot, expected, hash, name)) return &slot.entry;
+                    // somebody else claimed it first, maybe for the same name
+                    if (slot.hash.load(std::memory_order_acquire) == hash) return &slot.entry;
+                }
+                if (removed && Claim(*removed, Removed, hash, name)) return &removed->entry;
+                return nullptr;
+            }
+
+            /// @brief frees the slot of name for another name, its counters start over if name comes back.
+            /// A pointer to the entry that is still held keeps counting into whatever gets the slot next, drop it first
+            void remove(std::string_view name) {
+                auto hash = Utils::Fnv1a64(name) | 1;
+                auto mask = Capacity - 1;
+                for (std::size_t i = hash & mask, probes = 0; probes < Capacity; i = (i + 1) & mask, probes++) {
+                    auto& slot = slots[i];
+                    auto current = slot.hash.load(std::memory_order_acquire);
+                    if (current == Free) return;
+                    if (current != hash) continue;
+
+                    slot.named.store(false, std::memory_order_release);
+                    slot.hash.store(Removed, std::memory_order_release);
+                    return;
+                }
+            }
+
+            /// @brief call fn(std::string_view name, const TEntry& entry) for every named entry
+            template<typename TFunc>
+            void forEach(TFunc&& fn) const {
+                for (auto& slot : slots) {
+                    if (!slot.named.load(std::memory_order_acquire)) continue;
+                    fn(std::string_view(slot.name.data()), slot.entry);
+                }
+            }
+
+        private:
+            struct Slot {
+                std::atomic<uint64_t> hash = 0;
+                std::atomic<bool> named = false;
+                std::array<char, MaxNameLength + 1> name{};
+                TEntry entry;
+            };
+            // names hash to odd values, so neither of these is ever the hash of a name
+            static constexpr uint64_t Free = 0;
+            static constexpr uint64_t Removed = 2;
+
+            bool Claim(Slot& slot, uint64_t expected, uint64_t hash, std::string_view name) {
+                if (!slot.hash.compare_exchange_strong(expected, hash, std::memory_order_acq_rel)) return false;
+                // the name only becomes visible to readers once it's fully written
+                if (expected == Removed) {
+                    std::destroy_at(&slot.entry);
+                    std::construct_at(&slot.entry);
+                }
+                auto length = std::min(name.size(), MaxNameLength);
+                std::copy_n(name.data(), length, slot.name.data());
+                slot.name[length] = '\0';
+                slot.named.store(true, std::memory_order_release);
+                return true;
+            }
+
+            std::array<Slot, Capacity> slots;
+    };
+
+    /// @brief per packet type and per sender counters of an MpPacketSerializer
+    class MPCORE_EXPORT PacketMetrics {
+        public:
+            static constexpr std::size_t MaxPacketTypes = 256;
+            // room for a full lobby of the largest servers, senders are removed when they leave
+            static constexpr std::size_t MaxSenders = 256;
+            /// @brief name received packets nobody registered a handler for are counted under
+            static constexpr std::string_view UnknownPacket = "unknown";
+
+            PacketMetrics() : unknownPacket(packets.get(UnknownPacket)) {}
+
+            /// @brief only call this with names of packets we send or handle, see ForUnknownPacket
+            /// @return the metrics of a packet type, nullptr if too many types are tracked already
+            PacketTypeMetrics* ForPacket(std::string_view packetName) { return packets.get(packetName); }
+            /// @brief the metrics all received packets without a handler share, so a peer sending made up names can't fill the table
+            PacketTypeMetrics* ForUnknownPacket() { return unknownPacket; }
+            /// @return the metrics of a sender by user id, nullptr if too many senders are tracked already
+            SenderMetrics* ForSender(std::string_view userId) { return senders.get(userId); }
+            /// @brief frees the entry of a sender that left, a pointer to it must not be used afterwards
+            void RemoveSender(std::string_view userId) { senders.remove(userId); }
+
+            void RecordSent(PacketTypeMetrics* packet, std::size_t bytes) {
+                if (!packet) return;
+                packet->sentCount.fetch_add(1, std::memory_order_relaxed);
+                packet->sentBytes.fetch_add(bytes, std::memory_order_relaxed);
+            }
+
+            void RecordReceived(PacketTypeMetrics* packet, SenderMetrics* sender, std::size_t bytes) {
+                if (packet) {
+                    packet->receivedCount.fetch_add(1, std::memory_order_relaxed);
+                    packet->receivedBytes.fetch_add(bytes, std::memory_order_relaxed);
+                }
+                if (sender) {
+                    sender->receivedCount.fetch_add(1, std::memory_order_relaxed);
+                    sender->receivedBytes.fetch_add(bytes, std::memory_order_relaxed);
+                }
+            }
+
+            /// @brief packet is nullptr for messages dropped by the sender's packet rate, before a packet type was looked up
+            void RecordDropped(PacketTypeMetrics* packet, SenderMetrics* sender) {
+                if (packet) packet->droppedCount.fetch_add(1, std::memory_order_relaxed);
+                if (sender) sender->droppedCount.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            void RecordHandled(PacketTypeMetrics* packet, std::chrono::nanoseconds duration) {
+                if (packet) packet->handlerMicros.Record(std::chrono::duration_cast<std::chrono::microseconds>(duration).count());
+            }
+
+            template<typename TFunc>
+            void ForEachPacket(TFunc&& fn) const { packets.forEach(std::forward<TFunc>(fn)); }
+
+            template<typename TFunc>
+            void ForEachSender(TFunc&& fn) const { senders.forEach(std::forward<TFunc>(fn)); }
+
+            /// @brief write a snapshot as a single line of json
+            void WriteJson(std::ostream& out) const;
+
+        private:
+            MetricsTable<PacketTypeMetrics, MaxPacketTypes> packets;
+            MetricsTable<SenderMetrics, MaxSenders> senders;
+            PacketTypeMetrics* unknownPacket;
+    };
+}
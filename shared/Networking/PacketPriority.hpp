@@ -0,0 +1,12 @@
+#pragma once
+
+#include <cstdint>
+
+namespace MultiplayerCore::Networking {
+    /// @brief how urgent outgoing packets are compared to others, more urgent ones go out first when there is more to send than fits in a frame
+    enum class PacketPriority : uint8_t {
+        High,
+        Normal,
+        Low
+    };
+}
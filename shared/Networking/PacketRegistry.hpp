@@ -0,0 +1,140 @@
+#pragma once
+
+#include "PacketKey.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace MultiplayerCore::Networking {
+    /// @brief compact packet id bookkeeping of an MpPacketSerializer, independent of the game types.
+    /// Our own packet types get ids in registration order, peers send us their registry to resolve the ids they use,
+    /// and acknowledge how much of ours they know. TKey identifies a packet type (Il2CppClass* in game), TPeer a connected player
+    template<typename TKey, typename TPeer>
+    class PacketRegistry {
+        public:
+            static constexpr uint32_t NoId = UINT32_MAX;
+
+            /// @brief assigns the next id to key if it does not have one yet, ids are never reused
+            /// @return whether key got a new id
+            bool Register(TKey key, std::string_view name) {
+                if (ids.contains(key)) return false;
+                ids.emplace(key, names.size());
+                names.emplace_back(name);
+                return true;
+            }
+
+            /// @return the id of key, NoId if it was never registered
+            uint32_t IdOf(TKey key) const {
+                auto id = ids.find(key);
+                return id != ids.end() ? id->second : NoId;
+            }
+
+            bool contains(TKey key) const { return ids.contains(key); }
+
+            /// @brief our registry, index is the compact id
+            const std::vector<std::string>& get_names() const { return names; }
+            std::string_view NameOf(uint32_t id) const { return id < names.size() ? std::string_view(names[id]) : std::string_view(); }
+
+            /// @brief a compact id resolved through the registry of a peer
+            struct Resolved {
+                /// @brief empty if the peer never told us about the id
+                std::string_view name;
+                PacketKey key = 0;
+
+                bool empty() const { return name.empty(); }
+            };
+
+            /// @brief registry a peer sent us, replaces what it sent before. The keys of its names are computed here, once per registry
+            void SetIncoming(TPeer peer, std::vector<std::string> peerNames) {
+                auto& registry = incoming[peer];
+                registry.keys.resize(peerNames.size());
+                std::transform(peerNames.begin(), peerNames.end(), registry.keys.begin(), [](const std::string& name){ return KeyOf(name); });
+                registry.names = std::move(peerNames);
+            }
+
+            /// @brief name and key of a compact id a peer sent us
+            Resolved ResolveIncoming(TPeer peer, uint32_t id) const {
+                auto registry = incoming.find(peer);
+                if (registry == incoming.end() || id >= registry->second.names.size()) return {};
+                return { registry->second.names[id], registry->second.keys[id] };
+            }
+
+            /// @brief whether a peer registered a packet, only known once their registry arrived
+            bool PeerHandles(TPeer peer, PacketKey key) const {
+                auto registry = incoming.find(peer);
+                if (registry == incoming.end()) return false;
+                return std::find(registry->second.keys.begin(), registry->second.keys.end(), key) != registry->second.keys.end();
+            }
+
+            bool PeerHandles(TPeer peer, std::string_view name) const { return PeerHandles(peer, KeyOf(name)); }
+
+            /// @brief a peer acknowledged the first count entries of our registry, acks never go backwards
+            void Acknowledge(TPeer peer, uint32_t count) {
+                auto& acknowledged = acknowledgedIds[peer];
+                acknowledged = std::max<uint32_t>(acknowledged, std::min<uint32_t>(count, names.size()));
+            }
+
+            uint32_t AcknowledgedBy(TPeer peer) const {
+                auto acknowledged = acknowledgedIds.find(peer);
+                return acknowledged != acknowledgedIds.end() ? acknowledged->second : 0;
+            }
+
+            /// @brief recompute the ids every one of peers knows, from any range of TPeer
+            /// @return whether the limit changed
+            template<typename TPeers>
+            bool UpdateLimit(const TPeers& peers) {
+                uint32_t limit = 0;
+                bool first = true;
+                for (const auto& peer : peers) {
+                    auto count = AcknowledgedBy(peer);
+                    limit = first ? count : std::min(limit, count);
+                    first = false;
+                }
+                return std::exchange(compactLimit, limit) != limit;
+            }
+
+            /// @brief ids below this are known by every connected peer, anything else goes out name framed
+            uint32_t get_compactLimit() const { return compactLimit; }
+
+            /// @brief ids below this can be sent compact to target, a null target means everyone connected
+            uint32_t LimitFor(TPeer target) const { return target ? AcknowledgedBy(target) : compactLimit; }
+
+            /// @brief whether every receiver knows about key, a null target means everyone connected
+            bool ReceiversKnow(TKey key, TPeer target) const {
+                auto id = IdOf(key);
+                return id != NoId && id < LimitFor(target);
+            }
+
+            void RemovePeer(TPeer peer) {
+                incoming.erase(peer);
+                acknowledgedIds.erase(peer);
+            }
+
+            /// @brief forget every peer, our own registry stays
+            void ClearPeers() {
+                incoming.clear();
+                acknowledgedIds.clear();
+                compactLimit = 0;
+            }
+
+        private:
+            std::unordered_map<TKey, uint32_t> ids;
+            std::vector<std::string> names;
+            struct IncomingRegistry {
+                std::vector<std::string> names;
+                std::vector<PacketKey> keys;
+            };
+
+            // registries received from peers, used to resolve compact ids they send us
+            std::unordered_map<TPeer, IncomingRegistry> incoming;
+            // how many entries of our registry each peer acknowledged
+            std::unordered_map<TPeer, uint32_t> acknowledgedIds;
+            uint32_t compactLimit = 0;
+    };
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <unordered_set>
+
+namespace MultiplayerCore::Networking {
+    /// @brief hashed set of type pointers with a small direct mapped cache in front of it
+    /// HandlesType gets asked about every outgoing packet type, and almost always about a type we don't handle,
+    /// so repeated questions about the same type are answered by a single compare against the cache
+    template<typename T>
+    class RegisteredTypeSet {
+        public:
+            bool contains(const T* type) const {
+                auto key = reinterpret_cast<uintptr_t>(type);
+                auto& slot = cache[SlotFor(key)];
+
+                // slots hold the type pointer with the answer in the low bit, so they can't tear when read from another thread
+                auto cached = slot.load(std::memory_order_relaxed);
+                if ((cached & ~HandledBit) == key) return cached & HandledBit;
+
+                bool handled = types.contains(type);
+                slot.store(key | (handled ? HandledBit : 0), std::memory_order_relaxed);
+                return handled;
+            }
+
+            void insert(const T* type) {
+                if (types.insert(type).second) invalidate(type);
+            }
+
+            void erase(const T* type) {
+                if (types.erase(type)) invalidate(type);
+            }
+
+            void clear() {
+                types.clear();
+                for (auto& slot : cache) slot.store(0, std::memory_order_relaxed);
+            }
+
+            std::size_t size() const { return types.size(); }
+
+        private:
+            static constexpr uintptr_t HandledBit = 1;
+            static constexpr std::size_t CacheSize = 64;
+
+            // type objects are at least 8 byte aligned, so skip the low bits that are always 0
+            static constexpr std::size_t SlotFor(uintptr_t key) { return (key >> 3) & (CacheSize - 1); }
+
+            void invalidate(const T* type) {
+                cache[SlotFor(reinterpret_cast<uintptr_t>(type))].store(0, std::memory_order_relaxed);
+            }
+
+            std::unordered_set<const T*> types;
+            mutable std::array<std::atomic<uintptr_t>, CacheSize> cache{};
+    };
+}
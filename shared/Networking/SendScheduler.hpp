@@ -0,0 +1,125 @@
+#pragma once
+
+#include "PacketPriority.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <deque>
+#include <utility>
+#include <vector>
+
+namespace MultiplayerCore::Networking {
+    /// @brief outgoing queue of an MpPacketSerializer, independent of the game types.
+    /// Frames wait in one queue per priority and go out most urgent first, up to a number of bytes per frame.
+    /// Within a priority they keep the order they were queued in. TTarget identifies a connected player, a null target is the whole lobby
+    template<typename TTarget>
+    class SendScheduler {
+        public:
+            static constexpr std::size_t PriorityCount = static_cast<std::size_t>(PacketPriority::Low) + 1;
+
+            struct Message {
+                TTarget target;
+                bool reliable;
+                std::vector<uint8_t> frame;
+                std::chrono::steady_clock::time_point queued;
+            };
+
+            struct QueueStats {
+                /// @brief messages and bytes waiting right now
+                std::size_t depth = 0;
+                std::size_t bytes = 0;
+                /// @brief most messages that were waiting at once
+                std::size_t peakDepth = 0;
+                uint64_t sentCount = 0;
+                uint64_t sentBytes = 0;
+                /// @brief time sent messages spent waiting, in total and the longest
+                std::chrono::microseconds totalWait{0};
+                std::chrono::microseconds maxWait{0};
+            };
+
+            /// @brief bytes sent per Drain, 0 sends everything that is queued
+            void set_bytesPerFrame(std::size_t value) { bytesPerFrame = value; }
+            std::size_t get_bytesPerFrame() const { return bytesPerFrame; }
+
+            void Enqueue(PacketPriority priority, Message message) {
+                auto& queue = queues[static_cast<std::size_t>(priority)];
+                auto& stats = queue.stats;
+                stats.depth++;
+                stats.bytes += message.frame.size();
+                stats.peakDepth = std::max(stats.peakDepth, stats.depth);
+                queue.messages.push_back(std::move(message));
+            }
+
+            /// @brief hand queued messages to send, most urgent first, until this frame's bytes are used up.
+            /// At least one message goes out every frame, so a message larger than the budget only delays the ones behind it by a frame
+            /// @return messages sent
+            template<typename TSend>
+            std::size_t Drain(TSend&& send, std::chrono::steady_clock::time_point now) {
+                std::size_t sent = 0;
+                std::size_t sentBytes = 0;
+                for (auto& queue : queues) {
+                    while (!queue.messages.empty()) {
+                        auto& message = queue.messages.front();
+                        auto size = message.frame.size();
+                        // less urgent messages don't get to skip ahead of one that doesn't fit anymore
+                        if (bytesPerFrame && sent > 0 && sentBytes + size > bytesPerFrame) return sent;
+
+                        auto wait = std::chrono::duration_cast<std::chrono::microseconds>(now - message.queued);
+                        auto& stats = queue.stats;
+                        stats.depth--;
+                        stats.bytes -= size;
+                        stats.sentCount++;
+                        stats.sentBytes += size;
+                        stats.totalWait += wait;
+                        stats.maxWait = std::max(stats.maxWait, wait);
+
+                        // taken off the queue first, send may queue more
+                        auto next = std::move(message);
+                        queue.messages.pop_front();
+                        send(next);
+                        sent++;
+                        sentBytes += size;
+                    }
+                }
+                return sent;
+            }
+
+            /// @brief drop what is queued for a player that left
+            void RemoveTarget(TTarget target) {
+                if (!target) return;
+                for (auto& queue : queues) {
+                    std::erase_if(queue.messages, [&queue, target](const Message& message){
+                        if (message.target != target) return false;
+                        queue.stats.depth--;
+                        queue.stats.bytes -= message.frame.size();
+                        return true;
+                    });
+                }
+            }
+
+            bool empty() const { return std::all_of(queues.begin(), queues.end(), [](auto& queue){ return queue.messages.empty(); }); }
+
+            const QueueStats& get_stats(PacketPriority priority) const { return queues[static_cast<std::size_t>(priority)].stats; }
+
+            /// @brief drop everything queued, the stats of what was sent stay
+            void clear() {
+                for (auto& queue : queues) {
+                    queue.messages.clear();
+                    queue.stats.depth = 0;
+                    queue.stats.bytes = 0;
+                }
+            }
+
+        private:
+            struct Queue {
+                std::deque<Message> messages;
+                QueueStats stats;
+            };
+
+            std::size_t bytesPerFrame = 0;
+            std::array<Queue, PriorityCount> queues;
+    };
+}
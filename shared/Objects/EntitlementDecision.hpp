@@ -0,0 +1,72 @@
+#pragma once
+
+#include "../Utils/LevelHash.hpp"
+
+#include <algorithm>
+#include <string_view>
+#include <vector>
+
+namespace MultiplayerCore::Objects {
+    /// @brief how MpEntitlementChecker decides on custom levels, without the game, the song loader or the beatsaver api
+    /// isInstalled is called as bool(std::string_view requirement)
+    struct EntitlementDecision {
+        /// @brief same values as GlobalNamespace::EntitlementsStatus
+        enum class Status : int {
+            Unknown = 0,
+            NotOwned = 1,
+            NotDownloaded = 2,
+            Ok = 3
+        };
+
+        /// @brief level is installed, Ok unless it requires something that isn't
+        /// @param songData parsed info.dat of the level, nullptr if it couldn't be read
+        template<typename TSongData, typename TIsInstalled>
+        static Status ForLocalLevel(const TSongData* songData, TIsInstalled&& isInstalled) {
+            if (!songData) return Status::Ok;
+
+            RequirementCheck check;
+            for (const auto& diff : songData->difficulties) {
+                if (!diff.additionalDifficultyData.has_value()) continue;
+                for (const auto& req : diff.additionalDifficultyData->requirements)
+                    if (check.Missing(req, isInstalled)) return Status::NotOwned;
+            }
+            return Status::Ok;
+        }
+
+        /// @brief the version of a beatsaver map that matches levelHash
+        /// @return iterator to the version, versions.end() if the hash is none of them
+        template<typename TVersions>
+        static auto FindVersion(const TVersions& versions, std::string_view levelHash) {
+            return std::find_if(versions.begin(), versions.end(), [levelHash](const auto& v){ return Utils::LevelHash::Equals(v.GetHash(), levelHash); });
+        }
+
+        /// @brief level isn't installed but the version is on beatsaver, NotDownloaded unless it requires something that isn't installed
+        template<typename TVersion, typename TIsInstalled>
+        static Status ForBeatSaverVersion(const TVersion& version, TIsInstalled&& isInstalled) {
+            RequirementCheck check;
+            for (const auto& diff : version.GetDiffs()) {
+                if (diff.GetChroma() && check.Missing("Chroma", isInstalled)) return Status::NotOwned;
+                if (diff.GetME() && check.Missing("Mapping Extensions", isInstalled)) return Status::NotOwned;
+                if (diff.GetNE() && check.Missing("Noodle Extensions", isInstalled)) return Status::NotOwned;
+            }
+            return Status::NotDownloaded;
+        }
+
+        /// @brief neither installed nor on beatsaver, probably a WIP, either way we don't have it and can't get it
+        static constexpr Status ForMissingLevel() { return Status::NotOwned; }
+
+        private:
+            /// @brief most difficulties share their requirements, so each one is only looked up once
+            struct RequirementCheck {
+                template<typename TIsInstalled>
+                bool Missing(std::string_view requirement, TIsInstalled& isInstalled) {
+                    if (std::find(installed.begin(), installed.end(), requirement) != installed.end()) return false;
+                    if (!isInstalled(requirement)) return true;
+                    installed.push_back(requirement);
+                    return false;
+                }
+
+                std::vector<std::string_view> installed;
+            };
+    };
+}
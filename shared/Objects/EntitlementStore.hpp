@@ -0,0 +1,82 @@
+#pragma once
+
+#include "../_config.h"
+#include "../Utils/RecordLog.hpp"
+#include "EntitlementDecision.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace MultiplayerCore::Objects {
+    /// @brief what MpEntitlementChecker decided for the local player by level hash, kept in a RecordLog so a new lobby doesn't decide it again.
+    /// A verdict holds as long as the installed mods are the same and the song folder wasn't touched since,
+    /// verdicts for levels that aren't installed came from BeatSaver and expire like its metadata. Safe to use from any thread
+    class MPCORE_EXPORT EntitlementStore {
+        public:
+            static constexpr Utils::RecordLog::Magic Magic = { 'M', 'P', 'E', 'N' };
+            static constexpr uint8_t Version = 1;
+
+            // the map can get a version with other requirements on BeatSaver, or get uploaded
+            static constexpr std::chrono::seconds DefaultRemoteTtl = std::chrono::hours(24);
+
+            struct Entry {
+                /// @brief lower case
+                std::string hash;
+                EntitlementDecision::Status status = EntitlementDecision::Status::Unknown;
+                /// @brief fingerprint of the installed mods when it was decided
+                uint64_t modSet = 0;
+                /// @brief last write time of the song folder in seconds, 0 if the level wasn't installed
+                int64_t folderTime = 0;
+                std::chrono::system_clock::time_point decided;
+            };
+
+            struct Stats {
+                uint64_t hits = 0;
+                uint64_t misses = 0;
+                /// @brief lookups that found a verdict for another song folder or one past its TTL, those count as misses as well
+                uint64_t stale = 0;
+                uint64_t stores = 0;
+                std::size_t entries = 0;
+                uint64_t logBytes = 0;
+            };
+
+            /// @brief read the log at path, verdicts made with other mods than modSet are dropped
+            EntitlementStore(std::filesystem::path path, uint64_t modSet);
+
+            /// @param folderTime last write time of the song folder in seconds, 0 if the level isn't installed
+            /// @return the verdict for hash if it still holds, nullopt otherwise
+            std::optional<EntitlementDecision::Status> Find(std::string_view hash, int64_t folderTime, std::chrono::system_clock::time_point now = std::chrono::system_clock::now());
+            /// @brief Unknown isn't stored, it is what we answer when we couldn't decide
+            void Store(std::string_view hash, EntitlementDecision::Status status, int64_t folderTime);
+            void Erase(std::string_view hash);
+            void Clear();
+
+            void set_remoteTtl(std::chrono::seconds ttl);
+            Stats get_stats() const;
+
+            /// @brief the entry part of a record, appended to record
+            static void Encode(const Entry& entry, std::vector<uint8_t>& record);
+            /// @brief throws std::runtime_error if the record is cut short or doesn't make sense
+            static Entry Decode(std::span<const uint8_t> record);
+
+        private:
+            void Append(const Entry& entry);
+            bool CompactLocked();
+
+            uint64_t modSet;
+            mutable std::mutex mutex;
+            Utils::RecordLog log;
+            std::unordered_map<std::string, Entry> entries;
+            std::chrono::seconds remoteTtl = DefaultRemoteTtl;
+            Stats stats;
+            std::vector<uint8_t> record;
+    };
+}
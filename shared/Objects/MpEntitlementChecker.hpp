@@ -8,7 +8,10 @@
 #include "System/Collections/Concurrent/ConcurrentDictionary_2.hpp"
 #include "System/Threading/Tasks/Task_1.hpp"
 #include "System/Threading/Tasks/TaskCompletionSource_1.hpp"
+#include "MpLevelDownloader.hpp"
+#include "../Utils/LruCache.hpp"
 
+#include <chrono>
 #include <future>
 #include <unordered_map>
 #include <string>
@@ -17,8 +20,9 @@ using EntitlementsStatusTask = ::System::Threading::Tasks::Task_1<::GlobalNamesp
 
 DECLARE_CLASS_CODEGEN(MultiplayerCore::Objects, MpEntitlementChecker, GlobalNamespace::NetworkPlayerEntitlementChecker,
     DECLARE_INSTANCE_FIELD_PRIVATE(GlobalNamespace::IMultiplayerSessionManager*, _sessionManager);
+    DECLARE_INSTANCE_FIELD_PRIVATE(MpLevelDownloader*, _levelDownloader);
 
-    DECLARE_INJECT_METHOD(void, Inject, GlobalNamespace::IMultiplayerSessionManager* sessionManager);
+    DECLARE_INJECT_METHOD(void, Inject, GlobalNamespace::IMultiplayerSessionManager* sessionManager, MpLevelDownloader* levelDownloader);
 
     DECLARE_INSTANCE_METHOD(void, Start_override);
     DECLARE_INSTANCE_METHOD(void, OnDestroy_override);
@@ -32,8 +36,24 @@ DECLARE_CLASS_CODEGEN(MultiplayerCore::Objects, MpEntitlementChecker, GlobalName
     public:
         UnorderedEventCallback<std::string, std::string, GlobalNamespace::EntitlementsStatus> receivedEntitlementEvent;
 
+        using EntitlementsTaskCache = Utils::LruCache<std::string, SafePtr<EntitlementsStatusTask>>;
+        // a quickplay session goes through a few hundred levels, and a verdict can change without the song folder changing
+        static constexpr std::size_t MaxEntitlementsTasks = 256;
+        static constexpr std::chrono::minutes EntitlementsTaskTtl{10};
+
+        /// @brief the local entitlement of levelId is decided again the next time it is asked for, its persisted verdict is erased as well
+        void InvalidateLevel(const std::string& levelId);
+        /// @brief every finished local entitlement is decided again the next time it is asked for, ones still being decided are kept.
+        /// Clears the persisted verdicts as well
+        void InvalidateAll();
+        EntitlementsTaskCache::Stats get_entitlementsTaskStats() const;
+
     private:
         GlobalNamespace::EntitlementsStatus GetEntitlementStatus(std::string levelId);
+        void HandleDownloadFinished(std::string levelId, bool success);
+        /// @brief finished tasks are decided again, the persisted verdicts are kept
+        void DropFinishedTasks();
         std::unordered_map<std::string, std::unordered_map<std::string, GlobalNamespace::EntitlementsStatus>> _entitlementsDictionary;
-        std::unordered_map<std::string, SafePtr<EntitlementsStatusTask>> _entitlementsTasks;
+        EntitlementsTaskCache _entitlementsTasks{MaxEntitlementsTasks, EntitlementsTaskTtl};
+        uint64_t _songsGeneration = 0;
 )
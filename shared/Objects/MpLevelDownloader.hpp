@@ -10,6 +10,8 @@ DECLARE_CLASS_CODEGEN(MultiplayerCore::Objects, MpLevelDownloader, System::Objec
     DECLARE_CTOR(ctor);
     public:
         std::shared_future<bool> TryDownloadLevelAsync(std::string levelId, std::function<void(double)> progress = nullptr);
+        /// @brief invoked on the main thread with the level id and whether it worked, once the songs are refreshed after a download
+        UnorderedEventCallback<std::string, bool> downloadFinishedEvent;
     private:
         std::unordered_map<std::string, std::shared_future<bool>> downloads;
         bool TryDownloadLevelInternal(std::string levelId, std::function<void(double)> progress = nullptr);
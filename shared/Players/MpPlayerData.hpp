@@ -5,7 +5,7 @@
 #include "Zenject/IInitializable.hpp"
 #include "System/IDisposable.hpp"
 
-#include "../Networking/Abstractions/MpPacket.hpp"
+#include "../Networking/Abstractions/MpPoolablePacket.hpp"
 
 namespace MultiplayerCore::Players {
     enum class MPCORE_EXPORT Platform {
@@ -26,7 +26,7 @@ struct ::il2cpp_utils::il2cpp_type_check::il2cpp_no_arg_class<MultiplayerCore::P
 };
 static_assert(sizeof(MultiplayerCore::Players::Platform) == sizeof(int));
 
-DECLARE_CLASS_CUSTOM(MultiplayerCore::Players, MpPlayerData, MultiplayerCore::Networking::Abstractions::MpPacket,
+DECLARE_CLASS_CUSTOM(MultiplayerCore::Players, MpPlayerData, MultiplayerCore::Networking::Abstractions::MpPoolablePacket,
     DECLARE_CTOR(New);
 
     DECLARE_INSTANCE_FIELD(StringW, platformId);
@@ -35,4 +35,6 @@ DECLARE_CLASS_CUSTOM(MultiplayerCore::Players, MpPlayerData, MultiplayerCore::Ne
 
     DECLARE_OVERRIDE_METHOD_MATCH(void, Serialize, &::LiteNetLib::Utils::INetSerializable::Serialize, LiteNetLib::Utils::NetDataWriter* writer);
     DECLARE_OVERRIDE_METHOD_MATCH(void, Deserialize, &::LiteNetLib::Utils::INetSerializable::Deserialize, LiteNetLib::Utils::NetDataReader* reader);
+
+    DECLARE_PACKET_NAME(MpPlayerData);
 )
@@ -0,0 +1,13 @@
+#pragma once
+
+namespace MultiplayerCore::Players {
+    /// @brief payload of MpPlayerData as Deserialize reads it, templated on the reader and the packet so the fuzz targets decode it with the same code as the game
+    struct MpPlayerDataEncoding {
+        template<typename TReader, typename TPacket>
+        static inline void Read(TReader reader, TPacket& packet) {
+            packet.platformId = reader->GetString();
+            packet.platform = static_cast<decltype(packet.platform)>(reader->GetInt());
+            packet.gameVersion = reader->GetString();
+        }
+    };
+}
@@ -1,12 +1,15 @@
 #pragma once
 
 #include "./_config.h"
+#include "./Utils/LevelHash.hpp"
 #include "songloader/shared/API.hpp"
 
+#include <string>
+
 namespace MultiplayerCore {
     struct MPCORE_EXPORT Utilities {
         static inline std::string HashForLevelId(const std::string& levelId) {
-            return levelId.starts_with(RuntimeSongLoader::API::GetCustomLevelsPrefix()) ? levelId.substr(RuntimeSongLoader::API::GetCustomLevelsPrefix().length()) : "";
+            return std::string(Utils::LevelHash::FromLevelId(levelId, RuntimeSongLoader::API::GetCustomLevelsPrefix()));
         }
     };
 }
@@ -0,0 +1,223 @@
+#pragma once
+
+#include "../_config.h"
+
+#if __has_include("beatsaber-hook/shared/rapidjson/include/rapidjson/document.h")
+#include "beatsaber-hook/shared/rapidjson/include/rapidjson/document.h"
+#else
+#include "rapidjson/document.h"
+#endif
+
+#include <array>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace MultiplayerCore::Utils {
+    /// @brief the parts of a map's info.dat MpCore cares about, independent of the game types
+    /// TColor needs public r, g, b, a floats and a (r, g, b, a) constructor, TDifficulty has to be constructible from the difficulty's int value
+    template<typename TColor, typename TDifficulty>
+    struct BasicExtraSongData {
+        struct MPCORE_EXPORT Contributor {
+            Contributor(const std::string& name, const std::string& role, const std::string& iconPath) :
+                name(name), role(role), iconPath(iconPath) {}
+
+            Contributor(const Contributor&) = default;
+            const std::string name, role, iconPath;
+        };
+
+        struct MPCORE_EXPORT RequirementData {
+            RequirementData(std::vector<std::string>& requirements, std::vector<std::string>& suggestions, std::vector<std::string>& warnings, std::vector<std::string>& information) :
+                requirements(std::move(requirements)), suggestions(std::move(suggestions)), warnings(std::move(warnings)), information(std::move(information)) {}
+            const std::vector<std::string> requirements;
+            const std::vector<std::string> suggestions;
+            const std::vector<std::string> warnings;
+            const std::vector<std::string> information;
+        };
+
+        struct MPCORE_EXPORT MapColor : TColor {
+            constexpr MapColor() : TColor(1.0f, 1.0f, 1.0f, 1.0f) {}
+
+            constexpr MapColor(float r, float g, float b) : TColor(r, g, b, 1.0f) {}
+
+            inline MapColor(const rapidjson::Value& json) : TColor(1.0f, 1.0f, 1.0f, 1.0f) {
+                auto mEnd = json.MemberEnd();
+                if (auto itr = json.FindMember("r"); itr != mEnd && itr->value.IsNumber()) this->r = itr->value.GetFloat();
+                if (auto itr = json.FindMember("g"); itr != mEnd && itr->value.IsNumber()) this->g = itr->value.GetFloat();
+                if (auto itr = json.FindMember("b"); itr != mEnd && itr->value.IsNumber()) this->b = itr->value.GetFloat();
+            }
+
+            /// @brief read from anything with GetFloat(), like a LiteNetLib reader
+            template<typename TReader>
+            requires(std::is_pointer_v<TReader>)
+            inline MapColor(TReader reader) : TColor(1.0f, 1.0f, 1.0f, 1.0f) {
+                Deserialize(reader);
+            }
+
+            template<typename TWriter>
+            inline void Serialize(TWriter writer) const {
+                writer->Put(this->r); writer->Put(this->g); writer->Put(this->b);
+            }
+
+            template<typename TReader>
+            inline void Deserialize(TReader reader) {
+                // separate statements, the reads have to happen in order
+                this->r = reader->GetFloat();
+                this->g = reader->GetFloat();
+                this->b = reader->GetFloat();
+                this->a = 1.0f;
+            }
+        };
+        static_assert(sizeof(MapColor) == sizeof(TColor), "MapColor can not add anything to the color it wraps");
+
+        struct MPCORE_EXPORT DifficultyData {
+            DifficultyData() {}
+
+            DifficultyData(
+                std::string_view beatmapCharacteristicName,
+                TDifficulty difficulty,
+                std::optional<std::string> difficultyLabel,
+                std::optional<RequirementData> additionalDifficultyData,
+                MapColor colorLeft,
+                MapColor colorRight,
+                MapColor envColorLeft,
+                MapColor envColorRight,
+                MapColor envColorLeftBoost,
+                MapColor envColorRightBoost,
+                MapColor obstacleColor
+            ) :
+                beatmapCharacteristicName(beatmapCharacteristicName),
+                difficultyLabel(std::move(difficultyLabel)),
+                difficulty(difficulty),
+                additionalDifficultyData(std::move(additionalDifficultyData)),
+                colorLeft(colorLeft),
+                colorRight(colorRight),
+                envColorLeft(envColorLeft),
+                envColorRight(envColorRight),
+                envColorLeftBoost(envColorLeftBoost),
+                envColorRightBoost(envColorRightBoost),
+                obstacleColor(obstacleColor) {}
+
+            std::string beatmapCharacteristicName;
+            std::optional<std::string> difficultyLabel;
+
+            TDifficulty difficulty;
+            std::optional<RequirementData> additionalDifficultyData;
+
+            MapColor colorLeft;
+            MapColor colorRight;
+            MapColor envColorLeft;
+            MapColor envColorRight;
+            MapColor envColorLeftBoost;
+            MapColor envColorRightBoost;
+            MapColor obstacleColor;
+        };
+
+        std::vector<Contributor> contributors;
+        std::string customEnvironmentName;
+        std::string customEnvironmentHash;
+        std::vector<DifficultyData> difficulties;
+        std::string defaultCharacteristicName;
+
+        /// @brief BeatmapDifficulty names in enum order
+        static constexpr std::array<std::string_view, 5> DifficultyNames = { "Easy", "Normal", "Hard", "Expert", "ExpertPlus" };
+
+        /// @brief difficulty for its enum name, unknown names give Easy like Enum.TryParse does
+        static constexpr TDifficulty ParseDifficulty(std::string_view name) {
+            for (std::size_t i = 0; i < DifficultyNames.size(); i++)
+                if (DifficultyNames[i] == name) return TDifficulty(int(i));
+            return TDifficulty(0);
+        }
+
+        BasicExtraSongData() = default;
+
+        /// @brief parse the contents of an info.dat
+        BasicExtraSongData(const rapidjson::Value& doc) {
+            if (!doc.IsObject()) return;
+
+            auto cdItr = doc.FindMember("_customData");
+            if (cdItr != doc.MemberEnd() && cdItr->value.IsObject()) {
+                const auto& cD = cdItr->value;
+                auto contributorsItr = cD.FindMember("contributors");
+                if (contributorsItr != cD.MemberEnd() && contributorsItr->value.IsArray() && !contributorsItr->value.Empty()) {
+                    contributors.reserve(contributorsItr->value.Size());
+                    for (const auto& c : contributorsItr->value.GetArray()) {
+                        auto name = StringMember(c, "_name");
+                        auto role = StringMember(c, "_role");
+                        if (name && role) contributors.emplace_back(std::string(*name), std::string(*role), std::string(StringMember(c, "_iconPath").value_or("")));
+                    }
+                }
+
+                if (auto value = StringMember(cD, "_customEnvironmentName")) customEnvironmentName = *value;
+                if (auto value = StringMember(cD, "_customEnvironmentHash")) customEnvironmentHash = *value;
+                if (auto value = StringMember(cD, "_defaultCharacteristicName")) defaultCharacteristicName = *value;
+            }
+
+            auto dBSItr = doc.FindMember("_difficultyBeatmapSets");
+            if (dBSItr == doc.MemberEnd() || !dBSItr->value.IsArray() || dBSItr->value.Empty()) return;
+
+            difficulties.reserve(dBSItr->value.Size());
+            for (const auto& set : dBSItr->value.GetArray()) {
+                auto beatmapCharacteristicName = StringMember(set, "_beatmapCharacteristicName").value_or("");
+
+                auto dBItr = set.FindMember("_difficultyBeatmaps");
+                if (dBItr == set.MemberEnd() || !dBItr->value.IsArray() || dBItr->value.Empty()) continue;
+
+                for (const auto& dB : dBItr->value.GetArray()) {
+                    // difficulties without custom data have nothing for us
+                    auto cDItr = dB.FindMember("_customData");
+                    if (cDItr == dB.MemberEnd() || !cDItr->value.IsObject()) continue;
+                    const auto& cD = cDItr->value;
+
+                    TDifficulty diffDifficulty = TDifficulty(1);
+                    if (auto value = StringMember(dB, "_difficulty")) diffDifficulty = ParseDifficulty(*value);
+
+                    std::vector<std::string> diffRequirements = StringArrayMember(cD, "_requirements");
+                    std::vector<std::string> diffSuggestions = StringArrayMember(cD, "_suggestions");
+                    std::vector<std::string> diffWarnings = StringArrayMember(cD, "_warnings");
+                    std::vector<std::string> diffInfo = StringArrayMember(cD, "_information");
+
+                    difficulties.emplace_back(
+                        beatmapCharacteristicName,
+                        diffDifficulty,
+                        std::string(StringMember(cD, "_difficultyLabel").value_or("")),
+                        RequirementData(diffRequirements, diffSuggestions, diffWarnings, diffInfo),
+                        ColorMember(cD, "_colorLeft"),
+                        ColorMember(cD, "_colorRight"),
+                        ColorMember(cD, "_colorEnvLeft"),
+                        ColorMember(cD, "_colorEnvRight"),
+                        ColorMember(cD, "_colorEnvLeftBoost"),
+                        ColorMember(cD, "_colorEnvRightBoost"),
+                        ColorMember(cD, "_colorObstacle")
+                    );
+                }
+            }
+        }
+
+        private:
+            static std::optional<std::string_view> StringMember(const rapidjson::Value& object, const char* name) {
+                auto itr = object.FindMember(name);
+                if (itr == object.MemberEnd() || !itr->value.IsString()) return std::nullopt;
+                return std::string_view(itr->value.GetString(), itr->value.GetStringLength());
+            }
+
+            static MapColor ColorMember(const rapidjson::Value& object, const char* name) {
+                auto itr = object.FindMember(name);
+                if (itr == object.MemberEnd() || !itr->value.IsObject()) return MapColor();
+                return MapColor(itr->value);
+            }
+
+            static std::vector<std::string> StringArrayMember(const rapidjson::Value& object, const char* name) {
+                std::vector<std::string> values;
+                auto itr = object.FindMember(name);
+                if (itr == object.MemberEnd() || !itr->value.IsArray()) return values;
+                values.reserve(itr->value.Size());
+                for (const auto& val : itr->value.GetArray())
+                    if (val.IsString()) values.emplace_back(val.GetString(), val.GetStringLength());
+                return values;
+            }
+    };
+}
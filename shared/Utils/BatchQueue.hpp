@@ -0,0 +1,120 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace MultiplayerCore::Utils {
+    /// @brief gathers lookups that arrive within a short window and resolves them with one call of fetch.
+    /// The first caller of a batch waits out the window (or until the batch is full) and runs fetch on its own thread,
+    /// the others wait for their result, so there is no thread of its own. A key fetch didn't return a value for resolves to nullopt,
+    /// an exception thrown by fetch reaches every caller of the batch
+    template<typename TKey, typename TValue, typename THash = std::hash<TKey>>
+    class BatchQueue {
+        public:
+            using Results = std::unordered_map<TKey, TValue, THash>;
+            using Fetch = std::function<Results(const std::vector<TKey>&)>;
+
+            struct Stats {
+                uint64_t lookups = 0;
+                uint64_t batches = 0;
+                /// @brief lookups of a key that was already in the batch
+                uint64_t duplicates = 0;
+                std::size_t largestBatch = 0;
+            };
+
+            BatchQueue(Fetch fetch, std::chrono::milliseconds window, std::size_t maxBatch) : fetch(std::move(fetch)), window(window), maxBatch(std::max<std::size_t>(maxBatch, 1)) {}
+
+            BatchQueue(const BatchQueue&) = delete;
+            BatchQueue& operator=(const BatchQueue&) = delete;
+
+            /// @brief blocks until the batch key ends up in is fetched
+            std::optional<TValue> Get(const TKey& key) {
+                std::unique_lock lock(mutex);
+                stats.lookups++;
+
+                auto batch = open;
+                bool leader = !batch;
+                if (leader) {
+                    batch = open = std::make_shared<Batch>();
+                    stats.batches++;
+                }
+
+                auto result = batch->results.find(key);
+                if (result != batch->results.end()) {
+                    stats.duplicates++;
+                } else {
+                    batch->keys.push_back(key);
+                    result = batch->results.emplace(key, batch->promises.emplace_back().get_future().share()).first;
+                    if (batch->keys.size() >= maxBatch) Close(*batch);
+                }
+                auto future = result->second;
+
+                if (!leader) {
+                    lock.unlock();
+                    return future.get();
+                }
+
+                full.wait_for(lock, window, [&batch](){ return batch->closed; });
+                if (!batch->closed) Close(*batch);
+                stats.largestBatch = std::max(stats.largestBatch, batch->keys.size());
+                lock.unlock();
+
+                // nothing is added to a closed batch, so it is only ours from here
+                Results values;
+                try {
+                    values = fetch(batch->keys);
+                } catch (...) {
+                    auto exception = std::current_exception();
+                    for (auto& promise : batch->promises) promise.set_exception(exception);
+                    return future.get();
+                }
+
+                for (std::size_t i = 0; i < batch->keys.size(); i++) {
+                    auto value = values.find(batch->keys[i]);
+                    if (value == values.end()) batch->promises[i].set_value(std::nullopt);
+                    else batch->promises[i].set_value(std::move(value->second));
+                }
+                return future.get();
+            }
+
+            Stats get_stats() const {
+                std::lock_guard lock(mutex);
+                return stats;
+            }
+
+        private:
+            struct Batch {
+                std::vector<TKey> keys;
+                // same order as keys
+                std::vector<std::promise<std::optional<TValue>>> promises;
+                std::unordered_map<TKey, std::shared_future<std::optional<TValue>>, THash> results;
+                bool closed = false;
+            };
+
+            void Close(Batch& batch) {
+                batch.closed = true;
+                if (open.get() == &batch) open.reset();
+                full.notify_all();
+            }
+
+            Fetch fetch;
+            std::chrono::milliseconds window;
+            std::size_t maxBatch;
+
+            mutable std::mutex mutex;
+            std::condition_variable full;
+            std::shared_ptr<Batch> open;
+            Stats stats;
+    };
+}
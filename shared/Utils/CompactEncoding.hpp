@@ -0,0 +1,134 @@
+#pragma once
+
+#include "VarInt.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace MultiplayerCore::Utils {
+    /// @brief IEEE 754 binary16 conversions, round to nearest even
+    struct HalfFloat {
+        static inline uint16_t FromFloat(float value) {
+            uint32_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            uint16_t sign = (bits >> 16) & 0x8000;
+            uint32_t abs = bits & 0x7fffffff;
+
+            // inf and nan, nan keeps a mantissa bit so it stays nan
+            if (abs >= 0x7f800000) return sign | 0x7c00 | (abs > 0x7f800000 ? 0x200 : 0);
+            // 65520 and up round to inf
+            if (abs >= 0x477ff000) return sign | 0x7c00;
+            // below half the smallest subnormal rounds to 0
+            if (abs < 0x33000000) return sign;
+
+            uint32_t half, remainder, halfway;
+            if (abs < 0x38800000) {
+                // subnormal half, shift the mantissa (with its implicit bit) down into place
+                uint32_t mantissa = (abs & 0x7fffff) | 0x800000;
+                uint32_t shift = 126 - (abs >> 23);
+                half = mantissa >> shift;
+                remainder = mantissa & ((1u << shift) - 1);
+                halfway = 1u << (shift - 1);
+            } else {
+                // rebias the exponent from 127 to 15, mantissa overflow carries into the exponent which is what we want
+                half = (abs - 0x38000000) >> 13;
+                remainder = abs & 0x1fff;
+                halfway = 0x1000;
+            }
+            if (remainder > halfway || (remainder == halfway && (half & 1))) half++;
+            return sign | half;
+        }
+
+        static inline float ToFloat(uint16_t half) {
+            uint32_t sign = uint32_t(half & 0x8000) << 16;
+            uint32_t exponent = (half >> 10) & 0x1f;
+            uint32_t mantissa = half & 0x3ff;
+
+            uint32_t bits;
+            if (exponent == 0x1f) {
+                bits = sign | 0x7f800000 | (mantissa << 13);
+            } else if (exponent == 0) {
+                // zero and subnormals, value is mantissa * 2^-24
+                float value = float(mantissa) * (1.0f / 16777216.0f);
+                return sign ? -value : value;
+            } else {
+                bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+            }
+
+            float value;
+            std::memcpy(&value, &bits, sizeof(value));
+            return value;
+        }
+    };
+
+    /// @brief floats in 0..1 stored as a single byte
+    struct UnitFloat8 {
+        static constexpr bool Fits(float value) { return value >= 0.0f && value <= 1.0f; }
+
+        static inline uint8_t FromFloat(float value) {
+            return static_cast<uint8_t>(std::lround(std::clamp(value, 0.0f, 1.0f) * 255.0f));
+        }
+
+        static constexpr float ToFloat(uint8_t value) { return value / 255.0f; }
+    };
+
+    /// @brief uppercase hex strings (like level hashes) packed into raw bytes
+    struct HexBytes {
+        /// @brief decode hex into exactly size bytes
+        /// @return false if hex isn't 2 * size uppercase hex digits, so Encode would not give back the same string
+        static inline bool Decode(std::string_view hex, uint8_t* out, std::size_t size) {
+            if (hex.size() != size * 2) return false;
+            for (std::size_t i = 0; i < size; i++) {
+                int high = Digit(hex[i * 2]);
+                int low = Digit(hex[i * 2 + 1]);
+                if (high < 0 || low < 0) return false;
+                out[i] = uint8_t((high << 4) | low);
+            }
+            return true;
+        }
+
+        static inline std::string Encode(const uint8_t* data, std::size_t size) {
+            constexpr char digits[] = "0123456789ABCDEF";
+            std::string hex(size * 2, '\0');
+            for (std::size_t i = 0; i < size; i++) {
+                hex[i * 2] = digits[data[i] >> 4];
+                hex[i * 2 + 1] = digits[data[i] & 0xf];
+            }
+            return hex;
+        }
+
+        private:
+            static constexpr int Digit(char c) {
+                if (c >= '0' && c <= '9') return c - '0';
+                if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+                return -1;
+            }
+    };
+
+    /// @brief strings with a varint byte count instead of LiteNetLib's int, null and empty strings are both a single 0 byte
+    struct CompactString {
+        template<typename TWriter>
+        static inline void Write(TWriter writer, std::string_view value) {
+            VarInt::Write(writer, static_cast<uint32_t>(value.size()));
+            for (char c : value) writer->Put(static_cast<uint8_t>(c));
+        }
+
+        template<typename TReader>
+        static inline std::string Read(TReader reader) {
+            auto byteCount = VarInt::Read(reader);
+            if (byteCount == 0) return {};
+            if (byteCount > static_cast<uint32_t>(reader->get_AvailableBytes())) throw std::runtime_error("String length exceeds available bytes");
+
+            auto data = reader->get_RawData();
+            std::string value(reinterpret_cast<const char*>(&data[reader->get_Position()]), byteCount);
+            reader->SkipBytes(byteCount);
+            return value;
+        }
+    };
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../_config.h"
+#include "BasicExtraSongData.hpp"
 #include "beatsaber-hook/shared/config/rapidjson-utils.hpp"
 
 #include "UnityEngine/Color.hpp"
@@ -13,104 +14,8 @@
 
 #include "songloader/shared/API.hpp"
 
-#define GET_COL(col) \
-    auto col##Itr = json.FindMember(#col); \
-    if (col##Itr != mEnd) col = col##Itr->value.GetFloat();
-
 namespace MultiplayerCore::Utils {
-    struct MPCORE_EXPORT ExtraSongData {
-        struct MPCORE_EXPORT Contributor {
-            Contributor(const std::string& name, const std::string& role, const std::string& iconPath) :
-                name(name), role(role), iconPath(iconPath) {}
-
-            Contributor(const Contributor&) = default;
-            const std::string name, role, iconPath;
-        };
-
-        struct MPCORE_EXPORT RequirementData {
-            RequirementData(std::vector<std::string>& requirements, std::vector<std::string>& suggestions, std::vector<std::string>& warnings, std::vector<std::string>& information) :
-                requirements(std::move(requirements)), suggestions(std::move(suggestions)), warnings(std::move(warnings)), information(std::move(information)) {}
-			const std::vector<std::string> requirements;
-			const std::vector<std::string> suggestions;
-			const std::vector<std::string> warnings;
-			const std::vector<std::string> information;
-        };
-
-        struct MPCORE_EXPORT MapColor : UnityEngine::Color {
-            constexpr MapColor() : UnityEngine::Color(1.0f, 1.0f, 1.0f, 1.0f) {}
-
-            constexpr MapColor(float r, float g, float b) : UnityEngine::Color(r, g, b, 1.0f) {}
-
-            inline MapColor(const rapidjson::Value& json) : UnityEngine::Color(1.0f, 1.0f, 1.0f, 1.0f) {
-                auto mEnd = json.MemberEnd();
-                GET_COL(r); GET_COL(g); GET_COL(b);
-            }
-
-            inline MapColor(LiteNetLib::Utils::NetDataReader* reader)
-                : UnityEngine::Color(reader->GetFloat(), reader->GetFloat(), reader->GetFloat(), 1.0f) {}
-
-            inline void Serialize(LiteNetLib::Utils::NetDataWriter* writer) const {
-                writer->Put(r); writer->Put(g); writer->Put(b);
-            }
-
-            inline void Deserialize(LiteNetLib::Utils::NetDataReader* reader) {
-                r = reader->GetFloat();
-                g = reader->GetFloat();
-                b = reader->GetFloat();
-                a = 1.0f;
-            }
-        };
-        static_assert(sizeof(MapColor) == sizeof(UnityEngine::Color), "Size of MapColor and UnityEngine color did not match!");
-
-        struct MPCORE_EXPORT DifficultyData {
-            DifficultyData() {}
-
-            DifficultyData(
-                std::string_view beatmapCharacteristicName,
-                GlobalNamespace::BeatmapDifficulty difficulty,
-                std::optional<std::string> difficultyLabel,
-                std::optional<RequirementData> additionalDifficultyData,
-                MapColor colorLeft,
-                MapColor colorRight,
-                MapColor envColorLeft,
-                MapColor envColorRight,
-                MapColor envColorLeftBoost,
-                MapColor envColorRightBoost,
-                MapColor obstacleColor
-            ) :
-                beatmapCharacteristicName(beatmapCharacteristicName),
-                difficultyLabel(difficultyLabel),
-                difficulty(difficulty),
-                additionalDifficultyData(additionalDifficultyData),
-                colorLeft(colorLeft),
-                colorRight(colorRight),
-                envColorLeft(envColorLeft),
-                envColorRight(envColorRight),
-                envColorLeftBoost(envColorLeftBoost),
-                envColorRightBoost(envColorRightBoost),
-                obstacleColor(obstacleColor) {}
-
-            std::string beatmapCharacteristicName;
-			std::optional<std::string> difficultyLabel;
-
-			GlobalNamespace::BeatmapDifficulty difficulty;
-			std::optional<RequirementData> additionalDifficultyData;
-
-			MapColor colorLeft;
-			MapColor colorRight;
-			MapColor envColorLeft;
-			MapColor envColorRight;
-			MapColor envColorLeftBoost;
-			MapColor envColorRightBoost;
-			MapColor obstacleColor;
-        };
-
-        std::vector<const Contributor> contributors;
-        std::string customEnvironmentName;
-        std::string customEnvironmentHash;
-        std::vector<const DifficultyData> difficulties;
-        std::string defaultCharacteristicName;
-
+    struct MPCORE_EXPORT ExtraSongData : BasicExtraSongData<UnityEngine::Color, GlobalNamespace::BeatmapDifficulty> {
         static inline std::optional<ExtraSongData> FromLevelHash(const std::string& levelId) {
             auto customPreview = RuntimeSongLoader::API::GetLevelByHash(levelId).value_or(nullptr);
             if (!customPreview) return std::nullopt;
@@ -153,5 +58,3 @@ namespace MultiplayerCore::Utils {
     };
 }
 DEFINE_IL2CPP_ARG_TYPE(::MultiplayerCore::Utils::ExtraSongData::MapColor, "UnityEngine", "Color");
-
-#undef GET_COL
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+namespace MultiplayerCore::Utils {
+    /// @brief 64 bit FNV-1a, cheap for the short names we deal with and stable across platforms
+    constexpr uint64_t Fnv1a64(std::string_view key) {
+        uint64_t hash = 0xcbf29ce484222325ull;
+        for (char c : key) {
+            hash ^= static_cast<uint8_t>(c);
+            hash *= 0x100000001b3ull;
+        }
+        return hash;
+    }
+}
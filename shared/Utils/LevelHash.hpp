@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace MultiplayerCore::Utils {
+    /// @brief level ids of custom levels are the songloader prefix followed by the map hash
+    struct LevelHash {
+        /// @brief what songloader currently uses, the game build asks songloader instead, see Utilities::HashForLevelId
+        static constexpr std::string_view CustomLevelPrefix = "custom_level_";
+
+        /// @return the hash part of a custom level id, empty if the id isn't one of a custom level
+        static constexpr std::string_view FromLevelId(std::string_view levelId, std::string_view prefix = CustomLevelPrefix) {
+            return levelId.starts_with(prefix) ? levelId.substr(prefix.size()) : std::string_view();
+        }
+
+        static inline std::string ToLevelId(std::string_view hash) {
+            std::string levelId;
+            levelId.reserve(CustomLevelPrefix.size() + hash.size());
+            levelId.append(CustomLevelPrefix).append(hash);
+            return levelId;
+        }
+
+        /// @brief hashes are hex, but beatsaver and local songs don't agree on the case
+        static constexpr bool Equals(std::string_view lhs, std::string_view rhs) {
+            if (lhs.size() != rhs.size()) return false;
+            for (std::size_t i = 0; i < lhs.size(); i++)
+                if (Lower(lhs[i]) != Lower(rhs[i])) return false;
+            return true;
+        }
+
+        /// @brief lower case hash, what caches keyed by hash store it as
+        static inline std::string Normalized(std::string_view hash) {
+            std::string normalized(hash);
+            for (auto& c : normalized) c = Lower(c);
+            return normalized;
+        }
+
+        private:
+            static constexpr char Lower(char c) { return c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c; }
+    };
+}
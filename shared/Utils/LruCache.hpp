@@ -0,0 +1,140 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+namespace MultiplayerCore::Utils {
+    /// @brief a map that holds at most capacity entries for at most ttl each, the least recently used entry goes first when it is full.
+    /// Not thread safe, the owner locks around it or uses it from one thread
+    template<typename TKey, typename TValue, typename THash = std::hash<TKey>>
+    class LruCache {
+        public:
+            using Clock = std::chrono::steady_clock;
+
+            struct Stats {
+                uint64_t hits = 0;
+                uint64_t misses = 0;
+                /// @brief lookups that found an entry past its ttl, those count as misses as well
+                uint64_t expired = 0;
+                uint64_t evictions = 0;
+                /// @brief entries removed with Erase, EraseIf or Clear
+                uint64_t invalidations = 0;
+                std::size_t entries = 0;
+                /// @brief approximate memory the entries take, the bookkeeping of the list and map included
+                std::size_t bytes = 0;
+            };
+
+            LruCache(std::size_t capacity, Clock::duration ttl) : capacity(std::max<std::size_t>(capacity, 1)), ttl(ttl) {}
+
+            /// @return the value of key, marked as used, nullptr if there is none or it expired
+            TValue* Find(const TKey& key, Clock::time_point now = Clock::now()) {
+                auto entry = index.find(key);
+                if (entry == index.end()) {
+                    stats.misses++;
+                    return nullptr;
+                }
+                if (now - entry->second->inserted > ttl) {
+                    stats.expired++;
+                    stats.misses++;
+                    Remove(entry->second);
+                    return nullptr;
+                }
+                stats.hits++;
+                order.splice(order.begin(), order, entry->second);
+                return &entry->second->value;
+            }
+
+            /// @brief add or replace the value of key, evicting the least recently used entry if the cache is full
+            TValue& Insert(const TKey& key, TValue value, Clock::time_point now = Clock::now()) {
+                if (auto entry = index.find(key); entry != index.end()) Remove(entry->second);
+                while (order.size() >= capacity) {
+                    stats.evictions++;
+                    Remove(std::prev(order.end()));
+                }
+
+                order.push_front({ key, std::move(value), now });
+                index.emplace(key, order.begin());
+                stats.bytes += EntryBytes(order.front().key);
+                stats.entries = order.size();
+                return order.front().value;
+            }
+
+            bool Erase(const TKey& key) {
+                auto entry = index.find(key);
+                if (entry == index.end()) return false;
+                stats.invalidations++;
+                Remove(entry->second);
+                return true;
+            }
+
+            /// @brief erase every entry predicate(key, value) is true for
+            /// @return how many were erased
+            template<typename TPredicate>
+            std::size_t EraseIf(TPredicate&& predicate) {
+                std::size_t erased = 0;
+                for (auto entry = order.begin(); entry != order.end();) {
+                    auto next = std::next(entry);
+                    if (predicate(std::as_const(entry->key), entry->value)) {
+                        Remove(entry);
+                        erased++;
+                    }
+                    entry = next;
+                }
+                stats.invalidations += erased;
+                return erased;
+            }
+
+            void Clear() {
+                stats.invalidations += order.size();
+                order.clear();
+                index.clear();
+                stats.entries = 0;
+                stats.bytes = 0;
+            }
+
+            void set_limits(std::size_t capacity, Clock::duration ttl) {
+                this->capacity = std::max<std::size_t>(capacity, 1);
+                this->ttl = ttl;
+                while (order.size() > this->capacity) {
+                    stats.evictions++;
+                    Remove(std::prev(order.end()));
+                }
+            }
+
+            const Stats& get_stats() const { return stats; }
+            std::size_t size() const { return order.size(); }
+
+        private:
+            struct Entry {
+                TKey key;
+                TValue value;
+                Clock::time_point inserted;
+            };
+            using Iterator = typename std::list<Entry>::iterator;
+
+            static std::size_t EntryBytes(const TKey& key) {
+                // a list node, a map node with its bucket, and what the key holds on the heap
+                std::size_t bytes = sizeof(Entry) + 2 * sizeof(void*) + sizeof(std::pair<const TKey, Iterator>) + 2 * sizeof(void*);
+                if constexpr (requires { key.capacity(); }) bytes += key.capacity();
+                return bytes;
+            }
+
+            void Remove(Iterator entry) {
+                stats.bytes -= std::min(stats.bytes, EntryBytes(entry->key));
+                index.erase(entry->key);
+                order.erase(entry);
+                stats.entries = order.size();
+            }
+
+            std::size_t capacity;
+            Clock::duration ttl;
+            std::list<Entry> order;
+            std::unordered_map<TKey, Iterator, THash> index;
+            Stats stats;
+    };
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "../_config.h"
+
+#include <cstdint>
+#include <cstddef>
+#include <span>
+
+namespace MultiplayerCore::Utils {
+    /// @brief LZ4 block format (no frame header or checksums), optionally primed with a dictionary that matches can reference
+    /// both sides have to use the exact same dictionary
+    struct MPCORE_EXPORT Lz4 {
+        /// @brief largest possible compressed size for an input of the given size
+        static constexpr std::size_t CompressBound(std::size_t size) { return size + size / 255 + 16; }
+
+        /// @brief compress src into dst
+        /// @return compressed size, or 0 if it did not fit in dst
+        static std::size_t Compress(std::span<const uint8_t> src, std::span<uint8_t> dst, std::span<const uint8_t> dictionary = {});
+
+        /// @brief decompress src into dst, dst has to be sized to the exact decompressed size
+        /// @return false if src is malformed or does not decompress to exactly dst.size() bytes
+        static bool Decompress(std::span<const uint8_t> src, std::span<uint8_t> dst, std::span<const uint8_t> dictionary = {});
+    };
+}
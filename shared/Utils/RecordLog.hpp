@@ -0,0 +1,48 @@
+#pragma once
+
+#include "../_config.h"
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <span>
+#include <vector>
+
+namespace MultiplayerCore::Utils {
+    /// @brief an append-only file of records that survives the game dying while writing it.
+    /// Magic and version, then per record: varint length, the payload, the low 32 bits of its Fnv1a64.
+    /// Reading stops at the first record that is cut short or doesn't match its checksum, everything before it is kept.
+    /// Not thread safe, the owner locks around it
+    class MPCORE_EXPORT RecordLog {
+        public:
+            using Magic = std::array<uint8_t, 4>;
+            // a record larger than this is a corrupt log
+            static constexpr std::size_t MaxRecordBytes = 64 * 1024;
+
+            RecordLog(std::filesystem::path path, Magic magic, uint8_t version);
+
+            /// @brief reads every whole record into onRecord, then opens the log for appending.
+            /// onRecord throwing std::runtime_error counts as a corrupt record
+            /// @return false if the log has to be rewritten before appending to it: it is missing, of another version, or ends in a corrupt record
+            bool Open(const std::function<void(std::span<const uint8_t>)>& onRecord);
+            /// @brief appends a record and flushes it
+            void Append(std::span<const uint8_t> payload);
+            /// @brief replaces the log with the records writeRecords appends, written next to it and renamed over it so it is never half rewritten
+            bool Rewrite(const std::function<void()>& writeRecords);
+
+            /// @brief records in the log, including ones a later record replaced
+            std::size_t get_records() const { return records; }
+            uint64_t get_bytes() const { return bytes; }
+
+        private:
+            std::filesystem::path path;
+            Magic magic;
+            uint8_t version;
+            std::ofstream file;
+            std::size_t records = 0;
+            uint64_t bytes = 0;
+            std::vector<uint8_t> header;
+    };
+}
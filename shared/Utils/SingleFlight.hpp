@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstdint>
+#include <exception>
+#include <future>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+namespace MultiplayerCore::Utils {
+    /// @brief runs one call per key at a time, everyone asking for a key while its call runs gets the same result instead of starting another.
+    /// The first caller runs the work on its own thread, the others get a shared_future of it. Once the call returns the key is free again,
+    /// so results are not kept, that is up to whoever caches them
+    template<typename TKey, typename TValue, typename THash = std::hash<TKey>>
+    class SingleFlight {
+        public:
+            struct Stats {
+                /// @brief calls that ran the work
+                uint64_t calls = 0;
+                /// @brief calls that joined one already running instead
+                uint64_t coalesced = 0;
+                std::size_t inFlight = 0;
+            };
+
+            SingleFlight() = default;
+            SingleFlight(const SingleFlight&) = delete;
+            SingleFlight& operator=(const SingleFlight&) = delete;
+
+            /// @brief runs work for key, or joins the call for key that is already running.
+            /// An exception thrown by work reaches every caller of that call
+            /// @return the result, ready when the first caller returns
+            template<typename TWork>
+            std::shared_future<TValue> Do(const TKey& key, TWork&& work) {
+                std::promise<TValue> promise;
+                {
+                    std::lock_guard lock(mutex);
+                    if (auto running = calls.find(key); running != calls.end()) {
+                        stats.coalesced++;
+                        return running->second;
+                    }
+                    calls.emplace(key, promise.get_future().share());
+                    stats.calls++;
+                }
+
+                try {
+                    promise.set_value(work());
+                } catch (...) {
+                    promise.set_exception(std::current_exception());
+                }
+
+                std::lock_guard lock(mutex);
+                auto result = std::move(calls.at(key));
+                calls.erase(key);
+                return result;
+            }
+
+            Stats get_stats() const {
+                std::lock_guard lock(mutex);
+                auto result = stats;
+                result.inFlight = calls.size();
+                return result;
+            }
+
+        private:
+            mutable std::mutex mutex;
+            std::unordered_map<TKey, std::shared_future<TValue>, THash> calls;
+            Stats stats;
+    };
+}
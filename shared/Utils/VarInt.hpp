@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+namespace MultiplayerCore::Utils {
+    /// @brief LEB128 style variable length integers, 7 bits per byte with the high bit marking continuation
+    /// works with anything that has Put(uint8_t) / GetByte(), so both LiteNetLib readers/writers and plain buffers
+    struct VarInt {
+        static constexpr std::size_t MaxBytes32 = 5;
+
+        static constexpr std::size_t Size(uint32_t value) {
+            std::size_t size = 1;
+            while (value >= 0x80) {
+                value >>= 7;
+                size++;
+            }
+            return size;
+        }
+
+        template<typename TWriter>
+        static inline void Write(TWriter writer, uint32_t value) {
+            while (value >= 0x80) {
+                writer->Put(uint8_t(value | 0x80));
+                value >>= 7;
+            }
+            writer->Put(uint8_t(value));
+        }
+
+        static inline void Write(std::vector<uint8_t>& buffer, uint32_t value) {
+            while (value >= 0x80) {
+                buffer.push_back(uint8_t(value | 0x80));
+                value >>= 7;
+            }
+            buffer.push_back(uint8_t(value));
+        }
+
+        template<typename TReader>
+        static inline uint32_t Read(TReader reader) {
+            uint32_t value = 0;
+            for (std::size_t i = 0; i < MaxBytes32; i++) {
+                uint8_t b = reader->GetByte();
+                value |= uint32_t(b & 0x7f) << (7 * i);
+                if ((b & 0x80) == 0) return value;
+            }
+            throw std::runtime_error("VarInt was longer than 5 bytes");
+        }
+    };
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace MultiplayerCore::Utils {
+    /// @brief a few worker threads for jobs too slow for the thread that has them, independent of the game types.
+    /// Jobs posted on the same strand run one at a time in the order they were posted, jobs of different strands run side by side.
+    /// The threads are detached and share the queue with the pool, so Stop never waits on a job that is stuck.
+    /// TThread is constructed like std::thread, on the game that is an il2cpp_aware_thread
+    template<typename TThread = std::thread>
+    class WorkerPool {
+        public:
+            using Job = std::function<void()>;
+
+            explicit WorkerPool(std::size_t threadCount = 2) : threadCount(std::max<std::size_t>(threadCount, 1)) {}
+            ~WorkerPool() { Stop(); }
+
+            WorkerPool(const WorkerPool&) = delete;
+            WorkerPool& operator=(const WorkerPool&) = delete;
+
+            /// @brief queue a job, the threads start with the first one
+            /// @return false once the pool is stopped, the job is dropped
+            bool Post(uint64_t strand, Job job) {
+                std::lock_guard lock(state->mutex);
+                if (state->stopped) return false;
+                if (!started) {
+                    started = true;
+                    for (std::size_t i = 0; i < threadCount; i++) TThread(&WorkerPool::Run, state).detach();
+                }
+
+                auto& queued = state->strands[strand];
+                queued.jobs.push_back(std::move(job));
+                state->pending++;
+                if (!queued.scheduled) {
+                    queued.scheduled = true;
+                    state->ready.push_back(strand);
+                    state->wake.notify_one();
+                }
+                return true;
+            }
+
+            /// @brief drop the queued jobs, the threads exit once the job they are running returns
+            void Stop() {
+                std::lock_guard lock(state->mutex);
+                state->stopped = true;
+                state->strands.clear();
+                state->ready.clear();
+                state->pending = 0;
+                state->wake.notify_all();
+            }
+
+            /// @brief jobs waiting for a thread
+            std::size_t get_pending() const {
+                std::lock_guard lock(state->mutex);
+                return state->pending;
+            }
+
+        private:
+            struct Strand {
+                std::deque<Job> jobs;
+                // waiting in ready or running on a thread, either way no other thread may pick it up
+                bool scheduled = false;
+            };
+
+            struct State {
+                mutable std::mutex mutex;
+                std::condition_variable wake;
+                std::unordered_map<uint64_t, Strand> strands;
+                std::deque<uint64_t> ready;
+                std::size_t pending = 0;
+                bool stopped = false;
+            };
+
+            static void Run(std::shared_ptr<State> state) {
+                std::unique_lock lock(state->mutex);
+                while (true) {
+                    state->wake.wait(lock, [&state]{ return state->stopped || !state->ready.empty(); });
+                    if (state->stopped) return;
+
+                    auto strand = state->ready.front();
+                    state->ready.pop_front();
+                    auto job = std::move(state->strands[strand].jobs.front());
+                    state->strands[strand].jobs.pop_front();
+                    state->pending--;
+
+                    lock.unlock();
+                    // jobs deal with their own errors, a job that throws anyway shouldn't take a thread with it
+                    try { job(); } catch (...) {}
+                    job = nullptr;
+                    lock.lock();
+
+                    // stopped while the job ran, the strand is gone already
+                    auto queued = state->strands.find(strand);
+                    if (queued == state->strands.end()) continue;
+                    if (queued->second.jobs.empty()) {
+                        state->strands.erase(queued);
+                    } else {
+                        state->ready.push_back(strand);
+                        state->wake.notify_one();
+                    }
+                }
+            }
+
+            std::size_t threadCount;
+            bool started = false;
+            std::shared_ptr<State> state = std::make_shared<State>();
+    };
+}
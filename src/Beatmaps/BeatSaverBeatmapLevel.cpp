@@ -4,7 +4,7 @@
 
 #include "lapiz/shared/utilities/MainThreadScheduler.hpp"
 #include "bsml/shared/Helpers/utilities.hpp"
-#include "songdownloader/shared/BeatSaverAPI.hpp"
+#include "Beatmaps/Providers/BeatSaverCache.hpp"
 
 DEFINE_TYPE(MultiplayerCore::Beatmaps, BeatSaverBeatmapLevel);
 
@@ -19,25 +19,27 @@ namespace MultiplayerCore::Beatmaps {
         set_levelHash(hash);
     }
 
-    BeatSaverBeatmapLevel* BeatSaverBeatmapLevel::Make(const std::string& hash, const BeatSaver::Beatmap& beatmap) {
+    BeatSaverBeatmapLevel* BeatSaverBeatmapLevel::Make(const std::string& hash, const BeatmapMetadata& metadata) {
         auto level = BeatSaverBeatmapLevel::New_ctor(hash);
-        level->beatmap = beatmap;
+        level->metadata = metadata;
         return level;
     }
 
-	StringW BeatSaverBeatmapLevel::get_songName() { return beatmap.GetMetadata().GetSongName(); }
-	StringW BeatSaverBeatmapLevel::get_songSubName() { return beatmap.GetMetadata().GetSongSubName(); }
-	StringW BeatSaverBeatmapLevel::get_songAuthorName() { return beatmap.GetMetadata().GetSongAuthorName(); }
-	StringW BeatSaverBeatmapLevel::get_levelAuthorName() { return beatmap.GetMetadata().GetLevelAuthorName(); }
-	float BeatSaverBeatmapLevel::get_beatsPerMinute() { return beatmap.GetMetadata().GetBPM(); }
-	float BeatSaverBeatmapLevel::get_songDuration() { return beatmap.GetMetadata().GetDuration(); }
+    BeatSaverBeatmapLevel* BeatSaverBeatmapLevel::Make(const std::string& hash, const BeatSaver::Beatmap& beatmap) {
+        return Make(hash, Providers::BeatSaverCache::ToMetadata(hash, beatmap));
+    }
+
+	StringW BeatSaverBeatmapLevel::get_songName() { return metadata.songName; }
+	StringW BeatSaverBeatmapLevel::get_songSubName() { return metadata.songSubName; }
+	StringW BeatSaverBeatmapLevel::get_songAuthorName() { return metadata.songAuthorName; }
+	StringW BeatSaverBeatmapLevel::get_levelAuthorName() { return metadata.levelAuthorName; }
+	float BeatSaverBeatmapLevel::get_beatsPerMinute() { return metadata.bpm; }
+	float BeatSaverBeatmapLevel::get_songDuration() { return metadata.duration; }
     ::System::Threading::Tasks::Task_1<::UnityEngine::Sprite*>* BeatSaverBeatmapLevel::GetCoverImageAsync(::System::Threading::CancellationToken cancellationToken) {
         if (!_coverImageTask) {
             _coverImageTask = StartTask<UnityEngine::Sprite*>([this](){
-                auto beatmapOpt = BeatSaver::API::GetBeatmapByHash(get_levelHash());
-                if (beatmapOpt.has_value()) {
-                    auto cover = BeatSaver::API::GetCoverImage(beatmapOpt.value());
-
+                auto cover = Providers::BeatSaverCache::GetCoverImage(get_levelHash());
+                if (!cover.empty()) {
                     auto coverBytes = il2cpp_utils::vectorToArray(cover);
                     std::optional<UnityEngine::Sprite*> result;
                     Lapiz::Utilities::MainThreadScheduler::Schedule([coverBytes, &result](){
@@ -0,0 +1,226 @@
+#include "Beatmaps/BeatmapMetadataStore.hpp"
+#include "Utils/LevelHash.hpp"
+#include "Utils/VarInt.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace MultiplayerCore::Beatmaps {
+    // a record larger than these is a corrupt log, not a map
+    static constexpr std::size_t MaxStringBytes = 4 * 1024;
+    static constexpr std::size_t MaxVersions = 64;
+    static constexpr std::size_t MaxDifficulties = 64;
+    // the log is rewritten once it holds this many records more than entries, and more records than entries
+    static constexpr std::size_t CompactSlack = 256;
+    // first byte of a record, found or missing entries and erased hashes
+    enum RecordKind : uint8_t { MissingRecord = 0, FoundRecord = 1, ErasedRecord = 2 };
+
+    namespace {
+        struct RecordReader {
+            std::span<const uint8_t> data;
+            std::size_t position = 0;
+
+            uint8_t GetByte() {
+                if (position >= data.size()) throw std::runtime_error("Metadata record is cut short");
+                return data[position++];
+            }
+
+            std::string GetString() {
+                auto length = Utils::VarInt::Read(this);
+                if (length > MaxStringBytes || length > data.size() - position) throw std::runtime_error("Metadata record string is too long");
+                std::string value(reinterpret_cast<const char*>(data.data() + position), length);
+                position += length;
+                return value;
+            }
+
+            float GetFloat() {
+                uint32_t bits = 0;
+                for (int i = 0; i < 4; i++) bits |= uint32_t(GetByte()) << (8 * i);
+                float value;
+                std::memcpy(&value, &bits, sizeof(value));
+                return value;
+            }
+        };
+
+        void PutString(std::vector<uint8_t>& record, std::string_view value) {
+            value = value.substr(0, MaxStringBytes);
+            Utils::VarInt::Write(record, value.size());
+            record.insert(record.end(), value.begin(), value.end());
+        }
+
+        void PutFloat(std::vector<uint8_t>& record, float value) {
+            uint32_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            for (int i = 0; i < 4; i++) record.push_back(uint8_t(bits >> (8 * i)));
+        }
+    }
+
+    BeatmapMetadataStore::BeatmapMetadataStore(std::filesystem::path path) : log(std::move(path), Magic, Version) {
+        std::lock_guard lock(mutex);
+        bool appendable = log.Open([this](std::span<const uint8_t> payload){
+            if (auto erased = DecodeErased(payload)) {
+                entries.erase(*erased);
+                return;
+            }
+            auto metadata = Decode(payload);
+            auto hash = metadata.hash;
+            entries.insert_or_assign(std::move(hash), std::move(metadata));
+        });
+
+        stats.entries = entries.size();
+        stats.logBytes = log.get_bytes();
+        // a log we can't append to as is gets rewritten from what we could read of it
+        if (!appendable || log.get_records() > entries.size() + CompactSlack) CompactLocked(std::chrono::system_clock::now());
+    }
+
+    void BeatmapMetadataStore::Encode(const BeatmapMetadata& metadata, std::vector<uint8_t>& record) {
+        record.push_back(metadata.found ? FoundRecord : MissingRecord);
+        auto fetched = std::chrono::duration_cast<std::chrono::seconds>(metadata.fetched.time_since_epoch()).count();
+        Utils::VarInt::Write(record, static_cast<uint32_t>(std::clamp<int64_t>(fetched, 0, UINT32_MAX)));
+        PutString(record, metadata.hash);
+        if (!metadata.found) return;
+
+        PutString(record, metadata.key);
+        PutString(record, metadata.coverUrl);
+        PutString(record, metadata.songName);
+        PutString(record, metadata.songSubName);
+        PutString(record, metadata.songAuthorName);
+        PutString(record, metadata.levelAuthorName);
+        PutFloat(record, metadata.bpm);
+        PutFloat(record, metadata.duration);
+
+        auto versionCount = std::min(metadata.versions.size(), MaxVersions);
+        Utils::VarInt::Write(record, versionCount);
+        for (std::size_t i = 0; i < versionCount; i++) {
+            auto& version = metadata.versions[i];
+            PutString(record, version.hash);
+            auto diffCount = std::min(version.diffs.size(), MaxDifficulties);
+            Utils::VarInt::Write(record, diffCount);
+            for (std::size_t j = 0; j < diffCount; j++) record.push_back(version.diffs[j].requirements);
+        }
+    }
+
+    BeatmapMetadata BeatmapMetadataStore::Decode(std::span<const uint8_t> bytes) {
+        RecordReader reader{ bytes };
+        BeatmapMetadata metadata;
+        auto kind = reader.GetByte();
+        if (kind != FoundRecord && kind != MissingRecord) throw std::runtime_error("Metadata record is not an entry");
+        metadata.found = kind == FoundRecord;
+        metadata.fetched = std::chrono::system_clock::time_point(std::chrono::seconds(Utils::VarInt::Read(&reader)));
+        metadata.hash = Utils::LevelHash::Normalized(reader.GetString());
+        if (!metadata.found) return metadata;
+
+        metadata.key = reader.GetString();
+        metadata.coverUrl = reader.GetString();
+        metadata.songName = reader.GetString();
+        metadata.songSubName = reader.GetString();
+        metadata.songAuthorName = reader.GetString();
+        metadata.levelAuthorName = reader.GetString();
+        metadata.bpm = reader.GetFloat();
+        metadata.duration = reader.GetFloat();
+
+        auto versionCount = Utils::VarInt::Read(&reader);
+        if (versionCount > MaxVersions) throw std::runtime_error("Metadata record has too many versions");
+        metadata.versions.resize(versionCount);
+        for (auto& version : metadata.versions) {
+            version.hash = reader.GetString();
+            auto diffCount = Utils::VarInt::Read(&reader);
+            if (diffCount > MaxDifficulties) throw std::runtime_error("Metadata record has too many difficulties");
+            version.diffs.resize(diffCount);
+            for (auto& diff : version.diffs) diff.requirements = reader.GetByte();
+        }
+        return metadata;
+    }
+
+    void BeatmapMetadataStore::EncodeErased(std::string_view hash, std::vector<uint8_t>& record) {
+        record.push_back(ErasedRecord);
+        PutString(record, hash);
+    }
+
+    std::optional<std::string> BeatmapMetadataStore::DecodeErased(std::span<const uint8_t> bytes) {
+        RecordReader reader{ bytes };
+        if (reader.GetByte() != ErasedRecord) return std::nullopt;
+        return Utils::LevelHash::Normalized(reader.GetString());
+    }
+
+    std::optional<BeatmapMetadata> BeatmapMetadataStore::Find(std::string_view hash, std::chrono::system_clock::time_point now) {
+        std::lock_guard lock(mutex);
+        auto entry = entries.find(Utils::LevelHash::Normalized(hash));
+        if (entry == entries.end()) {
+            stats.misses++;
+            return std::nullopt;
+        }
+        if (IsExpired(entry->second, now)) {
+            stats.expired++;
+            stats.misses++;
+            return std::nullopt;
+        }
+        stats.hits++;
+        return entry->second;
+    }
+
+    void BeatmapMetadataStore::Store(BeatmapMetadata metadata) {
+        metadata.hash = Utils::LevelHash::Normalized(metadata.hash);
+        std::lock_guard lock(mutex);
+        Append(metadata);
+        auto hash = metadata.hash;
+        entries.insert_or_assign(std::move(hash), std::move(metadata));
+        stats.stores++;
+        stats.entries = entries.size();
+        auto records = log.get_records();
+        if (records > entries.size() + CompactSlack && records > 2 * entries.size()) CompactLocked(std::chrono::system_clock::now());
+    }
+
+    void BeatmapMetadataStore::Erase(std::string_view hash) {
+        std::lock_guard lock(mutex);
+        auto entry = entries.find(Utils::LevelHash::Normalized(hash));
+        if (entry == entries.end()) return;
+
+        // the log still has the entry's record, this one supersedes it
+        record.clear();
+        EncodeErased(entry->first, record);
+        log.Append(record);
+        stats.logBytes = log.get_bytes();
+        entries.erase(entry);
+        stats.entries = entries.size();
+    }
+
+    void BeatmapMetadataStore::Append(const BeatmapMetadata& metadata) {
+        record.clear();
+        Encode(metadata, record);
+        log.Append(record);
+        stats.logBytes = log.get_bytes();
+    }
+
+    void BeatmapMetadataStore::set_ttl(std::chrono::seconds found, std::chrono::seconds missing) {
+        std::lock_guard lock(mutex);
+        foundTtl = found;
+        missingTtl = missing;
+    }
+
+    BeatmapMetadataStore::Stats BeatmapMetadataStore::get_stats() const {
+        std::lock_guard lock(mutex);
+        return stats;
+    }
+
+    bool BeatmapMetadataStore::Compact(std::chrono::system_clock::time_point now) {
+        std::lock_guard lock(mutex);
+        return CompactLocked(now);
+    }
+
+    bool BeatmapMetadataStore::IsExpired(const BeatmapMetadata& metadata, std::chrono::system_clock::time_point now) const {
+        return now - metadata.fetched > (metadata.found ? foundTtl : missingTtl);
+    }
+
+    bool BeatmapMetadataStore::CompactLocked(std::chrono::system_clock::time_point now) {
+        // Find wouldn't return them anymore, they are looked up again either way
+        std::erase_if(entries, [this, now](const auto& entry){ return IsExpired(entry.second, now); });
+        stats.entries = entries.size();
+        bool compacted = log.Rewrite([this](){
+            for (auto& [hash, metadata] : entries) Append(metadata);
+        });
+        stats.logBytes = log.get_bytes();
+        return compacted;
+    }
+}
@@ -4,7 +4,7 @@
 #include "logging.hpp"
 #include "tasks.hpp"
 
-#include "songdownloader/shared/BeatSaverAPI.hpp"
+#include "Beatmaps/Providers/BeatSaverCache.hpp"
 #include <thread>
 
 DEFINE_TYPE(MultiplayerCore::Beatmaps, NetworkBeatmapLevel);
@@ -14,20 +14,25 @@ namespace MultiplayerCore::Beatmaps {
         INVOKE_CTOR();
         INVOKE_BASE_CTOR(classof(Abstractions::MpBeatmapLevel*));
 
-        _packet = packet;
-		requirements[_packet->characteristic] = std::move(_packet->requirements);
-		difficultyColors[_packet->characteristic] = std::move(_packet->mapColors);
-		contributors = std::move(_packet->contributors);
-		set_levelHash(_packet->levelHash);
+        _songName = packet->songName;
+        _songSubName = packet->songSubName;
+        _songAuthorName = packet->songAuthorName;
+        _levelAuthorName = packet->levelAuthorName;
+        _beatsPerMinute = packet->beatsPerMinute;
+        _songDuration = packet->songDuration;
+        _characteristic = static_cast<std::string>(packet->characteristic);
+
+		requirements[_characteristic] = std::move(packet->requirements);
+		difficultyColors[_characteristic] = std::move(packet->mapColors);
+		contributors = std::move(packet->contributors);
+		set_levelHash(packet->levelHash);
     }
 
 	System::Threading::Tasks::Task_1<UnityEngine::Sprite*>* NetworkBeatmapLevel::GetCoverImageAsync(System::Threading::CancellationToken cancellationToken) {
         if (!coverImageTask) {
             coverImageTask = StartTask<UnityEngine::Sprite*>([this](){
-                auto beatmapOpt = BeatSaver::API::GetBeatmapByHash(get_levelHash());
-                if (beatmapOpt.has_value()) {
-                    auto cover = BeatSaver::API::GetCoverImage(beatmapOpt.value());
-
+                auto cover = Providers::BeatSaverCache::GetCoverImage(get_levelHash());
+                if (!cover.empty()) {
                     auto coverBytes = il2cpp_utils::vectorToArray(cover);
                     std::optional<UnityEngine::Sprite*> result;
                     Lapiz::Utilities::MainThreadScheduler::Schedule([coverBytes, &result](){
@@ -43,10 +48,10 @@ namespace MultiplayerCore::Beatmaps {
         return coverImageTask;
     }
 
-    StringW NetworkBeatmapLevel::get_songName() { return _packet->songName; }
-	StringW NetworkBeatmapLevel::get_songSubName() { return _packet->songSubName; }
-	StringW NetworkBeatmapLevel::get_songAuthorName() { return _packet->songAuthorName; }
-	StringW NetworkBeatmapLevel::get_levelAuthorName() { return _packet->levelAuthorName; }
-	float NetworkBeatmapLevel::get_beatsPerMinute() { return _packet->beatsPerMinute; }
-	float NetworkBeatmapLevel::get_songDuration() { return _packet->songDuration; }
+    StringW NetworkBeatmapLevel::get_songName() { return _songName; }
+	StringW NetworkBeatmapLevel::get_songSubName() { return _songSubName; }
+	StringW NetworkBeatmapLevel::get_songAuthorName() { return _songAuthorName; }
+	StringW NetworkBeatmapLevel::get_levelAuthorName() { return _levelAuthorName; }
+	float NetworkBeatmapLevel::get_beatsPerMinute() { return _beatsPerMinute; }
+	float NetworkBeatmapLevel::get_songDuration() { return _songDuration; }
 }
@@ -1,15 +1,22 @@
 #include "Beatmaps/Packets/MpBeatmapPacket.hpp"
+#include "Beatmaps/Packets/MpBeatmapPacketEncoding.hpp"
 #include "Beatmaps/Abstractions/MpBeatmapLevel.hpp"
+#include "Networking/DecodeLimits.hpp"
 #include "Utilities.hpp"
+#include "logging.hpp"
 
 #include "GlobalNamespace/BeatmapCharacteristicSO.hpp"
 
+#include <algorithm>
+
 DEFINE_TYPE(MultiplayerCore::Beatmaps::Packets, MpBeatmapPacket);
 
+using MultiplayerCore::Networking::DecodeLimits;
+
 namespace MultiplayerCore::Beatmaps::Packets {
     void MpBeatmapPacket::New() {
         INVOKE_CTOR();
-        INVOKE_BASE_CTOR(classof(MultiplayerCore::Networking::Abstractions::MpPacket*));
+        INVOKE_BASE_CTOR(classof(MultiplayerCore::Networking::Abstractions::MpPoolablePacket*));
     }
 
     MpBeatmapPacket* MpBeatmapPacket::New_1(GlobalNamespace::PreviewDifficultyBeatmap* beatmap) {
@@ -42,6 +49,20 @@ namespace MultiplayerCore::Beatmaps::Packets {
         return packet;
     }
 
+    bool MpBeatmapPacket::RequirementsFit() const {
+        if (requirements.size() > DecodeLimits::MaxDifficulties) return false;
+        return std::all_of(requirements.begin(), requirements.end(), [](const auto& reqs){ return reqs.second.size() <= DecodeLimits::MaxRequirementsPerDifficulty; });
+    }
+
+    void MpBeatmapPacket::LogDroppedElements() const {
+        if (!RequirementsFit())
+            ERROR("Requirements of '{}' go over what players decode, they are sent without some of them", levelHash);
+        if (contributors.size() > DecodeLimits::MaxContributors)
+            WARNING("'{}' has {} contributors, only the first {} are sent", levelHash, contributors.size(), DecodeLimits::MaxContributors);
+        if (mapColors.size() > DecodeLimits::MaxMapColors)
+            WARNING("'{}' has colors for {} difficulties, only {} are sent", levelHash, mapColors.size(), DecodeLimits::MaxMapColors);
+    }
+
     void MpBeatmapPacket::Serialize(LiteNetLib::Utils::NetDataWriter* writer) {
         writer->Put(levelHash);
         writer->Put(songName);
@@ -54,62 +75,38 @@ namespace MultiplayerCore::Beatmaps::Packets {
         writer->Put(characteristic);
         writer->Put((uint32_t)difficulty.value__);
 
-        writer->Put((uint8_t)requirements.size());
-        for (const auto& [key, value] : requirements) {
+        // never write more than receivers are willing to decode, they would drop the whole packet
+        LogDroppedElements();
+        auto difficultyCount = std::min<std::size_t>(requirements.size(), DecodeLimits::MaxDifficulties);
+        writer->Put(uint8_t(difficultyCount));
+        for (auto itr = requirements.begin(); difficultyCount > 0; itr++, difficultyCount--) {
+            const auto& [key, value] = *itr;
+            auto reqCount = std::min<std::size_t>(value.size(), DecodeLimits::MaxRequirementsPerDifficulty);
             writer->Put(uint8_t(key));
-            writer->Put(uint8_t(value.size()));
-            for (const auto& req : value)
-                writer->Put(StringW(req));
+            writer->Put(uint8_t(reqCount));
+            for (auto req = value.begin(); reqCount > 0; req++, reqCount--)
+                writer->Put(StringW(*req));
         }
 
         // on quest we can just read contributors size as it can't be null
-        writer->Put(uint8_t(contributors.size()));
-        for (const auto& [role, name, iconPath] : contributors) {
+        auto contributorCount = std::min<std::size_t>(contributors.size(), DecodeLimits::MaxContributors);
+        writer->Put(uint8_t(contributorCount));
+        for (std::size_t i = 0; i < contributorCount; i++) {
+            const auto& [role, name, iconPath] = contributors[i];
             writer->Put(StringW(role));
             writer->Put(StringW(name));
             writer->Put(StringW(iconPath));
         }
 
-        writer->Put(uint8_t(mapColors.size()));
-        for (const auto& [key, value] : mapColors) {
-            writer->Put(uint8_t(key));
-            value.Serialize(writer);
+        auto colorCount = std::min<std::size_t>(mapColors.size(), DecodeLimits::MaxMapColors);
+        writer->Put(uint8_t(colorCount));
+        for (auto itr = mapColors.begin(); colorCount > 0; itr++, colorCount--) {
+            writer->Put(uint8_t(itr->first));
+            itr->second.Serialize(writer);
         }
     }
 
     void MpBeatmapPacket::Deserialize(LiteNetLib::Utils::NetDataReader* reader) {
-        levelHash = reader->GetString();
-        songName = reader->GetString();
-        songSubName = reader->GetString();
-        songAuthorName = reader->GetString();
-        levelAuthorName = reader->GetString();
-        beatsPerMinute = reader->GetFloat();
-        songDuration = reader->GetFloat();
-
-        characteristic = reader->GetString();
-        difficulty = reader->GetUInt();
-
-        auto difficultyCount = reader->GetByte();
-        for (std::size_t i = 0; i < difficultyCount; i++) {
-            auto difficulty = reader->GetByte();
-            auto reqCount = reader->GetByte();
-            auto& reqsForDifficulty = requirements[difficulty];
-            for (std::size_t j = 0; j < reqCount; j++)
-                reqsForDifficulty.emplace_back(reader->GetString());
-        }
-
-        auto contributorCount = reader->GetByte();
-        for (std::size_t i = 0; i < contributorCount; i++)
-            contributors.emplace_back(
-                reader->GetString(),
-                reader->GetString(),
-                reader->GetString()
-            );
-
-        auto colorCount = reader->GetByte();
-        for (std::size_t i = 0; i < colorCount; i++) {
-            auto difficulty = reader->GetByte();
-            mapColors[difficulty].Deserialize(reader);
-        }
+        MpBeatmapPacketEncoding::Read(reader, *this);
     }
 }
@@ -0,0 +1,149 @@
+#include "Beatmaps/Packets/MpCompactBeatmapPacket.hpp"
+#include "Beatmaps/Packets/MpCompactBeatmapPacketEncoding.hpp"
+#include "Beatmaps/Abstractions/DifficultyColorsEncoding.hpp"
+#include "Networking/DecodeLimits.hpp"
+#include "Utils/CompactEncoding.hpp"
+
+#include <algorithm>
+#include <array>
+
+DEFINE_TYPE(MultiplayerCore::Beatmaps::Packets, MpCompactBeatmapPacket);
+
+using namespace MultiplayerCore::Utils;
+using MultiplayerCore::Beatmaps::Abstractions::DifficultyColors;
+using MultiplayerCore::Networking::DecodeLimits;
+
+namespace MultiplayerCore::Beatmaps::Packets {
+    static constexpr auto RawLevelHashFlag = MpCompactBeatmapPacketEncoding::RawLevelHashFlag;
+    static constexpr auto LevelHashBytes = MpCompactBeatmapPacketEncoding::LevelHashBytes;
+
+    // same order as the bitmask DifficultyColors uses
+    static constexpr auto& ColorMembers = Abstractions::DifficultyColorsEncoding::Members<DifficultyColors>;
+
+    static inline std::string ToString(StringW value) {
+        if (!value) return {};
+        return static_cast<std::string>(value);
+    }
+
+    void MpCompactBeatmapPacket::New() {
+        INVOKE_CTOR();
+        INVOKE_BASE_CTOR(classof(MpBeatmapPacket*));
+    }
+
+    MpCompactBeatmapPacket* MpCompactBeatmapPacket::New_1(MpBeatmapPacket* packet) {
+        auto compact = MpCompactBeatmapPacket::New_ctor();
+        compact->levelHash = packet->levelHash;
+        compact->songName = packet->songName;
+        compact->songSubName = packet->songSubName;
+        compact->songAuthorName = packet->songAuthorName;
+        compact->levelAuthorName = packet->levelAuthorName;
+        compact->beatsPerMinute = packet->beatsPerMinute;
+        compact->songDuration = packet->songDuration;
+        compact->characteristic = packet->characteristic;
+        compact->difficulty = packet->difficulty;
+        compact->requirements = packet->requirements;
+        compact->mapColors = packet->mapColors;
+        compact->contributors.reserve(packet->contributors.size());
+        for (const auto& c : packet->contributors) compact->contributors.emplace_back(c);
+        return compact;
+    }
+
+    void MpCompactBeatmapPacket::Serialize(LiteNetLib::Utils::NetDataWriter* writer) {
+        auto hash = ToString(levelHash);
+        std::array<uint8_t, LevelHashBytes> rawHash;
+        bool isRawHash = HexBytes::Decode(hash, rawHash.data(), rawHash.size());
+
+        writer->Put(uint8_t(isRawHash ? RawLevelHashFlag : 0));
+        if (isRawHash) {
+            for (auto b : rawHash) writer->Put(b);
+        } else {
+            CompactString::Write(writer, hash);
+        }
+
+        CompactString::Write(writer, ToString(songName));
+        CompactString::Write(writer, ToString(songSubName));
+        CompactString::Write(writer, ToString(songAuthorName));
+        CompactString::Write(writer, ToString(levelAuthorName));
+        writer->Put(beatsPerMinute);
+        writer->Put(songDuration);
+
+        CompactString::Write(writer, ToString(characteristic));
+        VarInt::Write(writer, uint32_t(difficulty.value__));
+
+        // never write more than receivers are willing to decode, they would drop the whole packet
+        LogDroppedElements();
+        auto difficultyCount = std::min<std::size_t>(requirements.size(), DecodeLimits::MaxDifficulties);
+        auto reqCountOf = [](const auto& reqs) { return std::min<std::size_t>(reqs.size(), DecodeLimits::MaxRequirementsPerDifficulty); };
+
+        // most difficulties of a map share the same few requirements, so each one is written once and referenced by index
+        std::vector<std::string_view> stringTable;
+        auto indexOf = [&stringTable](std::string_view value) -> uint32_t {
+            auto itr = std::find(stringTable.begin(), stringTable.end(), value);
+            if (itr != stringTable.end()) return itr - stringTable.begin();
+            stringTable.push_back(value);
+            return stringTable.size() - 1;
+        };
+        auto reqs = requirements.begin();
+        for (std::size_t i = 0; i < difficultyCount; i++, reqs++) {
+            auto req = reqs->second.begin();
+            for (std::size_t j = reqCountOf(reqs->second); j > 0; j--, req++) indexOf(*req);
+        }
+
+        VarInt::Write(writer, stringTable.size());
+        for (auto str : stringTable) CompactString::Write(writer, str);
+
+        VarInt::Write(writer, difficultyCount);
+        reqs = requirements.begin();
+        for (std::size_t i = 0; i < difficultyCount; i++, reqs++) {
+            const auto& [key, value] = *reqs;
+            auto reqCount = reqCountOf(value);
+            writer->Put(uint8_t(key));
+            VarInt::Write(writer, reqCount);
+            for (auto req = value.begin(); reqCount > 0; req++, reqCount--) VarInt::Write(writer, indexOf(*req));
+        }
+
+        auto contributorCount = std::min<std::size_t>(contributors.size(), DecodeLimits::MaxContributors);
+        VarInt::Write(writer, contributorCount);
+        for (std::size_t i = 0; i < contributorCount; i++) {
+            const auto& contributor = contributors[i];
+            CompactString::Write(writer, contributor.name);
+            CompactString::Write(writer, contributor.role);
+            CompactString::Write(writer, contributor.iconPath);
+        }
+
+        auto colorCount = std::min<std::size_t>(mapColors.size(), DecodeLimits::MaxMapColors);
+        VarInt::Write(writer, colorCount);
+        for (auto colors = mapColors.begin(); colorCount > 0; colors++, colorCount--) {
+            const auto& [key, value] = *colors;
+            // which colors are present, and which of those need half floats because they don't fit in 0..1
+            uint8_t present = 0, wide = 0;
+            for (std::size_t i = 0; i < ColorMembers.size(); i++) {
+                const auto& color = value.*ColorMembers[i];
+                if (!color.has_value()) continue;
+                present |= 1 << i;
+                if (!UnitFloat8::Fits(color->r) || !UnitFloat8::Fits(color->g) || !UnitFloat8::Fits(color->b)) wide |= 1 << i;
+            }
+
+            writer->Put(uint8_t(key));
+            writer->Put(present);
+            writer->Put(wide);
+            for (std::size_t i = 0; i < ColorMembers.size(); i++) {
+                const auto& color = value.*ColorMembers[i];
+                if (!color.has_value()) continue;
+                if (wide & (1 << i)) {
+                    writer->Put(HalfFloat::FromFloat(color->r));
+                    writer->Put(HalfFloat::FromFloat(color->g));
+                    writer->Put(HalfFloat::FromFloat(color->b));
+                } else {
+                    writer->Put(UnitFloat8::FromFloat(color->r));
+                    writer->Put(UnitFloat8::FromFloat(color->g));
+                    writer->Put(UnitFloat8::FromFloat(color->b));
+                }
+            }
+        }
+    }
+
+    void MpCompactBeatmapPacket::Deserialize(LiteNetLib::Utils::NetDataReader* reader) {
+        MpCompactBeatmapPacketEncoding::Read(reader, *this);
+    }
+}
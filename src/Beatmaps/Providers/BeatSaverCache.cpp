@@ -0,0 +1,231 @@
+#include "Beatmaps/Providers/BeatSaverCache.hpp"
+#include "Beatmaps/Providers/BeatSaverResponse.hpp"
+#include "Utils/BatchQueue.hpp"
+#include "Utils/LevelHash.hpp"
+#include "Utils/SingleFlight.hpp"
+#include "logging.hpp"
+
+#include "songdownloader/shared/BeatSaverAPI.hpp"
+#include "songdownloader/shared/WebUtils.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <unordered_map>
+
+extern modloader::ModInfo modInfo;
+
+namespace MultiplayerCore::Beatmaps::Providers {
+    // covers are about 50 kB each, the oldest ones go once there are more than this
+    static constexpr std::size_t MaxCoverFiles = 1000;
+    static constexpr std::size_t PrunedCoverFiles = 800;
+
+    // BeatSaver takes up to 50 hashes per request, a lobby joining or a quickplay rotation brings that many within a few milliseconds
+    static constexpr std::size_t MaxBatchHashes = 50;
+    static constexpr std::chrono::milliseconds BatchWindow(15);
+
+    static std::mutex apiUrlMutex;
+    static std::string apiUrl = "https://api.beatsaver.com";
+
+    /// @return a map for every hash BeatSaver has, nullopt for every hash it answered it doesn't have, nothing for the ones it didn't answer for.
+    /// Throws if BeatSaver didn't answer at all
+    static std::unordered_map<std::string, std::optional<BeatSaver::Beatmap>> FetchBeatmaps(const std::vector<std::string>& hashes) {
+        std::string list;
+        for (auto& hash : hashes) {
+            if (!list.empty()) list += ',';
+            list += hash;
+        }
+
+        std::string body;
+        auto status = WebUtils::Get(fmt::format("{}/maps/hash/{}", BeatSaverCache::get_apiUrl(), list), body);
+
+        std::unordered_map<std::string, std::optional<BeatSaver::Beatmap>> beatmaps;
+        BeatSaverResponse::ReadHashLookup(hashes, status, body,
+            [&beatmaps](const std::string& hash, const rapidjson::Value& value) {
+                // a map we can't read isn't a map BeatSaver doesn't have, it gets asked for again next time
+                try {
+                    BeatSaver::Beatmap beatmap;
+                    beatmap.Deserialize(value);
+                    beatmaps.emplace(hash, std::move(beatmap));
+                } catch (const std::exception& e) {
+                    WARNING("Couldn't read the BeatSaver map of hash {}: {}", hash, e.what());
+                }
+            },
+            [&beatmaps](const std::string& hash) { beatmaps.emplace(hash, std::nullopt); }
+        );
+        return beatmaps;
+    }
+
+    // the entitlement check, the level provider, the downloader and the covers all look a new map up at once
+    static Utils::SingleFlight<std::string, std::optional<BeatSaver::Beatmap>> beatmapRequests;
+    static Utils::SingleFlight<std::string, std::vector<uint8_t>> coverRequests;
+    static Utils::BatchQueue<std::string, std::optional<BeatSaver::Beatmap>> beatmapBatches(&FetchBeatmaps, BatchWindow, MaxBatchHashes);
+
+    static std::filesystem::path CacheDirectory() {
+        return std::filesystem::path(getDataDir(modInfo)) / "beatsaver";
+    }
+
+    static std::filesystem::path CoverDirectory() {
+        static std::once_flag pruned;
+        auto directory = CacheDirectory() / "covers";
+        std::call_once(pruned, [&directory](){
+            std::error_code error;
+            std::filesystem::create_directories(directory, error);
+
+            std::vector<std::filesystem::directory_entry> covers;
+            for (auto& entry : std::filesystem::directory_iterator(directory, error)) covers.push_back(entry);
+            if (covers.size() <= MaxCoverFiles) return;
+
+            std::sort(covers.begin(), covers.end(), [](auto& a, auto& b){ return a.last_write_time() < b.last_write_time(); });
+            for (std::size_t i = 0; i < covers.size() - PrunedCoverFiles; i++) std::filesystem::remove(covers[i].path(), error);
+            DEBUG("Removed {} old BeatSaver covers", covers.size() - PrunedCoverFiles);
+        });
+        return directory;
+    }
+
+    BeatmapMetadataStore& BeatSaverCache::get_store() {
+        static BeatmapMetadataStore store([](){
+            std::error_code error;
+            std::filesystem::create_directories(CacheDirectory(), error);
+            return CacheDirectory() / "metadata.log";
+        }());
+        return store;
+    }
+
+    BeatmapMetadata BeatSaverCache::ToMetadata(const std::string& hash, const BeatSaver::Beatmap& beatmap) {
+        BeatmapMetadata metadata;
+        metadata.hash = Utils::LevelHash::Normalized(hash);
+        metadata.found = true;
+        metadata.key = beatmap.GetId();
+
+        auto& beatmapMetadata = beatmap.GetMetadata();
+        metadata.songName = beatmapMetadata.GetSongName();
+        metadata.songSubName = beatmapMetadata.GetSongSubName();
+        metadata.songAuthorName = beatmapMetadata.GetSongAuthorName();
+        metadata.levelAuthorName = beatmapMetadata.GetLevelAuthorName();
+        metadata.bpm = beatmapMetadata.GetBPM();
+        metadata.duration = beatmapMetadata.GetDuration();
+
+        for (auto& version : beatmap.GetVersions()) {
+            // the latest version if the hash is an older one BeatSaver still knows
+            if (metadata.coverUrl.empty() || Utils::LevelHash::Normalized(version.GetHash()) == metadata.hash) metadata.coverUrl = version.GetCoverURL();
+            auto& cached = metadata.versions.emplace_back();
+            cached.hash = version.GetHash();
+            for (auto& diff : version.GetDiffs()) {
+                uint8_t requirements = 0;
+                if (diff.GetChroma()) requirements |= BeatmapMetadata::Difficulty::Chroma;
+                if (diff.GetME()) requirements |= BeatmapMetadata::Difficulty::MappingExtensions;
+                if (diff.GetNE()) requirements |= BeatmapMetadata::Difficulty::NoodleExtensions;
+                cached.diffs.push_back({ requirements });
+            }
+        }
+        metadata.fetched = std::chrono::system_clock::now();
+        return metadata;
+    }
+
+    std::optional<BeatmapMetadata> BeatSaverCache::GetMetadata(const std::string& hash) {
+        auto& store = get_store();
+        if (auto cached = store.Find(hash)) {
+            if (!cached->found) return std::nullopt;
+            return cached;
+        }
+
+        // GetBeatmap stores what it finds, and that BeatSaver doesn't have it
+        auto beatmap = GetBeatmap(hash);
+        if (!beatmap.has_value()) return std::nullopt;
+        return ToMetadata(hash, *beatmap);
+    }
+
+    std::optional<BeatSaver::Beatmap> BeatSaverCache::GetBeatmap(const std::string& hash) {
+        auto& store = get_store();
+        if (auto cached = store.Find(hash); cached && !cached->found) {
+            DEBUG("Level hash {} is known not to be on BeatSaver", hash);
+            return std::nullopt;
+        }
+
+        auto normalized = Utils::LevelHash::Normalized(hash);
+        return beatmapRequests.Do(normalized, [&store, &hash, &normalized]() -> std::optional<BeatSaver::Beatmap> {
+            std::optional<std::optional<BeatSaver::Beatmap>> answer;
+            try {
+                answer = beatmapBatches.Get(normalized);
+            } catch (const std::exception& e) {
+                WARNING("Couldn't look level hash {} up on BeatSaver: {}", hash, e.what());
+                return std::nullopt;
+            }
+            // only what BeatSaver actually answered is stored, a timeout or an unreadable map is asked for again next time
+            if (!answer.has_value()) return std::nullopt;
+            if (answer->has_value()) {
+                store.Store(ToMetadata(hash, **answer));
+            } else {
+                BeatmapMetadata missing;
+                missing.hash = hash;
+                missing.fetched = std::chrono::system_clock::now();
+                store.Store(std::move(missing));
+            }
+            return *answer;
+        }).get();
+    }
+
+    std::vector<uint8_t> BeatSaverCache::GetCoverImage(const std::string& hash) {
+        auto path = CoverDirectory() / Utils::LevelHash::Normalized(hash);
+        {
+            std::ifstream in(path, std::ios::binary);
+            if (in) {
+                std::vector<uint8_t> cover(std::istreambuf_iterator<char>(in), {});
+                if (!cover.empty()) return cover;
+            }
+        }
+
+        return coverRequests.Do(Utils::LevelHash::Normalized(hash), [&hash, &path](){
+            // a cached map has its cover url, only a map we haven't seen yet is looked up for it
+            auto metadata = GetMetadata(hash);
+            if (!metadata.has_value() || metadata->coverUrl.empty()) return std::vector<uint8_t>();
+            std::string body;
+            auto status = WebUtils::Get(metadata->coverUrl, body);
+            if (status != BeatSaverResponse::HttpOk) {
+                WARNING("Couldn't download the cover of level hash {}, status {}", hash, status);
+                return std::vector<uint8_t>();
+            }
+            std::vector<uint8_t> cover(body.begin(), body.end());
+            if (cover.empty()) return cover;
+
+            // written next to it and renamed, so a reader never sees half a cover
+            auto temporary = path;
+            temporary += ".tmp";
+            {
+                std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+                out.write(reinterpret_cast<const char*>(cover.data()), cover.size());
+            }
+            std::error_code error;
+            std::filesystem::rename(temporary, path, error);
+            if (error) std::filesystem::remove(temporary, error);
+            return cover;
+        }).get();
+    }
+
+    BeatSaverCache::RequestStats BeatSaverCache::get_requestStats() {
+        auto beatmaps = beatmapRequests.get_stats();
+        auto covers = coverRequests.get_stats();
+        auto batches = beatmapBatches.get_stats();
+
+        RequestStats stats;
+        stats.requests = batches.batches + covers.calls;
+        stats.coalesced = beatmaps.coalesced + covers.coalesced;
+        stats.batched = batches.lookups - batches.batches;
+        stats.inFlight = beatmaps.inFlight + covers.inFlight;
+        return stats;
+    }
+
+    std::string BeatSaverCache::get_apiUrl() {
+        std::lock_guard lock(apiUrlMutex);
+        return apiUrl;
+    }
+
+    void BeatSaverCache::set_apiUrl(std::string url) {
+        while (!url.empty() && url.back() == '/') url.pop_back();
+        std::lock_guard lock(apiUrlMutex);
+        apiUrl = std::move(url);
+    }
+}
@@ -0,0 +1,41 @@
+#include "Beatmaps/Providers/BeatSaverResponse.hpp"
+#include "Utils/LevelHash.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace MultiplayerCore::Beatmaps::Providers {
+    void BeatSaverResponse::ReadHashLookup(std::span<const std::string> hashes, long status, std::string_view body, const MapCallback& onMap, const MissingCallback& onMissing) {
+        if (hashes.empty()) return;
+
+        // a single unknown hash is answered with a 404
+        if (status == HttpNotFound && hashes.size() == 1) {
+            onMissing(Utils::LevelHash::Normalized(hashes.front()));
+            return;
+        }
+        if (status != HttpOk) throw std::runtime_error("BeatSaver answered with status " + std::to_string(status));
+
+        rapidjson::Document json;
+        json.Parse(body.data(), body.size());
+        if (json.HasParseError() || !json.IsObject()) throw std::runtime_error("BeatSaver answered with something other than a json object");
+        if (json.FindMember("error") != json.MemberEnd()) throw std::runtime_error("BeatSaver answered with an error");
+
+        if (hashes.size() == 1) {
+            onMap(Utils::LevelHash::Normalized(hashes.front()), json);
+            return;
+        }
+
+        std::vector<std::string> asked;
+        asked.reserve(hashes.size());
+        for (auto& hash : hashes) asked.push_back(Utils::LevelHash::Normalized(hash));
+
+        for (auto& member : json.GetObject()) {
+            auto hash = Utils::LevelHash::Normalized({ member.name.GetString(), member.name.GetStringLength() });
+            if (std::find(asked.begin(), asked.end(), hash) == asked.end()) continue;
+            if (member.value.IsNull()) onMissing(hash);
+            else if (member.value.IsObject()) onMap(hash, member.value);
+        }
+    }
+}
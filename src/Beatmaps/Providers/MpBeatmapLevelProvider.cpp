@@ -6,7 +6,7 @@
 
 #include "beatsaber-hook/shared/utils/il2cpp-utils.hpp"
 #include "songloader/shared/API.hpp"
-#include "songdownloader/shared/BeatSaverAPI.hpp"
+#include "Beatmaps/Providers/BeatSaverCache.hpp"
 
 DEFINE_TYPE(MultiplayerCore::Beatmaps::Providers, MpBeatmapLevelProvider);
 
@@ -29,7 +29,7 @@ namespace MultiplayerCore::Beatmaps::Providers {
     }
 
     GlobalNamespace::IPreviewBeatmapLevel* MpBeatmapLevelProvider::GetBeatmapFromBeatSaver(std::string levelHash) {
-        auto beatmap = BeatSaver::API::GetBeatmapByHash(static_cast<std::string>(levelHash));
+        auto beatmap = BeatSaverCache::GetMetadata(levelHash);
         if (beatmap.has_value()) {
             return BeatSaverBeatmapLevel::Make(levelHash, beatmap.value())->i_IPreviewBeatmapLevel();
         }
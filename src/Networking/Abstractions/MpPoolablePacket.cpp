@@ -0,0 +1,42 @@
+#include "Networking/Abstractions/MpPoolablePacket.hpp"
+
+#include <unordered_map>
+#include <vector>
+
+DEFINE_TYPE(MultiplayerCore::Networking::Abstractions, MpPoolablePacket);
+
+namespace MultiplayerCore::Networking::Abstractions {
+    void MpPoolablePacket::ctor() {
+        INVOKE_CTOR();
+        INVOKE_BASE_CTOR(classof(MpPacket*));
+        retained = false;
+        pooled = false;
+    }
+
+    void MpPoolablePacket::Release() {
+        if (retained) return;
+        MpPacketPool::Return(this);
+    }
+
+    // handlers run on whatever thread received the packet, so like the game's ThreadStaticPacketPool each thread gets its own pool
+    static thread_local std::unordered_map<Il2CppClass*, std::vector<SafePtr<MpPoolablePacket>>> pools;
+
+    MpPoolablePacket* MpPacketPool::Obtain(Il2CppClass* packetClass) {
+        auto pool = pools.find(packetClass);
+        if (pool == pools.end() || pool->second.empty()) return nullptr;
+
+        MpPoolablePacket* packet = pool->second.back().ptr();
+        pool->second.pop_back();
+        packet->retained = false;
+        packet->pooled = false;
+        return packet;
+    }
+
+    void MpPacketPool::Return(MpPoolablePacket* packet) {
+        if (!packet || packet->pooled) return;
+        auto& pool = pools[packet->klass];
+        if (pool.size() >= MaxPooledPerClass) return;
+        packet->pooled = true;
+        pool.emplace_back(packet);
+    }
+}
@@ -0,0 +1,8 @@
+#include "Networking/DecodeLimits.hpp"
+
+namespace MultiplayerCore::Networking {
+    ElementBudget& ElementBudget::get() {
+        static ElementBudget budget;
+        return budget;
+    }
+}
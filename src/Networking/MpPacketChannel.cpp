@@ -0,0 +1,95 @@
+#include "Networking/MpPacketChannel.hpp"
+#include "Networking/DecodeLimits.hpp"
+
+#include <chrono>
+
+using BudgetVerdict = MultiplayerCore::Networking::DecodeBudget<GlobalNamespace::IConnectedPlayer*>::Verdict;
+
+namespace MultiplayerCore::Networking {
+    MpPacketChannel::MpPacketChannel(MpPacketSerializer* serializer, std::string name, uint32_t id) : serializer(serializer), name(std::move(name)), id(id) {}
+
+    std::string MpPacketChannel::WireName(std::string_view packetName) const {
+        std::string wireName;
+        wireName.reserve(name.size() + 1 + packetName.size());
+        wireName.append(name).push_back(Separator);
+        wireName.append(packetName);
+        return wireName;
+    }
+
+    bool MpPacketChannel::RegisterHandler(Il2CppClass* packetClass, Il2CppReflectionType* packetType, std::string_view packetName, PacketHandler handler) {
+        auto wireName = WireName(packetName);
+        auto key = KeyOf(wireName);
+        if (!serializer->AssignChannel(packetClass, this, wireName)) return false;
+
+        // the serializer dispatches to the channel, which keeps the actual handler
+        bool registered = serializer->RegisterHandler(packetClass, packetType, key, wireName, wireName, [this, key](LiteNetLib::Utils::NetDataReader* reader, int length, GlobalNamespace::IConnectedPlayer* player){
+            Dispatch(key, reader, length, player);
+        });
+        if (!registered) return false;
+
+        serializer->channelPackets.set(key, wireName, this);
+        handlers.set(key, wireName, Handler{ std::move(handler), metrics->ForPacket(packetName) });
+        return true;
+    }
+
+    void MpPacketChannel::UnregisterHandler(Il2CppReflectionType* packetType, std::string_view packetName) {
+        auto key = KeyOf(WireName(packetName));
+        handlers.erase(key);
+        serializer->channelPackets.erase(key);
+        serializer->packetHandlers.erase(key);
+        serializer->DeactivateAsyncHandler(key);
+        serializer->registeredTypes.erase(packetType);
+    }
+
+    bool MpPacketChannel::Claim(Il2CppClass* packetClass, std::string_view packetName) {
+        return serializer->AssignChannel(packetClass, this, WireName(packetName));
+    }
+
+    void MpPacketChannel::Dispatch(PacketKey packetKey, LiteNetLib::Utils::NetDataReader* reader, int length, GlobalNamespace::IConnectedPlayer* player) {
+        auto handler = handlers.find(packetKey);
+        if (!handler || !handler->handle) return;
+
+        auto sender = GetSenderMetrics(player);
+        metrics->RecordReceived(handler->metrics, sender, length);
+
+        auto now = std::chrono::steady_clock::now();
+        if (decodeBudget.CheckSender(player, now) != BudgetVerdict::Accept || decodeBudget.CheckPacket(player, packetKey, length, now) != BudgetVerdict::Accept) {
+            metrics->RecordDropped(handler->metrics, sender);
+            // the serializer counts it as dropped as well and skips what's left of it
+            throw DecodeLimitExceeded("Packet exceeds the budget of its channel");
+        }
+
+        try {
+            handler->handle(reader, length, player);
+        } catch (const DecodeLimitExceeded&) {
+            metrics->RecordDropped(handler->metrics, sender);
+            throw;
+        }
+        metrics->RecordHandled(handler->metrics, std::chrono::steady_clock::now() - now);
+    }
+
+    void MpPacketChannel::RecordSent(std::string_view wireName, std::size_t bytes) {
+        metrics->RecordSent(metrics->ForPacket(wireName.substr(name.size() + 1)), bytes);
+    }
+
+    SenderMetrics* MpPacketChannel::GetSenderMetrics(GlobalNamespace::IConnectedPlayer* player) {
+        if (!player) return nullptr;
+        auto existing = senderMetrics.find(player);
+        if (existing != senderMetrics.end()) return existing->second;
+
+        auto userId = player->get_userId();
+        auto sender = metrics->ForSender(userId ? static_cast<std::string>(userId) : std::string());
+        senderMetrics.emplace(player, sender);
+        return sender;
+    }
+
+    void MpPacketChannel::RemovePeer(GlobalNamespace::IConnectedPlayer* player) {
+        decodeBudget.RemovePeer(player);
+        if (senderMetrics.erase(player)) MpPacketSerializer::RemoveSenderMetrics(*metrics, player);
+    }
+
+    void MpPacketChannel::ClearPeers() {
+        decodeBudget.clear();
+        senderMetrics.clear();
+    }
+}
@@ -1,58 +1,825 @@
 #include "Networking/MpPacketSerializer.hpp"
+#include "Networking/MpPacketChannel.hpp"
+#include "Networking/Packets/MpPacketRegistryPacket.hpp"
+#include "Networking/Packets/MpPacketRegistryAckPacket.hpp"
+#include "Networking/Packets/MpPacketBatch.hpp"
+#include "Networking/Packets/MpPacketChunk.hpp"
+#include "Networking/Packets/MpScheduledFrame.hpp"
+#include "Networking/PacketDispatch.hpp"
+#include "Networking/PacketFraming.hpp"
+#include "Utils/VarInt.hpp"
 #include "logging.hpp"
 
+#include "bsml/shared/Helpers/delegates.hpp"
+#include "lapiz/shared/utilities/MainThreadScheduler.hpp"
+
 #include "System/Type.hpp"
+
+#include <algorithm>
+#include <deque>
+#include <fstream>
+#include <unordered_set>
 DEFINE_TYPE(MultiplayerCore::Networking, MpPacketSerializer);
 
+using namespace MultiplayerCore::Networking::Packets;
+
+// set while a targeted send is serializing, the session manager serializes on the calling thread
+static thread_local GlobalNamespace::IConnectedPlayer* sendTarget = nullptr;
+
 namespace MultiplayerCore::Networking {
+    struct MpPacketSerializer::Batches {
+        // keep batches comfortably below a single MTU
+        static constexpr std::size_t MaxBytes = 1000;
+
+        struct QueuedPacket {
+            Il2CppClass* packetClass;
+            std::vector<uint8_t> data;
+        };
+
+        struct Queue {
+            std::vector<QueuedPacket> packets;
+            std::size_t byteCount = 0;
+            std::chrono::steady_clock::time_point firstQueued;
+            // of its most urgent packet
+            PacketPriority priority = PacketPriority::Low;
+        };
+
+        static void Flush(MpPacketSerializer& serializer, Queue& queue, bool reliable);
+
+        bool enabled = false;
+        std::chrono::milliseconds window{0};
+        std::unordered_set<Il2CppClass*> coalescedTypes;
+        std::mutex mutex;
+        Queue reliableQueue;
+        Queue unreliableQueue;
+    };
+
+    struct MpPacketSerializer::Transfers {
+        // stay below a single MTU, including the chunk header
+        static constexpr std::size_t MaxUnchunkedBytes = 1000;
+        static constexpr std::size_t ChunkBytes = 960;
+        // chunks sent per Tick across all outgoing transfers, round robin among the most urgent ones
+        static constexpr std::size_t ChunksPerTick = 4;
+
+        struct Outgoing {
+            uint32_t id;
+            SafePtr<Array<uint8_t>> data;
+            uint32_t sent;
+            // nullptr for the whole lobby
+            GlobalNamespace::IConnectedPlayer* target;
+            PacketPriority priority;
+        };
+
+        /// @brief sends this frame's chunks
+        static void Send(MpPacketSerializer& serializer);
+
+        std::unordered_set<Il2CppClass*> chunkedTypes;
+        std::mutex mutex;
+        std::deque<Outgoing> outgoing;
+        uint32_t nextId = 0;
+    };
+
     void MpPacketSerializer::ctor(GlobalNamespace::IMultiplayerSessionManager* sessionManager) {
         INVOKE_CTOR();
         _sessionManager = il2cpp_utils::try_cast<GlobalNamespace::MultiplayerSessionManager>(sessionManager).value_or(nullptr);
+        batches = std::make_shared<Batches>();
+        transfers = std::make_shared<Transfers>();
     }
 
     void MpPacketSerializer::Initialize() {
         _sessionManager->RegisterSerializer(GlobalNamespace::MultiplayerSessionManager::MessageType(ID), this->i_INetworkPacketSubSerializer_1_IConnectedPlayer());
+
+        RegisterCallback<MpPacketRegistryPacket*>(
+            std::bind(&MpPacketSerializer::HandlePacketRegistry, this, std::placeholders::_1, std::placeholders::_2)
+        );
+        RegisterCallback<MpPacketRegistryAckPacket*>(
+            std::bind(&MpPacketSerializer::HandlePacketRegistryAck, this, std::placeholders::_1, std::placeholders::_2)
+        );
+
+        // batches are unpacked straight from the reader instead of going through a packet instance
+        batchPacketName = PacketNameOf<MpPacketBatch*>;
+        RegisterHandler(classof(MpPacketBatch*), reinterpret_cast<Il2CppReflectionType*>(csTypeOf(MpPacketBatch*)), PacketKeyOf<MpPacketBatch*>, batchPacketName, batchPacketName,
+            [this](LiteNetLib::Utils::NetDataReader* reader, int length, GlobalNamespace::IConnectedPlayer* player){ PacketDispatch::Batch(*this, reader, length, player); });
+        _batchWriter = LiteNetLib::Utils::NetDataWriter::New_ctor();
+
+        // chunks are reassembled straight from the reader as well
+        chunkPacketName = PacketNameOf<MpPacketChunk*>;
+        RegisterHandler(classof(MpPacketChunk*), reinterpret_cast<Il2CppReflectionType*>(csTypeOf(MpPacketChunk*)), PacketKeyOf<MpPacketChunk*>, chunkPacketName, chunkPacketName,
+            [this](LiteNetLib::Utils::NetDataReader* reader, int length, GlobalNamespace::IConnectedPlayer* player){ PacketDispatch::Chunk(*this, reader, length, player); });
+        _chunkWriter = LiteNetLib::Utils::NetDataWriter::New_ctor();
+
+        // queued frames go through the session manager like any of our packets, but have no handler
+        registeredTypes.insert(reinterpret_cast<Il2CppReflectionType*>(csTypeOf(MpScheduledFrame*)));
+        _scheduleWriter = LiteNetLib::Utils::NetDataWriter::New_ctor();
+        // a new player can't get compact ids, or anything chunked or batched, until their registry went through
+        SetPriority(classof(MpPacketRegistryPacket*), PacketPriority::High);
+        SetPriority(classof(MpPacketRegistryAckPacket*), PacketPriority::High);
+
+        _playerConnectedAction = BSML::MakeSystemAction<GlobalNamespace::IConnectedPlayer*>(
+            std::function<void(GlobalNamespace::IConnectedPlayer*)>(
+                std::bind(&MpPacketSerializer::HandlePlayerConnected, this, std::placeholders::_1)
+            )
+        );
+        _playerDisconnectedAction = BSML::MakeSystemAction<GlobalNamespace::IConnectedPlayer*>(
+            std::function<void(GlobalNamespace::IConnectedPlayer*)>(
+                std::bind(&MpPacketSerializer::HandlePlayerDisconnected, this, std::placeholders::_1)
+            )
+        );
+        _sessionManager->add_playerConnectedEvent(_playerConnectedAction);
+        _sessionManager->add_playerDisconnectedEvent(_playerDisconnectedAction);
     }
 
     void MpPacketSerializer::Dispose() {
         _sessionManager->UnregisterSerializer(GlobalNamespace::MultiplayerSessionManager::MessageType(ID), this->i_INetworkPacketSubSerializer_1_IConnectedPlayer());
+
+        if (_playerConnectedAction) _sessionManager->remove_playerConnectedEvent(_playerConnectedAction);
+        if (_playerDisconnectedAction) _sessionManager->remove_playerDisconnectedEvent(_playerDisconnectedAction);
+        _playerConnectedAction = nullptr;
+        _playerDisconnectedAction = nullptr;
+
+        UnregisterCallback<MpPacketRegistryPacket*>();
+        UnregisterCallback<MpPacketRegistryAckPacket*>();
+        UnregisterCallback<MpPacketBatch*>();
+        UnregisterCallback<MpPacketChunk*>();
+        registeredTypes.erase(reinterpret_cast<Il2CppReflectionType*>(csTypeOf(MpScheduledFrame*)));
+
+        {
+            std::lock_guard lock(batches->mutex);
+            batches->reliableQueue = {};
+            batches->unreliableQueue = {};
+        }
+        {
+            std::lock_guard lock(payloadCacheMutex);
+            payloadCache.clear();
+        }
+        {
+            std::lock_guard lock(transfers->mutex);
+            transfers->outgoing.clear();
+        }
+        {
+            std::lock_guard lock(sendQueueMutex);
+            sendScheduler.clear();
+        }
+        {
+            // work that is still running finishes, but its results aren't applied anymore
+            std::lock_guard lock(asyncHandlerMutex);
+            for (auto& [key, active] : asyncHandlers) *active = false;
+            asyncHandlers.clear();
+        }
+        workers.Stop();
+        incomingTransfers.clear();
+        decodeBudget.clear();
+        senderMetrics.clear();
+        for (auto& channel : channels) channel->ClearPeers();
+        capture.Stop();
+
+        packetRegistry.ClearPeers();
     }
 
     void MpPacketSerializer::Serialize(LiteNetLib::Utils::NetDataWriter* writer, LiteNetLib::Utils::INetSerializable* packet) {
-        auto packetType = reinterpret_cast<System::Object*>(packet)->GetType();
-        writer->Put(packetType->NameOrDefault);
-        packet->Serialize(writer);
+        auto packetClass = reinterpret_cast<Il2CppObject*>(packet)->klass;
+        // framed, counted and captured when it was queued
+        static auto scheduledFrameClass = classof(MpScheduledFrame*);
+        if (packetClass == scheduledFrameClass) {
+            reinterpret_cast<MpScheduledFrame*>(packet)->Serialize(writer);
+            return;
+        }
+
+        // if every receiver knows this packet's id we can send a null name followed by the id instead of the full name
+        uint32_t limit = packetRegistry.LimitFor(sendTarget);
+
+        int frameStart = writer->get_Length();
+        std::string_view packetName;
+        std::string unregisteredName;
+
+        auto packetId = packetRegistry.IdOf(packetClass);
+        int payloadStart;
+        uint8_t frameFlags = PacketFraming::FramePlain;
+        // unregistered packets have NoId, which is never below the limit
+        if (packetId < limit) {
+            packetName = packetRegistry.NameOf(packetId);
+            int flagPosition = PacketFraming::WriteCompactHeader(writer, packetId);
+            payloadStart = writer->get_Length();
+            SerializePayload(writer, packet);
+            if (compressedTypes.contains(packetClass)) CompressPayload(writer, flagPosition, payloadStart);
+            frameFlags = writer->get_Data()[flagPosition];
+        } else {
+            // registered packets know their name already, only packets nobody registered a handler for need their type asked for it
+            packetName = packetRegistry.NameOf(packetId);
+            if (packetName.empty()) packetName = unregisteredName = static_cast<std::string>(reinterpret_cast<System::Object*>(packet)->GetType()->NameOrDefault);
+            PacketFraming::WriteNameHeader(writer, packetName);
+            payloadStart = writer->get_Length();
+            SerializePayload(writer, packet);
+        }
+
+        // chunked transfers are counted once they are queued, TrySendChunked may still decide to send the packet normally
+        if (writer == _chunkWriter) return;
+        metrics->RecordSent(metrics->ForPacket(packetName), writer->get_Length() - frameStart);
+        if (!channelTypes.empty()) {
+            if (auto channel = ChannelOf(packetClass)) channel->RecordSent(packetName, writer->get_Length() - frameStart);
+        }
+        if (capture.get_active())
+            CapturePacket(CapturedPacket::Direction::Outbound, sendTarget, packetName, frameFlags, { writer->get_Data().begin() + payloadStart, std::size_t(writer->get_Length() - payloadStart) });
     }
 
     void MpPacketSerializer::Deserialize(LiteNetLib::Utils::NetDataReader* reader, int length, GlobalNamespace::IConnectedPlayer* data) {
-        std::string packetId = "null";
-        auto prevPosition = reader->get_Position();
+        PacketDispatch::Receive(*this, reader, length, data);
+    }
+
+    void MpPacketSerializer::OnPacketError(GlobalNamespace::IConnectedPlayer* player, std::string_view packetId, const std::exception& e) {
+        std::string user;
+        if (player) {
+            if (player->get_userName())
+                user += static_cast<std::string>(player->get_userName());
+            if (!user.empty() && player->get_userId()) user += "|";
+            if (player->get_userId())
+                user += static_cast<std::string>(player->get_userId());
+        }
+        WARNING("An exception was thrown processing packet from player {}, packet {}: {}", user, packetId, e.what());
+    }
+
+    void MpPacketSerializer::Tick() {
+        Transfers::Send(*this);
+        ExpireIncomingTransfers();
+        capture.Flush();
+
+        if (metricsDumpInterval.count() > 0 && std::chrono::steady_clock::now() - lastMetricsDump >= metricsDumpInterval) {
+            lastMetricsDump = std::chrono::steady_clock::now();
+            DumpMetrics();
+        }
+
+        if (batches->enabled) {
+            std::lock_guard lock(batches->mutex);
+            auto now = std::chrono::steady_clock::now();
+            if (!batches->reliableQueue.packets.empty() && now - batches->reliableQueue.firstQueued >= batches->window) Batches::Flush(*this, batches->reliableQueue, true);
+            if (!batches->unreliableQueue.packets.empty() && now - batches->unreliableQueue.firstQueued >= batches->window) Batches::Flush(*this, batches->unreliableQueue, false);
+        }
+
+        // last, so chunks and batches of this frame already compete for its budget
+        DrainSendQueue();
+    }
+
+    bool MpPacketSerializer::HandlesType(Il2CppReflectionType* type) {
+        return registeredTypes.contains(type);
+    }
+
+    bool MpPacketSerializer::RegisterHandler(Il2CppClass* packetClass, Il2CppReflectionType* packetType, PacketKey handlerKey, std::string_view handlerName, const std::string& packetName, PacketHandler handler) {
+        if (!packetHandlers.set(handlerKey, handlerName, std::move(handler))) {
+            // two names on one 64 bit key, the packets of one of them would end up in the handler of the other
+            ERROR("Packet name {} has the same key as {}, its handler is not registered", handlerName, packetHandlers.nameOf(handlerKey));
+            return false;
+        }
+        registeredTypes.insert(packetType);
+        RegisterPacketId(packetClass, packetName);
+        return true;
+    }
+
+    MpPacketChannel* MpPacketSerializer::GetChannel(std::string_view name) {
+        if (name.empty() || name.find(MpPacketChannel::Separator) != std::string_view::npos) {
+            ERROR("'{}' is not a valid packet channel name", name);
+            return nullptr;
+        }
+
+        auto existing = std::find_if(channels.begin(), channels.end(), [name](auto& channel){ return channel->get_name() == name; });
+        if (existing != channels.end()) return existing->get();
+        return channels.emplace_back(std::make_shared<MpPacketChannel>(this, std::string(name), channels.size() + 1)).get();
+    }
+
+    MpPacketChannel* MpPacketSerializer::ChannelOf(Il2CppClass* packetClass) const {
+        auto channel = channelTypes.find(packetClass);
+        return channel != channelTypes.end() ? channel->second : nullptr;
+    }
+
+    bool MpPacketSerializer::AssignChannel(Il2CppClass* packetClass, MpPacketChannel* channel, const std::string& wireName) {
+        auto id = packetRegistry.IdOf(packetClass);
+        if (id != PacketRegistry<Il2CppClass*, GlobalNamespace::IConnectedPlayer*>::NoId && packetRegistry.NameOf(id) != wireName) {
+            ERROR("Packet {} is already registered as {}, it can't be sent on channel {}", wireName, packetRegistry.NameOf(id), channel->get_name());
+            return false;
+        }
+        channelTypes[packetClass] = channel;
+        RegisterPacketId(packetClass, wireName);
+        return true;
+    }
+
+    void MpPacketSerializer::RegisterPacketId(Il2CppClass* packetClass, const std::string& packetName) {
+        if (!packetRegistry.Register(packetClass, packetName)) return;
+
+        // late registrations need to be announced to everyone already in the lobby
+        if (_sessionManager && _sessionManager->get_connectedPlayerCount() > 0)
+            SendPacketRegistry();
+    }
+
+    void MpPacketSerializer::SendPacketRegistry() {
+        auto packet = MpPacketRegistryPacket::New_ctor();
+        packet->packetNames = packetRegistry.get_names();
+        Send(packet);
+    }
+
+    void MpPacketSerializer::UpdateCompactPacketIdLimit() {
+        std::vector<GlobalNamespace::IConnectedPlayer*> players;
+        int playerCount = _sessionManager ? _sessionManager->get_connectedPlayerCount() : 0;
+        players.reserve(playerCount);
+        for (int i = 0; i < playerCount; i++) players.push_back(_sessionManager->GetConnectedPlayer(i));
+
+        if (packetRegistry.UpdateLimit(players))
+            DEBUG("Compact packet ids now used for {} of {} packet types", packetRegistry.get_compactLimit(), packetRegistry.get_names().size());
+    }
+
+    void MpPacketSerializer::HandlePlayerConnected(GlobalNamespace::IConnectedPlayer* player) {
+        // new players never know our ids yet, so fall back to names until they acknowledge
+        UpdateCompactPacketIdLimit();
+
+        // everyone else already has our registry, only the new player needs it
+        auto packet = MpPacketRegistryPacket::New_ctor();
+        packet->packetNames = packetRegistry.get_names();
+        SendTo(player, packet);
+    }
+
+    void MpPacketSerializer::HandlePlayerDisconnected(GlobalNamespace::IConnectedPlayer* player) {
+        packetRegistry.RemovePeer(player);
+        incomingTransfers.RemovePeer(player);
+        decodeBudget.RemovePeer(player);
+        if (senderMetrics.erase(player)) RemoveSenderMetrics(*metrics, player);
+        for (auto& channel : channels) channel->RemovePeer(player);
+        {
+            std::lock_guard lock(transfers->mutex);
+            std::erase_if(transfers->outgoing, [player](auto& x){ return x.target == player; });
+        }
+        {
+            std::lock_guard lock(sendQueueMutex);
+            sendScheduler.RemoveTarget(player);
+        }
+        UpdateCompactPacketIdLimit();
+    }
+
+    void MpPacketSerializer::HandlePacketRegistry(MpPacketRegistryPacket* packet, GlobalNamespace::IConnectedPlayer* player) {
+        auto ack = MpPacketRegistryAckPacket::New_ctor();
+        ack->packetCount = packet->packetNames.size();
+        SendTo(player, ack);
+
+        // replaced last, the packet id of the frame being dispatched may still point into the old registry
+        packetRegistry.SetIncoming(player, std::move(packet->packetNames));
+    }
+
+    void MpPacketSerializer::HandlePacketRegistryAck(MpPacketRegistryAckPacket* packet, GlobalNamespace::IConnectedPlayer* player) {
+        packetRegistry.Acknowledge(player, packet->packetCount);
+        UpdateCompactPacketIdLimit();
+    }
+}
+
+namespace MultiplayerCore::Networking {
+    void MpPacketSerializer::set_batchingEnabled(bool value) {
+        batches->enabled = value;
+        if (!value) FlushBatches();
+    }
+
+    bool MpPacketSerializer::get_batchingEnabled() const { return batches->enabled; }
+
+    void MpPacketSerializer::set_batchWindow(std::chrono::milliseconds value) { batches->window = value; }
+    std::chrono::milliseconds MpPacketSerializer::get_batchWindow() const { return batches->window; }
+
+    void MpPacketSerializer::SetCoalescing(Il2CppClass* packetClass, bool coalesce) {
+        if (coalesce) batches->coalescedTypes.insert(packetClass);
+        else batches->coalescedTypes.erase(packetClass);
+    }
+
+    void MpPacketSerializer::SendToPlayer(LiteNetLib::Utils::INetSerializable* packet, GlobalNamespace::IConnectedPlayer* player) {
+        sendTarget = player;
         try {
-            packetId = static_cast<std::string>(reader->GetString());
-            length -= reader->get_Position() - prevPosition;
-            prevPosition = reader->get_Position();
+            _sessionManager->SendToPlayer(packet, player);
+        } catch (...) {
+            sendTarget = nullptr;
+            throw;
+        }
+        sendTarget = nullptr;
+    }
+
+    bool MpPacketSerializer::PlayerHandles(GlobalNamespace::IConnectedPlayer* player, PacketKey packetKey) const {
+        return packetRegistry.PeerHandles(player, packetKey);
+    }
 
-            auto handlerItr = packetHandlers.find(packetId);
-            if (handlerItr != packetHandlers.end() && handlerItr->second) {
-                handlerItr->second(reader, length, data);
+    void MpPacketSerializer::SendWithFallback(PacketKey packetKey, LiteNetLib::Utils::INetSerializable* packet, LiteNetLib::Utils::INetSerializable* fallback) {
+        std::vector<GlobalNamespace::IConnectedPlayer*> handling, notHandling;
+        int playerCount = _sessionManager->get_connectedPlayerCount();
+        for (int i = 0; i < playerCount; i++) {
+            auto player = _sessionManager->GetConnectedPlayer(i);
+            (PlayerHandles(player, packetKey) ? handling : notHandling).push_back(player);
+        }
+
+        // a lobby that agrees on one version still gets a single broadcast
+        auto priority = PriorityOf(reinterpret_cast<Il2CppObject*>(packet)->klass);
+        if (notHandling.empty()) {
+            if (!TryQueuePacket(packet, true)) Submit(packet, nullptr, true, priority);
+        } else if (handling.empty()) {
+            if (!TryQueuePacket(fallback, true)) Submit(fallback, nullptr, true, priority);
+        } else {
+            for (auto player : handling) Submit(packet, player, true, priority);
+            for (auto player : notHandling) Submit(fallback, player, true, priority);
+        }
+    }
+
+    void MpPacketSerializer::FlushBatches() {
+        std::lock_guard lock(batches->mutex);
+        if (!batches->reliableQueue.packets.empty()) Batches::Flush(*this, batches->reliableQueue, true);
+        if (!batches->unreliableQueue.packets.empty()) Batches::Flush(*this, batches->unreliableQueue, false);
+    }
+
+    bool MpPacketSerializer::TryQueuePacket(LiteNetLib::Utils::INetSerializable* packet, bool reliable) {
+        if (!batches->enabled || !_batchWriter) return false;
+
+        // only packets we frame ourselves can go into a batch
+        auto packetClass = reinterpret_cast<Il2CppObject*>(packet)->klass;
+        if (!packetRegistry.contains(packetClass)) return false;
+
+        // everyone needs to know the batch packet, otherwise a peer would drop the whole batch
+        static auto batchClass = classof(MpPacketBatch*);
+        if (!packetRegistry.ReceiversKnow(batchClass, nullptr)) return false;
+
+        std::lock_guard lock(batches->mutex);
+        _batchWriter->Reset();
+        Serialize(_batchWriter, packet);
+        auto data = _batchWriter->get_Data();
+        std::vector<uint8_t> bytes(data.begin(), data.begin() + _batchWriter->get_Length());
+
+        auto& queue = reliable ? batches->reliableQueue : batches->unreliableQueue;
+        if (batches->coalescedTypes.contains(packetClass)) {
+            auto existing = std::find_if(queue.packets.begin(), queue.packets.end(), [packetClass](auto& x){ return x.packetClass == packetClass; });
+            if (existing != queue.packets.end()) {
+                queue.byteCount -= existing->data.size();
+                queue.packets.erase(existing);
             }
         }
-        catch (const std::exception& e) {
-            std::string user;
-			if (data) {
-				if (data->get_userName())
-					user += static_cast<std::string>(data->get_userName());
-				if (!user.empty() && data->get_userId()) user += "|";
-				if (data->get_userId())
-					user += static_cast<std::string>(data->get_userId());
-			}
-            WARNING("An exception was thrown processing packet from player {}, packet {}: {}", user, packetId, e.what());
+
+        if (!queue.packets.empty() && queue.byteCount + bytes.size() > Batches::MaxBytes) Batches::Flush(*this, queue, reliable);
+        if (queue.packets.empty()) queue.firstQueued = std::chrono::steady_clock::now();
+
+        queue.byteCount += bytes.size();
+        queue.priority = std::min(queue.priority, PriorityOf(packetClass));
+        queue.packets.push_back(Batches::QueuedPacket{packetClass, std::move(bytes)});
+        return true;
+    }
+
+    void MpPacketSerializer::Batches::Flush(MpPacketSerializer& serializer, Queue& queue, bool reliable) {
+        auto packets = std::move(queue.packets);
+        auto priority = queue.priority;
+        queue = {};
+
+        // framed when they were queued, a player may have joined since who doesn't know their ids yet
+        uint32_t limit = serializer.packetRegistry.LimitFor(nullptr);
+        for (auto& [packetClass, data] : packets) {
+            PacketFraming::SpanReader reader{ data };
+            auto header = PacketFraming::ReadHeader(&reader);
+            if (header.compact() && header.compactId >= limit)
+                data = PacketFraming::ToNameFrame(data, serializer.packetRegistry.NameOf(header.compactId));
         }
-        int processedBytes = reader->get_Position() - prevPosition;
-        reader->SkipBytes(length - processedBytes);
+
+        // or one who can't unpack batches at all, they get each packet on its own then
+        static auto batchClass = classof(MpPacketBatch*);
+        if (!serializer.packetRegistry.ReceiversKnow(batchClass, nullptr)) {
+            for (auto& [packetClass, data] : packets) {
+                auto frame = MpScheduledFrame::New_ctor();
+                frame->frame = il2cpp_utils::vectorToArray(data);
+                serializer.Submit(frame->i_INetSerializable(), nullptr, reliable, serializer.PriorityOf(packetClass));
+            }
+            return;
+        }
+
+        std::size_t byteCount = 0;
+        for (const auto& [packetClass, data] : packets) byteCount += data.size();
+        auto batch = MpPacketBatch::New_ctor();
+        batch->frameCount = packets.size();
+        batch->frames.reserve(byteCount + packets.size() * Utils::VarInt::MaxBytes32);
+        for (const auto& [packetClass, data] : packets) {
+            Utils::VarInt::Write(batch->frames, data.size());
+            batch->frames.insert(batch->frames.end(), data.begin(), data.end());
+        }
+
+        serializer.Submit(batch->i_INetSerializable(), nullptr, reliable, priority);
     }
+}
 
-    bool MpPacketSerializer::HandlesType(Il2CppReflectionType* type) {
-        return std::find(registeredTypes.begin(), registeredTypes.end(), type) != registeredTypes.end();
+namespace MultiplayerCore::Networking {
+    void MpPacketSerializer::SetPayloadCaching(Il2CppClass* packetClass, bool cache) {
+        if (cache) cachedPayloadTypes.insert(packetClass);
+        else cachedPayloadTypes.erase(packetClass);
+    }
+
+    void MpPacketSerializer::InvalidateCachedPayload(LiteNetLib::Utils::INetSerializable* packet) {
+        std::lock_guard lock(payloadCacheMutex);
+        std::erase_if(payloadCache, [object = reinterpret_cast<System::Object*>(packet)](auto& x){ return x.packet.ptr() == object; });
+    }
+
+    MpPacketSerializer::PayloadCacheStats MpPacketSerializer::get_payloadCacheStats() const {
+        return { payloadCacheHits.load(), payloadCacheMisses.load() };
+    }
+
+    void MpPacketSerializer::SerializePayload(LiteNetLib::Utils::NetDataWriter* writer, LiteNetLib::Utils::INetSerializable* packet) {
+        auto object = reinterpret_cast<System::Object*>(packet);
+        if (!cachedPayloadTypes.contains(reinterpret_cast<Il2CppObject*>(packet)->klass)) {
+            packet->Serialize(writer);
+            return;
+        }
+
+        {
+            std::lock_guard lock(payloadCacheMutex);
+            auto cached = std::find_if(payloadCache.begin(), payloadCache.end(), [object](auto& x){ return x.packet.ptr() == object; });
+            if (cached != payloadCache.end()) {
+                ArrayW<uint8_t> bytes(cached->bytes.ptr());
+                writer->Put(bytes, 0, bytes.size());
+                std::rotate(cached, cached + 1, payloadCache.end());
+                payloadCacheHits++;
+                return;
+            }
+        }
+
+        auto start = writer->get_Length();
+        packet->Serialize(writer);
+        auto length = writer->get_Length() - start;
+
+        ArrayW<uint8_t> bytes(il2cpp_array_size_t(length));
+        std::copy_n(writer->get_Data().begin() + start, length, bytes.begin());
+
+        std::lock_guard lock(payloadCacheMutex);
+        payloadCacheMisses++;
+        if (payloadCache.size() >= MaxCachedPayloads) payloadCache.erase(payloadCache.begin());
+        payloadCache.push_back(CachedPayload{object, static_cast<Array<uint8_t>*>(bytes)});
+    }
+}
+
+namespace MultiplayerCore::Networking {
+    void MpPacketSerializer::SetCompression(Il2CppClass* packetClass, bool compress) {
+        if (compress) compressedTypes.insert(packetClass);
+        else compressedTypes.erase(packetClass);
+    }
+
+    void MpPacketSerializer::set_compressionThreshold(std::size_t value) { compressionThreshold = value; }
+    std::size_t MpPacketSerializer::get_compressionThreshold() const { return compressionThreshold; }
+
+    void MpPacketSerializer::CompressPayload(LiteNetLib::Utils::NetDataWriter* writer, int flagPosition, int payloadStart) {
+        PacketFraming::CompressPayload(writer, flagPosition, payloadStart, compressionThreshold);
+    }
+}
+
+namespace MultiplayerCore::Networking {
+    void MpPacketSerializer::SetChunking(Il2CppClass* packetClass, bool chunk) {
+        if (chunk) transfers->chunkedTypes.insert(packetClass);
+        else transfers->chunkedTypes.erase(packetClass);
+    }
+
+    bool MpPacketSerializer::TrySendChunked(LiteNetLib::Utils::INetSerializable* packet, GlobalNamespace::IConnectedPlayer* target) {
+        auto packetClass = reinterpret_cast<Il2CppObject*>(packet)->klass;
+        if (!_chunkWriter || !transfers->chunkedTypes.contains(packetClass)) return false;
+
+        static auto chunkClass = classof(MpPacketChunk*);
+        if (!packetRegistry.ReceiversKnow(chunkClass, target)) return false;
+
+        std::lock_guard lock(transfers->mutex);
+        // frame it the way it would be framed for these receivers, the reassembled frame is dispatched like any other packet
+        _chunkWriter->Reset();
+        sendTarget = target;
+        try {
+            Serialize(_chunkWriter, packet);
+        } catch (...) {
+            sendTarget = nullptr;
+            throw;
+        }
+        sendTarget = nullptr;
+
+        uint32_t length = _chunkWriter->get_Length();
+        if (length <= Transfers::MaxUnchunkedBytes) return false;
+        if (length > PacketFraming::MaxTransferBytes) {
+            WARNING("Packet of {} bytes is too large for a chunked transfer, sending it in one piece", length);
+            return false;
+        }
+
+        ArrayW<uint8_t> data(il2cpp_array_size_t(length));
+        std::copy_n(_chunkWriter->get_Data().begin(), length, data.begin());
+        auto packetName = packetRegistry.NameOf(packetRegistry.IdOf(packetClass));
+        metrics->RecordSent(metrics->ForPacket(packetName), length);
+        if (auto channel = ChannelOf(packetClass)) channel->RecordSent(packetName, length);
+        if (capture.get_active()) {
+            auto frameReader = LiteNetLib::Utils::NetDataReader::New_ctor(data);
+            auto header = PacketFraming::ReadHeader(frameReader);
+            CapturePacket(CapturedPacket::Direction::Outbound, target, packetName, header.flags, { data.begin() + frameReader->get_Position(), data.end() });
+        }
+        transfers->outgoing.push_back(Transfers::Outgoing{transfers->nextId++, static_cast<Array<uint8_t>*>(data), 0, target, PriorityOf(packetClass)});
+        return true;
+    }
+
+    void MpPacketSerializer::Transfers::Send(MpPacketSerializer& serializer) {
+        // with a send budget, more chunks only go in once the last ones went out, the queue would grow without end otherwise
+        if (serializer.get_sendBudget()) {
+            std::lock_guard lock(serializer.sendQueueMutex);
+            if (!serializer.sendScheduler.empty()) return;
+        }
+
+        auto& transfers = *serializer.transfers;
+        std::lock_guard lock(transfers.mutex);
+        for (std::size_t i = 0; i < ChunksPerTick && !transfers.outgoing.empty(); i++) {
+            // the first of the most urgent transfers, the ones of a low priority channel wait until nothing else is left
+            auto next = std::min_element(transfers.outgoing.begin(), transfers.outgoing.end(), [](auto& a, auto& b){ return a.priority < b.priority; });
+            auto transfer = std::move(*next);
+            transfers.outgoing.erase(next);
+
+            ArrayW<uint8_t> data(transfer.data.ptr());
+            auto chunk = MpPacketChunk::New_ctor();
+            chunk->transferId = transfer.id;
+            chunk->totalLength = data.size();
+            chunk->offset = transfer.sent;
+            chunk->length = std::min<uint32_t>(ChunkBytes, data.size() - transfer.sent);
+            chunk->data = data;
+
+            serializer.Submit(chunk->i_INetSerializable(), transfer.target, true, transfer.priority);
+
+            // unfinished transfers go to the back, so concurrent transfers take turns
+            transfer.sent += chunk->length;
+            if (transfer.sent < data.size()) transfers.outgoing.push_back(std::move(transfer));
+        }
+    }
+
+    void MpPacketSerializer::ExpireIncomingTransfers() {
+        if (incomingTransfers.empty()) return;
+
+        incomingTransfers.Expire(std::chrono::steady_clock::now(), [](uint32_t transferId, std::size_t receivedBytes, uint32_t totalLength){
+            DEBUG("Chunked transfer {} timed out after {} of {} bytes", transferId, receivedBytes, totalLength);
+        });
+    }
+}
+
+namespace MultiplayerCore::Networking {
+    void MpPacketSerializer::set_senderPacketsPerSecond(uint32_t value) { decodeBudget.set_senderPacketsPerSecond(value); }
+    uint32_t MpPacketSerializer::get_senderPacketsPerSecond() const { return decodeBudget.get_senderPacketsPerSecond(); }
+
+    SenderMetrics* MpPacketSerializer::GetSenderMetrics(GlobalNamespace::IConnectedPlayer* player) {
+        if (!player) return nullptr;
+        auto existing = senderMetrics.find(player);
+        if (existing != senderMetrics.end()) return existing->second;
+
+        auto userId = player->get_userId();
+        auto sender = metrics->ForSender(userId ? static_cast<std::string>(userId) : std::string());
+        senderMetrics.emplace(player, sender);
+        return sender;
+    }
+
+    void MpPacketSerializer::RemoveSenderMetrics(PacketMetrics& metrics, GlobalNamespace::IConnectedPlayer* player) {
+        auto userId = player->get_userId();
+        metrics.RemoveSender(userId ? static_cast<std::string>(userId) : std::string());
+    }
+
+    void MpPacketSerializer::SetMetricsDump(std::string path, std::chrono::seconds interval) {
+        metricsDumpPath = std::move(path);
+        metricsDumpInterval = metricsDumpPath.empty() ? std::chrono::seconds(0) : interval;
+        lastMetricsDump = std::chrono::steady_clock::now();
+    }
+
+    bool MpPacketSerializer::StartCapture(const std::string& path) {
+        if (!capture.Start(path)) {
+            WARNING("Could not open '{}' for a packet capture", path);
+            return false;
+        }
+        INFO("Capturing packets to '{}'", path);
+        return true;
+    }
+
+    void MpPacketSerializer::StopCapture() { capture.Stop(); }
+
+    void MpPacketSerializer::CapturePacket(CapturedPacket::Direction direction, GlobalNamespace::IConnectedPlayer* peer, std::string_view packetName, uint8_t frameFlags, std::span<const uint8_t> payload) {
+        if (packetName == batchPacketName || packetName == chunkPacketName) return;
+        std::string peerId;
+        if (peer && peer->get_userId()) peerId = static_cast<std::string>(peer->get_userId());
+        capture.Record(direction, peerId, packetName, frameFlags, payload);
+    }
+
+    void MpPacketSerializer::DumpMetrics() {
+        std::ofstream out(metricsDumpPath, std::ios::app);
+        if (!out) {
+            WARNING("Could not open '{}' for packet metrics, no longer dumping them", metricsDumpPath);
+            metricsDumpInterval = std::chrono::seconds(0);
+            return;
+        }
+        metrics->WriteJson(out);
+    }
+}
+
+namespace MultiplayerCore::Networking {
+    void MpPacketSerializer::set_sendBudget(std::size_t bytesPerFrame) {
+        std::lock_guard lock(sendQueueMutex);
+        sendBudget = bytesPerFrame;
+        sendScheduler.set_bytesPerFrame(bytesPerFrame);
+    }
+
+    std::size_t MpPacketSerializer::get_sendBudget() const { return sendBudget; }
+
+    void MpPacketSerializer::SetPriority(Il2CppClass* packetClass, PacketPriority priority) { packetPriorities[packetClass] = priority; }
+
+    PacketPriority MpPacketSerializer::PriorityOf(Il2CppClass* packetClass) const {
+        if (auto channel = ChannelOf(packetClass)) return channel->get_priority();
+        auto priority = packetPriorities.find(packetClass);
+        return priority != packetPriorities.end() ? priority->second : PacketPriority::Normal;
+    }
+
+    MpPacketSerializer::SendQueueStats MpPacketSerializer::get_sendQueueStats(PacketPriority priority) const {
+        std::lock_guard lock(sendQueueMutex);
+        return sendScheduler.get_stats(priority);
+    }
+
+    void MpPacketSerializer::Submit(LiteNetLib::Utils::INetSerializable* packet, GlobalNamespace::IConnectedPlayer* target, bool reliable, PacketPriority priority) {
+        if (!_sessionManager) return;
+        if (!get_sendBudget()) {
+            SendImmediately(packet, target, reliable);
+            return;
+        }
+
+        // framed now, the caller is free to reuse the packet once this returns
+        std::lock_guard lock(sendQueueMutex);
+        _scheduleWriter->Reset();
+        sendTarget = target;
+        try {
+            Serialize(_scheduleWriter, packet);
+        } catch (...) {
+            sendTarget = nullptr;
+            throw;
+        }
+        sendTarget = nullptr;
+
+        auto data = _scheduleWriter->get_Data();
+        sendScheduler.Enqueue(priority, { target, reliable, std::vector<uint8_t>(data.begin(), data.begin() + _scheduleWriter->get_Length()), std::chrono::steady_clock::now() });
+    }
+
+    void MpPacketSerializer::SendImmediately(LiteNetLib::Utils::INetSerializable* packet, GlobalNamespace::IConnectedPlayer* target, bool reliable) {
+        if (target) SendToPlayer(packet, target);
+        else if (reliable) _sessionManager->Send(packet);
+        else _sessionManager->SendUnreliable(packet);
+    }
+
+    void MpPacketSerializer::DrainSendQueue() {
+        std::lock_guard lock(sendQueueMutex);
+        if (sendScheduler.empty() || !_sessionManager) return;
+
+        sendScheduler.Drain([this](const auto& message){
+            std::span<const uint8_t> bytes = message.frame;
+            std::vector<uint8_t> nameFrame;
+            // a player joined while it waited, and doesn't know the id it was framed with yet
+            PacketFraming::SpanReader reader{ bytes };
+            auto header = PacketFraming::ReadHeader(&reader);
+            if (header.compact() && header.compactId >= packetRegistry.LimitFor(message.target)) {
+                nameFrame = PacketFraming::ToNameFrame(bytes, packetRegistry.NameOf(header.compactId));
+                bytes = nameFrame;
+            }
+
+            auto frame = MpScheduledFrame::New_ctor();
+            frame->frame = ArrayW<uint8_t>(il2cpp_array_size_t(bytes.size()));
+            std::copy(bytes.begin(), bytes.end(), frame->frame.begin());
+            SendImmediately(frame->i_INetSerializable(), message.target, message.reliable);
+        }, std::chrono::steady_clock::now());
+    }
+}
+
+namespace MultiplayerCore::Networking {
+    PacketHandler MpPacketSerializer::MakeAsyncHandler(PacketKey packetKey, PacketDecoding::Decoder decode, PacketDecoding::AsyncWork work) {
+        auto active = ActivateAsyncHandler(packetKey);
+        // async packets are never released to a pool, the job owns them until it is done
+        return [this, packetKey, active, decode, work = std::move(work)](LiteNetLib::Utils::NetDataReader* reader, int size, GlobalNamespace::IConnectedPlayer* player){
+            auto packet = decode(reader, size);
+            if (!packet) return;
+
+            // pinned, nothing else references them while they wait in the queue
+            SafePtr<System::Object> pinnedPacket(packet);
+            SafePtr<System::Object> pinnedPlayer(reinterpret_cast<System::Object*>(player));
+            PostWork(AsyncStrand(packetKey, player), [packetKey, active, work, pinnedPacket, pinnedPlayer](){
+                try {
+                    RunOnMainThread([active, pinnedPlayer, apply = work(pinnedPacket.ptr(), reinterpret_cast<GlobalNamespace::IConnectedPlayer*>(pinnedPlayer.ptr()))](){
+                        if (*active) apply();
+                    });
+                } catch (const std::exception& e) {
+                    WARNING("An exception was thrown processing packet {} off-thread: {}", packetKey, e.what());
+                }
+            });
+        };
+    }
+
+    std::shared_ptr<std::atomic<bool>> MpPacketSerializer::ActivateAsyncHandler(PacketKey packetKey) {
+        std::lock_guard lock(asyncHandlerMutex);
+        // registering again replaces the handler, whatever the old one still had in flight goes nowhere
+        auto& active = asyncHandlers[packetKey];
+        if (active) *active = false;
+        active = std::make_shared<std::atomic<bool>>(true);
+        return active;
+    }
+
+    void MpPacketSerializer::DeactivateAsyncHandler(PacketKey packetKey) {
+        std::lock_guard lock(asyncHandlerMutex);
+        auto active = asyncHandlers.find(packetKey);
+        if (active == asyncHandlers.end()) return;
+        *active->second = false;
+        asyncHandlers.erase(active);
+    }
+
+    void MpPacketSerializer::PostWork(uint64_t strand, std::function<void()> job) {
+        if (!workers.Post(strand, std::move(job))) DEBUG("Dropped background work posted after the serializer was disposed");
+    }
+
+    void MpPacketSerializer::RunOnMainThread(std::function<void()> action) {
+        Lapiz::Utilities::MainThreadScheduler::Schedule(std::move(action));
     }
 }
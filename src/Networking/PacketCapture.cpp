@@ -0,0 +1,130 @@
+#include "Networking/PacketCapture.hpp"
+#include "Networking/PacketFraming.hpp"
+#include "Utils/VarInt.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace MultiplayerCore::Networking {
+    bool PacketCaptureWriter::Start(const std::string& path, std::chrono::steady_clock::time_point now) {
+        std::lock_guard lock(mutex);
+        if (out.is_open()) out.close();
+        strings.clear();
+
+        out.open(path, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            active = false;
+            return false;
+        }
+
+        out.write(reinterpret_cast<const char*>(PacketCaptureFormat::Magic.data()), PacketCaptureFormat::Magic.size());
+        out.put(static_cast<char>(PacketCaptureFormat::Version));
+        lastPacket = now;
+        dirty = true;
+        active = true;
+        return true;
+    }
+
+    void PacketCaptureWriter::Stop() {
+        std::lock_guard lock(mutex);
+        active = false;
+        if (out.is_open()) out.close();
+        strings.clear();
+    }
+
+    void PacketCaptureWriter::Flush() {
+        if (!get_active()) return;
+        std::lock_guard lock(mutex);
+        if (!dirty || !out.is_open()) return;
+        out.flush();
+        dirty = false;
+    }
+
+    uint32_t PacketCaptureWriter::Intern(std::string_view value) {
+        auto existing = strings.find(value);
+        if (existing != strings.end()) return existing->second;
+
+        uint32_t index = strings.size();
+        strings.emplace(value, index);
+
+        record.clear();
+        record.push_back(PacketCaptureFormat::Name);
+        Utils::VarInt::Write(record, value.size());
+        record.insert(record.end(), value.begin(), value.end());
+        out.write(reinterpret_cast<const char*>(record.data()), record.size());
+        return index;
+    }
+
+    void PacketCaptureWriter::Record(CapturedPacket::Direction direction, std::string_view peer, std::string_view packetName, uint8_t frameFlags, std::span<const uint8_t> payload, std::chrono::steady_clock::time_point now) {
+        std::lock_guard lock(mutex);
+        if (!active || !out) return;
+
+        auto peerIndex = Intern(peer);
+        auto nameIndex = Intern(packetName);
+
+        auto delta = std::chrono::duration_cast<std::chrono::microseconds>(now - lastPacket).count();
+        lastPacket = now;
+
+        record.clear();
+        record.push_back(direction == CapturedPacket::Direction::Inbound ? PacketCaptureFormat::Inbound : PacketCaptureFormat::Outbound);
+        // a gap of more than an hour without a single packet only loses its length
+        Utils::VarInt::Write(record, std::clamp<int64_t>(delta, 0, std::numeric_limits<uint32_t>::max()));
+        Utils::VarInt::Write(record, peerIndex);
+        Utils::VarInt::Write(record, nameIndex);
+        record.push_back(frameFlags);
+        Utils::VarInt::Write(record, payload.size());
+        out.write(reinterpret_cast<const char*>(record.data()), record.size());
+        out.write(reinterpret_cast<const char*>(payload.data()), payload.size());
+        dirty = true;
+    }
+
+    PacketCaptureReader::PacketCaptureReader(std::istream& in) : in(in) {
+        std::array<uint8_t, PacketCaptureFormat::Magic.size()> magic;
+        for (auto& b : magic) b = GetByte();
+        if (magic != PacketCaptureFormat::Magic) throw std::runtime_error("Not an MpCore packet capture");
+        if (GetByte() != PacketCaptureFormat::Version) throw std::runtime_error("Unsupported packet capture version");
+    }
+
+    uint8_t PacketCaptureReader::GetByte() {
+        auto b = in.get();
+        if (b == std::istream::traits_type::eof()) throw std::runtime_error("Packet capture ends within a record");
+        return static_cast<uint8_t>(b);
+    }
+
+    bool PacketCaptureReader::Next(CapturedPacket& packet) {
+        while (true) {
+            // the end of the file is only fine in between records, a capture that was still running when the game died ends anywhere
+            auto kind = in.get();
+            if (kind == std::istream::traits_type::eof()) return false;
+
+            if (kind == PacketCaptureFormat::Name) {
+                auto length = Utils::VarInt::Read(this);
+                if (length > PacketFraming::MaxTransferBytes) throw std::runtime_error("Packet capture name is too long");
+                std::string value(length, '\0');
+                if (!in.read(value.data(), length)) throw std::runtime_error("Packet capture ends within a record");
+                strings.push_back(std::move(value));
+                continue;
+            }
+            if (kind != PacketCaptureFormat::Inbound && kind != PacketCaptureFormat::Outbound) throw std::runtime_error("Unknown packet capture record");
+
+            packet.direction = kind == PacketCaptureFormat::Inbound ? CapturedPacket::Direction::Inbound : CapturedPacket::Direction::Outbound;
+            time += std::chrono::microseconds(Utils::VarInt::Read(this));
+            packet.time = time;
+
+            auto peer = Utils::VarInt::Read(this);
+            auto name = Utils::VarInt::Read(this);
+            if (peer >= strings.size() || name >= strings.size()) throw std::runtime_error("Packet capture refers to an unknown name");
+            packet.peer = strings[peer];
+            packet.packetName = strings[name];
+            packet.frameFlags = GetByte();
+
+            // the serializer never handles anything larger, so neither does a capture of it
+            auto length = Utils::VarInt::Read(this);
+            if (length > PacketFraming::MaxTransferBytes) throw std::runtime_error("Packet capture payload is too large");
+            packet.payload.resize(length);
+            if (!in.read(reinterpret_cast<char*>(packet.payload.data()), length)) throw std::runtime_error("Packet capture ends within a record");
+            return true;
+        }
+    }
+}
@@ -0,0 +1,52 @@
+#include "Networking/PacketMetrics.hpp"
+
+namespace MultiplayerCore::Networking {
+    static void WriteJsonString(std::ostream& out, std::string_view value) {
+        out << '"';
+        for (char c : value) {
+            if (c == '"' || c == '\\') out << '\\' << c;
+            else if (static_cast<unsigned char>(c) < 0x20) out << ' ';
+            else out << c;
+        }
+        out << '"';
+    }
+
+    void PacketMetrics::WriteJson(std::ostream& out) const {
+        auto now = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+        out << "{\"time\":" << now << ",\"packets\":{";
+
+        bool first = true;
+        ForEachPacket([&out, &first](std::string_view name, const PacketTypeMetrics& packet) {
+            if (!first) out << ',';
+            first = false;
+
+            WriteJsonString(out, name);
+            out << ":{\"sent\":" << packet.sentCount.load(std::memory_order_relaxed)
+                << ",\"sentBytes\":" << packet.sentBytes.load(std::memory_order_relaxed)
+                << ",\"received\":" << packet.receivedCount.load(std::memory_order_relaxed)
+                << ",\"receivedBytes\":" << packet.receivedBytes.load(std::memory_order_relaxed)
+                << ",\"dropped\":" << packet.droppedCount.load(std::memory_order_relaxed)
+                << ",\"handlerMicros\":{\"p50\":" << packet.handlerMicros.Percentile(0.5)
+                << ",\"p99\":" << packet.handlerMicros.Percentile(0.99)
+                << ",\"buckets\":[";
+            for (std::size_t i = 0; i < LatencyHistogram::BucketCount; i++) {
+                if (i) out << ',';
+                out << packet.handlerMicros.Count(i);
+            }
+            out << "]}}";
+        });
+
+        out << "},\"senders\":{";
+        first = true;
+        ForEachSender([&out, &first](std::string_view userId, const SenderMetrics& sender) {
+            if (!first) out << ',';
+            first = false;
+
+            WriteJsonString(out, userId);
+            out << ":{\"received\":" << sender.receivedCount.load(std::memory_order_relaxed)
+                << ",\"receivedBytes\":" << sender.receivedBytes.load(std::memory_order_relaxed)
+                << ",\"dropped\":" << sender.droppedCount.load(std::memory_order_relaxed) << '}';
+        });
+        out << "}}\n";
+    }
+}
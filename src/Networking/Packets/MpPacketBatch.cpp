@@ -0,0 +1,16 @@
+#include "Networking/Packets/MpPacketBatch.hpp"
+#include "Utils/VarInt.hpp"
+
+DEFINE_TYPE(MultiplayerCore::Networking::Packets, MpPacketBatch);
+
+namespace MultiplayerCore::Networking::Packets {
+    void MpPacketBatch::ctor() {
+        INVOKE_CTOR();
+        INVOKE_BASE_CTOR(classof(MultiplayerCore::Networking::Abstractions::MpPacket*));
+    }
+
+    void MpPacketBatch::Serialize(LiteNetLib::Utils::NetDataWriter* writer) {
+        Utils::VarInt::Write(writer, frameCount);
+        if (!frames.empty()) writer->Put(il2cpp_utils::vectorToArray(frames), 0, frames.size());
+    }
+}
@@ -0,0 +1,17 @@
+#include "Networking/Packets/MpPacketChunk.hpp"
+#include "Utils/VarInt.hpp"
+
+DEFINE_TYPE(MultiplayerCore::Networking::Packets, MpPacketChunk);
+
+namespace MultiplayerCore::Networking::Packets {
+    void MpPacketChunk::ctor() {
+        INVOKE_BASE_CTOR(classof(MultiplayerCore::Networking::Abstractions::MpPacket*));
+    }
+
+    void MpPacketChunk::Serialize(LiteNetLib::Utils::NetDataWriter* writer) {
+        Utils::VarInt::Write(writer, transferId);
+        Utils::VarInt::Write(writer, totalLength);
+        Utils::VarInt::Write(writer, offset);
+        if (length > 0) writer->Put(data, offset, length);
+    }
+}
@@ -0,0 +1,20 @@
+#include "Networking/Packets/MpPacketRegistryAckPacket.hpp"
+#include "Networking/Packets/MpPacketRegistryPacketEncoding.hpp"
+#include "Utils/VarInt.hpp"
+
+DEFINE_TYPE(MultiplayerCore::Networking::Packets, MpPacketRegistryAckPacket);
+
+namespace MultiplayerCore::Networking::Packets {
+    void MpPacketRegistryAckPacket::ctor() {
+        INVOKE_CTOR();
+        INVOKE_BASE_CTOR(classof(MultiplayerCore::Networking::Abstractions::MpPacket*));
+    }
+
+    void MpPacketRegistryAckPacket::Serialize(LiteNetLib::Utils::NetDataWriter* writer) {
+        Utils::VarInt::Write(writer, packetCount);
+    }
+
+    void MpPacketRegistryAckPacket::Deserialize(LiteNetLib::Utils::NetDataReader* reader) {
+        MpPacketRegistryPacketEncoding::ReadAck(reader, *this);
+    }
+}
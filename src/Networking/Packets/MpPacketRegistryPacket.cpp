@@ -0,0 +1,22 @@
+#include "Networking/Packets/MpPacketRegistryPacket.hpp"
+#include "Networking/Packets/MpPacketRegistryPacketEncoding.hpp"
+#include "Utils/VarInt.hpp"
+
+DEFINE_TYPE(MultiplayerCore::Networking::Packets, MpPacketRegistryPacket);
+
+namespace MultiplayerCore::Networking::Packets {
+    void MpPacketRegistryPacket::ctor() {
+        INVOKE_CTOR();
+        INVOKE_BASE_CTOR(classof(MultiplayerCore::Networking::Abstractions::MpPacket*));
+    }
+
+    void MpPacketRegistryPacket::Serialize(LiteNetLib::Utils::NetDataWriter* writer) {
+        Utils::VarInt::Write(writer, packetNames.size());
+        for (const auto& name : packetNames)
+            writer->Put(StringW(name));
+    }
+
+    void MpPacketRegistryPacket::Deserialize(LiteNetLib::Utils::NetDataReader* reader) {
+        MpPacketRegistryPacketEncoding::Read(reader, *this);
+    }
+}
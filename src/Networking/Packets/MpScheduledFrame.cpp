@@ -0,0 +1,14 @@
+#include "Networking/Packets/MpScheduledFrame.hpp"
+
+DEFINE_TYPE(MultiplayerCore::Networking::Packets, MpScheduledFrame);
+
+namespace MultiplayerCore::Networking::Packets {
+    void MpScheduledFrame::ctor() {
+        INVOKE_CTOR();
+        INVOKE_BASE_CTOR(classof(MultiplayerCore::Networking::Abstractions::MpPacket*));
+    }
+
+    void MpScheduledFrame::Serialize(LiteNetLib::Utils::NetDataWriter* writer) {
+        if (frame && frame.size() > 0) writer->Put(frame, 0, frame.size());
+    }
+}
@@ -15,9 +15,12 @@ namespace MultiplayerCore::NodePoseSyncState {
     }
 
     void MpNodePoseSyncStateManager::Initialize() {
-        _packetSerializer->RegisterCallback<MpNodePoseSyncStatePacket*>(
+        // only the two frequencies are copied out, the packet can go back to its pool
+        _packetSerializer->RegisterPooledCallback<MpNodePoseSyncStatePacket*>(
             std::bind(&MpNodePoseSyncStateManager::HandleNodePoseSyncUpdateReceived, this, std::placeholders::_1, std::placeholders::_2)
         );
+        // only the latest sync state matters
+        _packetSerializer->SetCoalescing<MpNodePoseSyncStatePacket*>();
     }
 
     void MpNodePoseSyncStateManager::Dispose() {
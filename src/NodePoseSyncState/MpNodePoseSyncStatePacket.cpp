@@ -1,10 +1,11 @@
 #include "NodePoseSyncState/MpNodePoseSyncStatePacket.hpp"
+#include "NodePoseSyncState/MpNodePoseSyncStatePacketEncoding.hpp"
 
 DEFINE_TYPE(MultiplayerCore::NodePoseSyncState, MpNodePoseSyncStatePacket);
 
 namespace MultiplayerCore::NodePoseSyncState {
     void MpNodePoseSyncStatePacket::ctor() {
-        INVOKE_BASE_CTOR(classof(MultiplayerCore::Networking::Abstractions::MpPacket*));
+        INVOKE_BASE_CTOR(classof(MultiplayerCore::Networking::Abstractions::MpPoolablePacket*));
     }
 
     void MpNodePoseSyncStatePacket::Serialize(LiteNetLib::Utils::NetDataWriter* writer) {
@@ -13,7 +14,6 @@ namespace MultiplayerCore::NodePoseSyncState {
     }
 
     void MpNodePoseSyncStatePacket::Deserialize(LiteNetLib::Utils::NetDataReader* reader) {
-        deltaUpdateFrequencyMs = reader->GetLong();
-        fullStateUpdateFrequencyMs = reader->GetLong();
+        MpNodePoseSyncStatePacketEncoding::Read(reader, *this);
     }
 }
@@ -0,0 +1,170 @@
+#include "Objects/EntitlementStore.hpp"
+#include "Utils/LevelHash.hpp"
+#include "Utils/VarInt.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace MultiplayerCore::Objects {
+    // a hash is 40 characters, anything much longer is a corrupt log
+    static constexpr std::size_t MaxHashBytes = 128;
+    // the log is rewritten once it holds this many records more than entries, and more records than entries
+    static constexpr std::size_t CompactSlack = 256;
+
+    namespace {
+        struct EntryReader {
+            std::span<const uint8_t> data;
+            std::size_t position = 0;
+
+            uint8_t GetByte() {
+                if (position >= data.size()) throw std::runtime_error("Entitlement record is cut short");
+                return data[position++];
+            }
+
+            uint64_t GetUInt64() {
+                uint64_t value = 0;
+                for (int i = 0; i < 8; i++) value |= uint64_t(GetByte()) << (8 * i);
+                return value;
+            }
+        };
+
+        void PutUInt64(std::vector<uint8_t>& record, uint64_t value) {
+            for (int i = 0; i < 8; i++) record.push_back(uint8_t(value >> (8 * i)));
+        }
+    }
+
+    EntitlementStore::EntitlementStore(std::filesystem::path path, uint64_t modSet) : modSet(modSet), log(std::move(path), Magic, Version) {
+        std::lock_guard lock(mutex);
+        bool otherMods = false;
+        bool appendable = log.Open([this, &otherMods](std::span<const uint8_t> payload){
+            auto entry = Decode(payload);
+            otherMods |= entry.modSet != this->modSet;
+            // an Unknown record is an erased verdict
+            if (entry.modSet != this->modSet || entry.status == EntitlementDecision::Status::Unknown) {
+                entries.erase(entry.hash);
+                return;
+            }
+            auto hash = entry.hash;
+            entries.insert_or_assign(std::move(hash), std::move(entry));
+        });
+
+        stats.entries = entries.size();
+        stats.logBytes = log.get_bytes();
+        // verdicts of other mods never hold again, so they go from the log as well
+        if (!appendable || otherMods || log.get_records() > entries.size() + CompactSlack) CompactLocked();
+    }
+
+    void EntitlementStore::Encode(const Entry& entry, std::vector<uint8_t>& record) {
+        record.push_back(static_cast<uint8_t>(entry.status));
+        PutUInt64(record, entry.modSet);
+        PutUInt64(record, static_cast<uint64_t>(entry.folderTime));
+        auto decided = std::chrono::duration_cast<std::chrono::seconds>(entry.decided.time_since_epoch()).count();
+        Utils::VarInt::Write(record, static_cast<uint32_t>(std::clamp<int64_t>(decided, 0, UINT32_MAX)));
+        auto hash = std::string_view(entry.hash).substr(0, MaxHashBytes);
+        Utils::VarInt::Write(record, hash.size());
+        record.insert(record.end(), hash.begin(), hash.end());
+    }
+
+    EntitlementStore::Entry EntitlementStore::Decode(std::span<const uint8_t> bytes) {
+        EntryReader reader{ bytes };
+        Entry entry;
+        auto status = reader.GetByte();
+        if (status > static_cast<uint8_t>(EntitlementDecision::Status::Ok)) throw std::runtime_error("Entitlement record has an unknown status");
+        entry.status = static_cast<EntitlementDecision::Status>(status);
+        entry.modSet = reader.GetUInt64();
+        entry.folderTime = static_cast<int64_t>(reader.GetUInt64());
+        entry.decided = std::chrono::system_clock::time_point(std::chrono::seconds(Utils::VarInt::Read(&reader)));
+
+        auto length = Utils::VarInt::Read(&reader);
+        if (length > MaxHashBytes || length > bytes.size() - reader.position) throw std::runtime_error("Entitlement record hash is too long");
+        entry.hash = Utils::LevelHash::Normalized({ reinterpret_cast<const char*>(bytes.data() + reader.position), length });
+        return entry;
+    }
+
+    std::optional<EntitlementDecision::Status> EntitlementStore::Find(std::string_view hash, int64_t folderTime, std::chrono::system_clock::time_point now) {
+        std::lock_guard lock(mutex);
+        auto entry = entries.find(Utils::LevelHash::Normalized(hash));
+        if (entry == entries.end()) {
+            stats.misses++;
+            return std::nullopt;
+        }
+
+        // installed or removed since, or the folder changed
+        bool stale = entry->second.folderTime != folderTime;
+        if (folderTime == 0 && now - entry->second.decided > remoteTtl) stale = true;
+        if (stale) {
+            stats.stale++;
+            stats.misses++;
+            return std::nullopt;
+        }
+        stats.hits++;
+        return entry->second.status;
+    }
+
+    void EntitlementStore::Store(std::string_view hash, EntitlementDecision::Status status, int64_t folderTime) {
+        if (status == EntitlementDecision::Status::Unknown) return;
+
+        Entry entry;
+        entry.hash = Utils::LevelHash::Normalized(hash);
+        entry.status = status;
+        entry.modSet = modSet;
+        entry.folderTime = folderTime;
+        entry.decided = std::chrono::system_clock::now();
+
+        std::lock_guard lock(mutex);
+        // the same verdict for the same folder holds already, a remote one gets its TTL renewed
+        auto existing = entries.find(entry.hash);
+        if (folderTime != 0 && existing != entries.end() && existing->second.status == status && existing->second.folderTime == folderTime) return;
+        Append(entry);
+        auto key = entry.hash;
+        entries.insert_or_assign(std::move(key), std::move(entry));
+        stats.stores++;
+        stats.entries = entries.size();
+        auto records = log.get_records();
+        if (records > entries.size() + CompactSlack && records > 2 * entries.size()) CompactLocked();
+    }
+
+    void EntitlementStore::Erase(std::string_view hash) {
+        std::lock_guard lock(mutex);
+        auto entry = entries.find(Utils::LevelHash::Normalized(hash));
+        if (entry == entries.end()) return;
+
+        auto erased = entry->second;
+        erased.status = EntitlementDecision::Status::Unknown;
+        Append(erased);
+        entries.erase(entry);
+        stats.entries = entries.size();
+    }
+
+    void EntitlementStore::Clear() {
+        std::lock_guard lock(mutex);
+        entries.clear();
+        stats.entries = 0;
+        CompactLocked();
+    }
+
+    void EntitlementStore::Append(const Entry& entry) {
+        record.clear();
+        Encode(entry, record);
+        log.Append(record);
+        stats.logBytes = log.get_bytes();
+    }
+
+    bool EntitlementStore::CompactLocked() {
+        bool compacted = log.Rewrite([this](){
+            for (auto& [hash, entry] : entries) Append(entry);
+        });
+        stats.logBytes = log.get_bytes();
+        return compacted;
+    }
+
+    void EntitlementStore::set_remoteTtl(std::chrono::seconds ttl) {
+        std::lock_guard lock(mutex);
+        remoteTtl = ttl;
+    }
+
+    EntitlementStore::Stats EntitlementStore::get_stats() const {
+        std::lock_guard lock(mutex);
+        return stats;
+    }
+}
@@ -1,32 +1,76 @@
 #include "Objects/MpEntitlementChecker.hpp"
+#include "Objects/EntitlementDecision.hpp"
+#include "Objects/EntitlementStore.hpp"
+#include "Utils/Hash.hpp"
 #include "Utils/ExtraSongData.hpp"
-#include "Utils/EnumUtils.hpp"
 #include "Utilities.hpp"
 #include "logging.hpp"
 #include "tasks.hpp"
 
 #include "lapiz/shared/utilities/MainThreadScheduler.hpp"
 #include "bsml/shared/Helpers/delegates.hpp"
-#include "songdownloader/shared/BeatSaverAPI.hpp"
+#include "Beatmaps/Providers/BeatSaverCache.hpp"
 
 #include "GlobalNamespace/IMenuRpcManager.hpp"
 #include "GlobalNamespace/IConnectedPlayer.hpp"
+#include "GlobalNamespace/CustomPreviewBeatmapLevel.hpp"
+
+#include "scotland2/shared/loader.hpp"
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <mutex>
 
 DEFINE_TYPE(MultiplayerCore::Objects, MpEntitlementChecker);
 
+extern modloader::ModInfo modInfo;
+
 // Accessing "private" method from pinkcore
 namespace RequirementUtils {
     bool GetRequirementInstalled(std::string requirement);
 }
 
 namespace MultiplayerCore::Objects {
+    // requirements are only as installed as the mods that provide them, other mods or versions make every verdict stale
+    static uint64_t InstalledModsFingerprint() {
+        std::vector<std::string> mods;
+        auto all = modloader_get_all();
+        for (auto itr = all.array; itr != all.array + all.size; itr++) mods.push_back(fmt::format("{}@{}", itr->info.id, itr->info.version));
+        std::sort(mods.begin(), mods.end());
+
+        std::string joined;
+        for (auto& mod : mods) joined.append(mod).push_back('\n');
+        return Utils::Fnv1a64(joined);
+    }
+
+    static EntitlementStore& GetEntitlementStore() {
+        static EntitlementStore store(std::filesystem::path(getDataDir(modInfo)) / "entitlements.log", InstalledModsFingerprint());
+        return store;
+    }
+
+    /// @return last write time of the song folder of levelHash in seconds, 0 if it isn't installed, -1 if the folder can't be read
+    static int64_t SongFolderTime(const std::string& levelHash) {
+        auto level = RuntimeSongLoader::API::GetLevelByHash(levelHash);
+        if (!level.has_value()) return 0;
+
+        std::error_code error;
+        auto time = std::filesystem::last_write_time(static_cast<std::string>(level.value()->get_customLevelPath()), error);
+        if (error) return -1;
+        return std::max<int64_t>(std::chrono::duration_cast<std::chrono::seconds>(time.time_since_epoch()).count(), 1);
+    }
+
+    // bumped by every song refresh, the song loader can't unsubscribe so this is subscribed once for every checker
+    static std::atomic<uint64_t> songsGeneration = 0;
+    static std::once_flag songsLoadedSubscribed;
+
     void MpEntitlementChecker::ctor() {
         INVOKE_CTOR();
         INVOKE_BASE_CTOR(classof(GlobalNamespace::NetworkPlayerEntitlementChecker*));
     }
 
-    void MpEntitlementChecker::Inject(GlobalNamespace::IMultiplayerSessionManager* sessionManager) {
+    void MpEntitlementChecker::Inject(GlobalNamespace::IMultiplayerSessionManager* sessionManager, MpLevelDownloader* levelDownloader) {
         _sessionManager = sessionManager;
+        _levelDownloader = levelDownloader;
     }
 
     void MpEntitlementChecker::Start_override() {
@@ -34,12 +78,45 @@ namespace MultiplayerCore::Objects {
         _rpcManager->add_setIsEntitledToLevelEvent(
             BSML::MakeSystemAction<StringW, StringW, GlobalNamespace::EntitlementsStatus>(this, ___HandleSetIsEntitledToLevel_MethodRegistrator.get())
         );
+        _levelDownloader->downloadFinishedEvent += {&MpEntitlementChecker::HandleDownloadFinished, this};
+        std::call_once(songsLoadedSubscribed, [](){
+            RuntimeSongLoader::API::AddSongsLoadedEvent([](auto&){ songsGeneration++; });
+        });
     }
 
     void MpEntitlementChecker::OnDestroy_override() {
+        _levelDownloader->downloadFinishedEvent -= {&MpEntitlementChecker::HandleDownloadFinished, this};
         GlobalNamespace::NetworkPlayerEntitlementChecker::OnDestroy();
     }
 
+    void MpEntitlementChecker::HandleDownloadFinished(std::string levelId, bool success) {
+        DEBUG("Download of {} finished, result: {}", levelId, success);
+        InvalidateLevel(levelId);
+    }
+
+    void MpEntitlementChecker::InvalidateLevel(const std::string& levelId) {
+        _entitlementsTasks.Erase(levelId);
+        // the persisted verdict would otherwise answer the next lookup again
+        if (auto levelHash = Utilities::HashForLevelId(levelId); !levelHash.empty()) GetEntitlementStore().Erase(levelHash);
+        if (!_sessionManager || !_sessionManager->localPlayer) return;
+        auto localEntitlements = _entitlementsDictionary.find(static_cast<std::string>(_sessionManager->localPlayer->userId));
+        if (localEntitlements != _entitlementsDictionary.end()) localEntitlements->second.erase(levelId);
+    }
+
+    void MpEntitlementChecker::InvalidateAll() {
+        DropFinishedTasks();
+        GetEntitlementStore().Clear();
+    }
+
+    void MpEntitlementChecker::DropFinishedTasks() {
+        auto erased = _entitlementsTasks.EraseIf([](auto&, auto& task){ return task->get_IsCompleted(); });
+        DEBUG("Invalidated {} local entitlements", erased);
+    }
+
+    MpEntitlementChecker::EntitlementsTaskCache::Stats MpEntitlementChecker::get_entitlementsTaskStats() const {
+        return _entitlementsTasks.get_stats();
+    }
+
     void MpEntitlementChecker::HandleGetIsEntitledToLevel_override(StringW userId, StringW levelId) {
         GlobalNamespace::NetworkPlayerEntitlementChecker::HandleGetIsEntitledToLevel(userId, levelId);
     }
@@ -59,6 +136,32 @@ namespace MultiplayerCore::Objects {
         }
     }
 
+    static inline GlobalNamespace::EntitlementsStatus ToEntitlementsStatus(EntitlementDecision::Status status) {
+        switch (status) {
+            case EntitlementDecision::Status::NotOwned:
+                return GlobalNamespace::EntitlementsStatus::NotOwned;
+            case EntitlementDecision::Status::NotDownloaded:
+                return GlobalNamespace::EntitlementsStatus::NotDownloaded;
+            case EntitlementDecision::Status::Ok:
+                return GlobalNamespace::EntitlementsStatus::Ok;
+            default:
+                return GlobalNamespace::EntitlementsStatus::Unknown;
+        }
+    }
+
+    static inline EntitlementDecision::Status FromEntitlementsStatus(GlobalNamespace::EntitlementsStatus entitlement) {
+        switch (entitlement) {
+            case GlobalNamespace::EntitlementsStatus::NotOwned:
+                return EntitlementDecision::Status::NotOwned;
+            case GlobalNamespace::EntitlementsStatus::NotDownloaded:
+                return EntitlementDecision::Status::NotDownloaded;
+            case GlobalNamespace::EntitlementsStatus::Ok:
+                return EntitlementDecision::Status::Ok;
+            default:
+                return EntitlementDecision::Status::Unknown;
+        }
+    }
+
     void MpEntitlementChecker::HandleSetIsEntitledToLevel(StringW userId, StringW levelId, GlobalNamespace::EntitlementsStatus entitlement) {
         // operator[] auto inserts instances so we can just check like this,
         // and since this method shouldn't ever be called with Unknown, this is a nice way of doing this
@@ -79,18 +182,45 @@ namespace MultiplayerCore::Objects {
             return NetworkPlayerEntitlementChecker::GetEntitlementStatus(levelId);
         }
 
-        if (auto existingTask = _entitlementsTasks.find(levelId); existingTask != _entitlementsTasks.end()) {
-            return existingTask->second.ptr();
+        // a refresh may have added or removed any level, persisted verdicts check the song folder themselves
+        if (auto generation = songsGeneration.load(); generation != _songsGeneration) {
+            _songsGeneration = generation;
+            DropFinishedTasks();
+        }
+
+        if (auto existingTask = _entitlementsTasks.Find(levelId)) {
+            auto& task = *existingTask;
+            // Unknown means it couldn't be decided, which may go better this time
+            if (!task->get_IsCompleted() || task->get_Result() != GlobalNamespace::EntitlementsStatus::Unknown)
+                return task.ptr();
         }
 
-        auto task = StartTask<GlobalNamespace::EntitlementsStatus>([this, levelId](){
+        // decided in an earlier lobby or session, and nothing it depends on changed since
+        auto folderTime = SongFolderTime(levelHash);
+        if (folderTime >= 0) {
+            if (auto cached = GetEntitlementStore().Find(levelHash, folderTime)) {
+                auto entitlement = ToEntitlementsStatus(*cached);
+                DEBUG("Entitlement cached for level {}: {}", levelId, EntitlementName(entitlement));
+                _entitlementsDictionary[_sessionManager->localPlayer->userId][levelId] = entitlement;
+                auto task = EntitlementsStatusTask::FromResult<GlobalNamespace::EntitlementsStatus>(entitlement);
+                _entitlementsTasks.Insert(levelId, task);
+                return task;
+            }
+        }
+
+        auto task = StartTask<GlobalNamespace::EntitlementsStatus>([this, levelId, levelHash, folderTime](){
             auto entitlement = GetEntitlementStatus(levelId);
             DEBUG("Entitlement found for level {}: {}", levelId, EntitlementName(entitlement));
             _entitlementsDictionary[_sessionManager->localPlayer->userId][levelId] = entitlement;
+
+            // NotOwned of a level that isn't installed may be BeatSaver not answering, that is decided again next time
+            auto status = FromEntitlementsStatus(entitlement);
+            if (folderTime > 0 || (folderTime == 0 && status == EntitlementDecision::Status::NotDownloaded))
+                GetEntitlementStore().Store(levelHash, status, folderTime);
             return entitlement;
         });
 
-        _entitlementsTasks[levelId] = task;
+        _entitlementsTasks.Insert(levelId, task);
         return task;
     }
 
@@ -98,67 +228,29 @@ namespace MultiplayerCore::Objects {
         auto levelHash = Utilities::HashForLevelId(levelId);
         if (levelHash.empty()) return NetworkPlayerEntitlementChecker::GetEntitlementStatus(levelId)->get_Result();
 
+        auto isInstalled = [](std::string_view requirement){ return RequirementUtils::GetRequirementInstalled(std::string(requirement)); };
+
         // Check if this custom song exists locally
         if (RuntimeSongLoader::API::GetLevelByHash(levelHash).has_value()) {
             auto extraSongData = Utils::ExtraSongData::FromLevelId(levelId);
-            if (!extraSongData) return GlobalNamespace::EntitlementsStatus::Ok;
-
-            std::list<std::string> requirements;
-            for (const auto& diff : extraSongData->difficulties) {
-                if (diff.additionalDifficultyData.has_value()) {
-                    for (const auto& req : diff.additionalDifficultyData->requirements) {
-                        requirements.emplace_back(req);
-                    }
-                }
-            }
-
-            for (const auto& req : requirements)
-                if (!RequirementUtils::GetRequirementInstalled(req))
-                    return GlobalNamespace::EntitlementsStatus::NotOwned;
-
-            return GlobalNamespace::EntitlementsStatus::Ok;
+            return ToEntitlementsStatus(EntitlementDecision::ForLocalLevel(extraSongData ? &*extraSongData : nullptr, isInstalled));
         }
 
-        // Check beatsaver for the map
-        auto beatmap = BeatSaver::API::GetBeatmapByHash(levelHash);
+        // Check beatsaver for the map, usually answered from the metadata cache
+        auto beatmap = Beatmaps::Providers::BeatSaverCache::GetMetadata(levelHash);
         if (beatmap.has_value()) {
-            auto& versions = beatmap->GetVersions();
-            const auto& beatmapVersion = std::find_if(versions.begin(), versions.end(), [&levelHash](const auto& v){
-                auto toCheckHash = v.GetHash();
-                if (toCheckHash.size() != levelHash.size()) return false;
-                auto toCheckItr = toCheckHash.c_str();
-                auto levelHashItr = levelHash.c_str();
-                auto toCheckEnd = toCheckItr + toCheckHash.size();
-
-                for (;toCheckItr < toCheckEnd; toCheckItr++, levelHashItr++) {
-                    if (tolower(*toCheckItr) != tolower(*levelHashItr)) return false;
-                }
-                return true;
-            });
-
+            auto& versions = beatmap->versions;
+            auto beatmapVersion = EntitlementDecision::FindVersion(versions, levelHash);
             if (beatmapVersion == versions.end()) {
                 WARNING("Level hash {} was not found in map versions provided by beatsaver!", levelHash);
                 return GlobalNamespace::EntitlementsStatus::NotOwned;
             }
 
-            std::list<std::string> requirements;
-            for (const auto& diff : beatmapVersion->GetDiffs()) {
-                if (diff.GetChroma()) requirements.emplace_back("Chroma");
-                if (diff.GetME()) requirements.emplace_back("Mapping Extensions");
-                if (diff.GetNE()) requirements.emplace_back("Noodle Extensions");
-            }
-
-            for (const auto& req : requirements)
-                if (!RequirementUtils::GetRequirementInstalled(req))
-                    return GlobalNamespace::EntitlementsStatus::NotOwned;
-
-            return GlobalNamespace::EntitlementsStatus::NotDownloaded;
+            return ToEntitlementsStatus(EntitlementDecision::ForBeatSaverVersion(*beatmapVersion, isInstalled));
         }
 
         WARNING("Level hash {} was not found on beatsaver", levelHash);
-        // map didn't exist anywhere, must be WIP or something...
-        // either way we don't have it and can't get it
-        return GlobalNamespace::EntitlementsStatus::NotOwned;
+        return ToEntitlementsStatus(EntitlementDecision::ForMissingLevel());
     }
 
     GlobalNamespace::EntitlementsStatus MpEntitlementChecker::GetUserEntitlementStatusWithoutRequest(StringW userId, StringW levelId) {
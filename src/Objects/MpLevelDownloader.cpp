@@ -1,5 +1,7 @@
 #include "Objects/MpLevelDownloader.hpp"
+#include "Beatmaps/Providers/BeatSaverCache.hpp"
 #include "songdownloader/shared/BeatSaverAPI.hpp"
+#include "songloader/shared/API.hpp"
 #include "Utilities.hpp"
 #include "logging.hpp"
 
@@ -40,7 +42,7 @@ namespace MultiplayerCore::Objects {
             return false;
         }
 
-        auto bm = BeatSaver::API::GetBeatmapByHash(hash);
+        auto bm = Beatmaps::Providers::BeatSaverCache::GetBeatmap(hash);
         if (bm.has_value()) {
             bool done, result;
             auto onFinished =
@@ -60,10 +62,11 @@ namespace MultiplayerCore::Objects {
 
             done = false;
             DEBUG("Scheduling song refresh");
-            Lapiz::Utilities::MainThreadScheduler::Schedule([&done](){
+            Lapiz::Utilities::MainThreadScheduler::Schedule([this, &levelId, &result, &done](){
                 DEBUG("Invoking song refresh");
-                RuntimeSongLoader::API::RefreshSongs(false, [&done](auto&){
+                RuntimeSongLoader::API::RefreshSongs(false, [this, &levelId, &result, &done](auto&){
                     DEBUG("Song refresh finished");
+                    downloadFinishedEvent.invoke(levelId, result);
                     done = true;
                 });
             });
@@ -3,6 +3,8 @@
 #include "logging.hpp"
 #include "Utilities.hpp"
 
+#include "lapiz/shared/utilities/MainThreadScheduler.hpp"
+
 #include "System/Collections/Generic/Dictionary_2.hpp"
 #include "GlobalNamespace/BeatmapCharacteristicCollectionSO.hpp"
 #include "GlobalNamespace/BeatmapCharacteristicCollection.hpp"
@@ -14,6 +16,11 @@ DEFINE_TYPE(MultiplayerCore::Objects, MpPlayersDataModel);
 using namespace MultiplayerCore::Beatmaps::Packets;
 
 namespace MultiplayerCore::Objects {
+    // a beatmap packet at its DecodeLimits with long strings stays well below this
+    static constexpr uint32_t MaxBeatmapPacketBytes = 16 * 1024;
+    // players resend their selection whenever someone joins, a lobby filling up quickly must not run into this
+    static constexpr uint32_t MaxBeatmapPacketsPerSecond = 60;
+
     void MpPlayersDataModel::ctor(Networking::MpPacketSerializer* packetSerializer, Beatmaps::Providers::MpBeatmapLevelProvider* beatmapLevelProvider) {
         INVOKE_CTOR();
         INVOKE_BASE_CTOR(classof(GlobalNamespace::LobbyPlayersDataModel*));
@@ -23,12 +30,28 @@ namespace MultiplayerCore::Objects {
     }
 
     void MpPlayersDataModel::Activate_override() {
-        _packetSerializer->RegisterCallback<MpBeatmapPacket*>(std::bind(&MpPlayersDataModel::HandleMpexBeatmapPacket, this, std::placeholders::_1, std::placeholders::_2));
+        // handled where the packet is received, in order with the vanilla menu rpcs and only while the player is still in the lobby.
+        // The level preview copies what it needs out of the packet, so it goes back to the pool afterwards
+        _packetSerializer->RegisterPooledCallback<MpBeatmapPacket*>(std::bind(&MpPlayersDataModel::HandleMpexBeatmapPacket, this, std::placeholders::_1, std::placeholders::_2));
+        _packetSerializer->RegisterPooledCallback<MpCompactBeatmapPacket*>(std::bind(&MpPlayersDataModel::HandleMpexBeatmapPacket, this, std::placeholders::_1, std::placeholders::_2));
+        // only the most recent selection matters
+        _packetSerializer->SetCoalescing<MpBeatmapPacket*>();
+        _packetSerializer->SetCoalescing<MpCompactBeatmapPacket*>();
+        _packetSerializer->SetPayloadCaching<MpBeatmapPacket*>();
+        _packetSerializer->SetPayloadCaching<MpCompactBeatmapPacket*>();
+        // maps with many contributors and requirements get large, the strings in them compress well
+        _packetSerializer->SetCompression<MpCompactBeatmapPacket*>();
+        // every beatmap packet builds a level preview, a player sending them in a loop would hitch the lobby
+        _packetSerializer->SetDecodeBudget<MpBeatmapPacket*>(MaxBeatmapPacketBytes, MaxBeatmapPacketsPerSecond);
+        _packetSerializer->SetDecodeBudget<MpCompactBeatmapPacket*>(MaxBeatmapPacketBytes, MaxBeatmapPacketsPerSecond);
         GlobalNamespace::LobbyPlayersDataModel::Activate();
     }
 
     void MpPlayersDataModel::Deactivate_override() {
+        // a BeatSaver lookup for the local selection that is still running shouldn't send anything anymore
+        _localSelection++;
         _packetSerializer->UnregisterCallback<MpBeatmapPacket*>();
+        _packetSerializer->UnregisterCallback<MpCompactBeatmapPacket*>();
         GlobalNamespace::LobbyPlayersDataModel::Deactivate();
     }
 
@@ -54,7 +77,7 @@ namespace MultiplayerCore::Objects {
 
         auto hash = Utilities::HashForLevelId(levelId);
         if (!hash.empty())
-            _packetSerializer->Send(MpBeatmapPacket::New_1(localPlayerData->get_beatmapLevel()));
+            SendLocalBeatmapPacket(localPlayerData->get_beatmapLevel());
         GlobalNamespace::LobbyPlayersDataModel::HandleMenuRpcManagerGetRecommendedBeatmap(userId);
     }
 
@@ -69,12 +92,71 @@ namespace MultiplayerCore::Objects {
         auto id = beatmapLevel->get_beatmapLevel()->get_levelID();
         DEBUG("Local player selected song '{}'", id);
         auto hash = Utilities::HashForLevelId(id);
-        if (!hash.empty()) {
-            auto isMpBeatmapLevel = il2cpp_utils::try_cast<Beatmaps::Abstractions::MpBeatmapLevel>(beatmapLevel->get_beatmapLevel()).has_value();
-            if (!isMpBeatmapLevel)
-                beatmapLevel->set_beatmapLevel(_beatmapLevelProvider->GetBeatmapAsync(hash).get());
-            _packetSerializer->Send(MpBeatmapPacket::New_1(beatmapLevel));
+        auto selection = ++_localSelection;
+        if (hash.empty()) {
+            GlobalNamespace::LobbyPlayersDataModel::SetLocalPlayerBeatmapLevel(beatmapLevel);
+            return;
+        }
+
+        auto isMpBeatmapLevel = il2cpp_utils::try_cast<Beatmaps::Abstractions::MpBeatmapLevel>(beatmapLevel->get_beatmapLevel()).has_value();
+        auto level = isMpBeatmapLevel ? std::future<GlobalNamespace::IPreviewBeatmapLevel*>() : _beatmapLevelProvider->GetBeatmapAsync(hash);
+        if (!level.valid()) {
+            ApplyLocalBeatmapLevel(beatmapLevel);
+        } else if (level.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+            // installed songs resolve right away
+            if (auto resolved = level.get()) beatmapLevel->set_beatmapLevel(resolved);
+            ApplyLocalBeatmapLevel(beatmapLevel);
+        } else {
+            // a BeatSaver lookup, waited for on a thread of its own so it doesn't hold up the game or a worker of the serializer.
+            // The lobby and the other players only hear of the selection once it's resolved
+            il2cpp_utils::il2cpp_aware_thread([self = SafePtr<MpPlayersDataModel>(this), selection, pinnedLevel = SafePtr<GlobalNamespace::PreviewDifficultyBeatmap>(beatmapLevel), level = std::move(level)]() mutable {
+                GlobalNamespace::IPreviewBeatmapLevel* resolvedLevel = nullptr;
+                try {
+                    resolvedLevel = level.get();
+                } catch (const std::exception& e) {
+                    WARNING("Looking up the selected song on BeatSaver failed: {}", e.what());
+                }
+                SafePtr<System::Object> resolved(reinterpret_cast<System::Object*>(resolvedLevel));
+                Lapiz::Utilities::MainThreadScheduler::Schedule([self, selection, pinnedLevel, resolved](){
+                    // the player picked something else in the meantime, or left the lobby
+                    if (selection != self->_localSelection) return;
+                    if (resolved.ptr()) pinnedLevel->set_beatmapLevel(reinterpret_cast<GlobalNamespace::IPreviewBeatmapLevel*>(resolved.ptr()));
+                    self->ApplyLocalBeatmapLevel(pinnedLevel.ptr());
+                });
+            }).detach();
         }
+    }
+
+    void MpPlayersDataModel::ApplyLocalBeatmapLevel(GlobalNamespace::PreviewDifficultyBeatmap* beatmapLevel) {
+        SendLocalBeatmapPacket(beatmapLevel);
         GlobalNamespace::LobbyPlayersDataModel::SetLocalPlayerBeatmapLevel(beatmapLevel);
     }
+
+    MpBeatmapPacket* MpPlayersDataModel::GetLocalBeatmapPacket(GlobalNamespace::PreviewDifficultyBeatmap* beatmapLevel) {
+        auto key = fmt::format("{}|{}|{}",
+            beatmapLevel->get_beatmapLevel()->get_levelID(),
+            beatmapLevel->get_beatmapCharacteristic()->get_serializedName(),
+            static_cast<int>(beatmapLevel->get_beatmapDifficulty().value__)
+        );
+
+        auto level = beatmapLevel->get_beatmapLevel();
+        if (!_localBeatmapPacket || key != _localBeatmapPacketKey || level != _localBeatmapPacketLevel) {
+            _localBeatmapPacket = MpBeatmapPacket::New_1(beatmapLevel);
+            _localCompactBeatmapPacket = nullptr;
+            _localBeatmapPacketKey = std::move(key);
+            _localBeatmapPacketLevel = level;
+        }
+        return _localBeatmapPacket;
+    }
+
+    void MpPlayersDataModel::SendLocalBeatmapPacket(GlobalNamespace::PreviewDifficultyBeatmap* beatmapLevel) {
+        auto packet = GetLocalBeatmapPacket(beatmapLevel);
+        // players would be let into the map without mods it needs
+        if (!packet->RequirementsFit()) {
+            ERROR("'{}' has more requirements than players accept, not sending its beatmap packet", packet->levelHash);
+            return;
+        }
+        if (!_localCompactBeatmapPacket) _localCompactBeatmapPacket = MpCompactBeatmapPacket::New_1(packet);
+        _packetSerializer->SendWithFallback(_localCompactBeatmapPacket, packet);
+    }
 }
@@ -1,4 +1,5 @@
 #include "Players/MpPlayerData.hpp"
+#include "Players/MpPlayerDataEncoding.hpp"
 #include "UnityEngine/Application.hpp"
 
 DEFINE_TYPE(MultiplayerCore::Players, MpPlayerData);
@@ -6,7 +7,7 @@ DEFINE_TYPE(MultiplayerCore::Players, MpPlayerData);
 namespace MultiplayerCore::Players {
     void MpPlayerData::New() {
         INVOKE_CTOR();
-        INVOKE_BASE_CTOR(classof(Networking::Abstractions::MpPacket*));
+        INVOKE_BASE_CTOR(classof(Networking::Abstractions::MpPoolablePacket*));
         gameVersion = UnityEngine::Application::get_version();
     }
 
@@ -17,8 +18,6 @@ namespace MultiplayerCore::Players {
     }
 
     void MpPlayerData::Deserialize(LiteNetLib::Utils::NetDataReader* reader) {
-        platformId = reader->GetString();
-        platform = (Platform)reader->GetInt();
-        gameVersion = reader->GetString();
+        MpPlayerDataEncoding::Read(reader, *this);
     }
 }
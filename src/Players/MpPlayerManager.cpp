@@ -21,9 +21,11 @@ namespace MultiplayerCore::Players {
 
     void MpPlayerManager::Initialize() {
         _sessionManager->SetLocalPlayerState("modded", true);
-        _packetSerializer->RegisterCallback<MpPlayerData*>(
+        _packetSerializer->RegisterPooledCallback<MpPlayerData*>(
             std::bind(&MpPlayerManager::HandlePlayerData, this, std::placeholders::_1, std::placeholders::_2)
         );
+        // the same local player data goes to every joining player
+        _packetSerializer->SetPayloadCaching<MpPlayerData*>();
         _sessionManager->add_playerConnectedEvent(
             BSML::MakeSystemAction<GlobalNamespace::IConnectedPlayer*>(
                 std::function<void(GlobalNamespace::IConnectedPlayer*)>(
@@ -49,16 +51,28 @@ namespace MultiplayerCore::Players {
     void MpPlayerManager::HandlePlayerConnected(GlobalNamespace::IConnectedPlayer* player) {
         if (!_localPlayerInfo) throw std::runtime_error("local player info was not yet set! make sure it is set before anything else happens!");
 
-        auto packet = MpPlayerData::New_ctor();
-        packet->platformId = _localPlayerInfo->platformUserId;
-        // we're either in testing, so unknown, or we're regular quest user so OculusQuest
-        packet->platform = _localPlayerInfo->platform == GlobalNamespace::UserInfo::Platform::Test ? MultiplayerCore::Players::Platform::Unknown : MultiplayerCore::Players::Platform::OculusQuest;
-        _packetSerializer->Send(packet);
+        if (!_localPlayerData) {
+            _localPlayerData = MpPlayerData::New_ctor();
+            _localPlayerData->platformId = _localPlayerInfo->platformUserId;
+            // we're either in testing, so unknown, or we're regular quest user so OculusQuest
+            _localPlayerData->platform = _localPlayerInfo->platform == GlobalNamespace::UserInfo::Platform::Test ? MultiplayerCore::Players::Platform::Unknown : MultiplayerCore::Players::Platform::OculusQuest;
+        }
+        // everyone else got our data when they joined, so only the new player needs it
+        _packetSerializer->SendTo(player, _localPlayerData);
     }
 
     void MpPlayerManager::HandlePlayerData(MpPlayerData* packet, GlobalNamespace::IConnectedPlayer* player) {
-        _playerData->set_Item(player->get_userId(), packet);
-        PlayerConnectedEvent.invoke(player, packet);
+        // the packet goes back to its pool, so the player's data is copied out of it. A player that sends it again keeps their instance
+        auto userId = player->get_userId();
+        MpPlayerData* data = nullptr;
+        if (!TryGetPlayer(userId, data)) {
+            data = MpPlayerData::New_ctor();
+            _playerData->set_Item(userId, data);
+        }
+        data->platformId = packet->platformId;
+        data->platform = packet->platform;
+        data->gameVersion = packet->gameVersion;
+        PlayerConnectedEvent.invoke(player, data);
     }
 
     bool MpPlayerManager::TryGetPlayer(StringW userId, MpPlayerData*& outplayer) {
@@ -0,0 +1,157 @@
+#include "Utils/Lz4.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <vector>
+
+namespace MultiplayerCore::Utils {
+    static constexpr std::size_t MinMatch = 4;
+    // the block format wants the last 5 bytes as literals, and no match starting within the last 12
+    static constexpr std::size_t LastLiterals = 5;
+    static constexpr std::size_t MatchFindLimit = 12;
+    static constexpr std::size_t MaxOffset = 65535;
+    static constexpr std::size_t HashLog = 12;
+    static constexpr uint32_t NoPosition = UINT32_MAX;
+
+    static inline uint32_t Read32(const uint8_t* p) {
+        uint32_t value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    static inline uint32_t HashOf(uint32_t sequence) {
+        return (sequence * 2654435761u) >> (32 - HashLog);
+    }
+
+    static inline bool WriteLength(uint8_t*& out, const uint8_t* outEnd, std::size_t length) {
+        while (length >= 255) {
+            if (out == outEnd) return false;
+            *out++ = 255;
+            length -= 255;
+        }
+        if (out == outEnd) return false;
+        *out++ = uint8_t(length);
+        return true;
+    }
+
+    static inline bool ReadLength(const uint8_t*& in, const uint8_t* inEnd, std::size_t& length, std::size_t limit) {
+        uint8_t b;
+        do {
+            if (in == inEnd) return false;
+            b = *in++;
+            length += b;
+            // nothing valid is longer than the output, also keeps length from overflowing
+            if (length > limit) return false;
+        } while (b == 255);
+        return true;
+    }
+
+    /// @brief write a sequence of literals followed by a match, matchLength 0 writes the literals only (the last sequence of a block)
+    static bool WriteSequence(uint8_t*& out, const uint8_t* outEnd, const uint8_t* literals, std::size_t literalLength, std::size_t offset, std::size_t matchLength) {
+        if (std::size_t(outEnd - out) < 1 + literalLength) return false;
+
+        auto token = out++;
+        *token = uint8_t(std::min<std::size_t>(literalLength, 15) << 4);
+        if (literalLength >= 15 && !WriteLength(out, outEnd, literalLength - 15)) return false;
+
+        if (std::size_t(outEnd - out) < literalLength) return false;
+        std::memcpy(out, literals, literalLength);
+        out += literalLength;
+
+        if (matchLength == 0) return true;
+
+        if (outEnd - out < 2) return false;
+        *out++ = uint8_t(offset);
+        *out++ = uint8_t(offset >> 8);
+
+        auto length = matchLength - MinMatch;
+        *token |= uint8_t(std::min<std::size_t>(length, 15));
+        return length < 15 || WriteLength(out, outEnd, length - 15);
+    }
+
+    std::size_t Lz4::Compress(std::span<const uint8_t> src, std::span<uint8_t> dst, std::span<const uint8_t> dictionary) {
+        // matches may reach back into the dictionary, so work on dictionary + input as one buffer
+        static thread_local std::vector<uint8_t> buffer;
+        if (dictionary.size() > MaxOffset) dictionary = dictionary.last(MaxOffset);
+        buffer.assign(dictionary.begin(), dictionary.end());
+        buffer.insert(buffer.end(), src.begin(), src.end());
+
+        const uint8_t* base = buffer.data();
+        std::size_t start = dictionary.size();
+        std::size_t end = buffer.size();
+
+        std::array<uint32_t, 1 << HashLog> table;
+        table.fill(NoPosition);
+        for (std::size_t i = 0; i + MinMatch <= start; i++) table[HashOf(Read32(base + i))] = i;
+
+        uint8_t* out = dst.data();
+        const uint8_t* outEnd = dst.data() + dst.size();
+
+        std::size_t anchor = start;
+        std::size_t matchLimit = end - std::min(end, LastLiterals);
+        std::size_t searchLimit = src.size() > MatchFindLimit ? end - MatchFindLimit : start;
+        for (std::size_t i = start; i < searchLimit;) {
+            auto sequence = Read32(base + i);
+            auto& slot = table[HashOf(sequence)];
+            std::size_t candidate = slot;
+            slot = i;
+            if (candidate == NoPosition || i - candidate > MaxOffset || Read32(base + candidate) != sequence) {
+                i++;
+                continue;
+            }
+
+            std::size_t matchLength = MinMatch;
+            while (i + matchLength < matchLimit && base[candidate + matchLength] == base[i + matchLength]) matchLength++;
+            // grow the match backwards over literals that also match
+            while (i > anchor && candidate > 0 && base[i - 1] == base[candidate - 1]) {
+                i--;
+                candidate--;
+                matchLength++;
+            }
+
+            if (!WriteSequence(out, outEnd, base + anchor, i - anchor, i - candidate, matchLength)) return 0;
+            i += matchLength;
+            anchor = i;
+        }
+
+        if (!WriteSequence(out, outEnd, base + anchor, end - anchor, 0, 0)) return 0;
+        return out - dst.data();
+    }
+
+    bool Lz4::Decompress(std::span<const uint8_t> src, std::span<uint8_t> dst, std::span<const uint8_t> dictionary) {
+        const uint8_t* in = src.data();
+        const uint8_t* inEnd = src.data() + src.size();
+        std::size_t out = 0;
+
+        while (in < inEnd) {
+            uint8_t token = *in++;
+
+            std::size_t literalLength = token >> 4;
+            if (literalLength == 15 && !ReadLength(in, inEnd, literalLength, dst.size())) return false;
+            if (literalLength > std::size_t(inEnd - in) || literalLength > dst.size() - out) return false;
+            if (literalLength > 0) std::memcpy(dst.data() + out, in, literalLength);
+            in += literalLength;
+            out += literalLength;
+
+            // the last sequence is literals only
+            if (in == inEnd) break;
+
+            if (inEnd - in < 2) return false;
+            std::size_t offset = in[0] | (in[1] << 8);
+            in += 2;
+            if (offset == 0 || offset > out + dictionary.size()) return false;
+
+            std::size_t matchLength = token & 0xf;
+            if (matchLength == 15 && !ReadLength(in, inEnd, matchLength, dst.size())) return false;
+            matchLength += MinMatch;
+            if (matchLength > dst.size() - out) return false;
+
+            // byte by byte, a match can overlap its own output and start in the dictionary
+            for (std::size_t end = out + matchLength; out < end; out++) {
+                dst[out] = offset > out ? dictionary[dictionary.size() - (offset - out)] : dst[out - offset];
+            }
+        }
+        return out == dst.size();
+    }
+}
@@ -0,0 +1,110 @@
+#include "Utils/RecordLog.hpp"
+#include "Utils/Hash.hpp"
+#include "Utils/VarInt.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+
+namespace MultiplayerCore::Utils {
+    namespace {
+        struct LogReader {
+            std::span<const uint8_t> data;
+            std::size_t position = 0;
+
+            uint8_t GetByte() {
+                if (position >= data.size()) throw std::runtime_error("Record log is cut short");
+                return data[position++];
+            }
+        };
+
+        uint32_t Checksum(std::span<const uint8_t> bytes) {
+            return static_cast<uint32_t>(Fnv1a64({ reinterpret_cast<const char*>(bytes.data()), bytes.size() }));
+        }
+    }
+
+    RecordLog::RecordLog(std::filesystem::path path, Magic magic, uint8_t version) : path(std::move(path)), magic(magic), version(version) {}
+
+    bool RecordLog::Open(const std::function<void(std::span<const uint8_t>)>& onRecord) {
+        if (file.is_open()) file.close();
+        records = 0;
+        bytes = 0;
+
+        std::vector<uint8_t> content;
+        {
+            std::ifstream in(path, std::ios::binary);
+            if (in) content.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        }
+
+        bool readable = content.size() >= magic.size() + 1 && std::equal(magic.begin(), magic.end(), content.begin()) && content[magic.size()] == version;
+        if (!readable) return false;
+
+        LogReader reader{ content, magic.size() + 1 };
+        std::size_t end = reader.position;
+        try {
+            while (reader.position < content.size()) {
+                auto length = VarInt::Read(&reader);
+                if (length > MaxRecordBytes || length + sizeof(uint32_t) > content.size() - reader.position) break;
+                std::span<const uint8_t> payload(content.data() + reader.position, length);
+                reader.position += length;
+                uint32_t checksum = 0;
+                for (int i = 0; i < 4; i++) checksum |= uint32_t(reader.GetByte()) << (8 * i);
+                if (checksum != Checksum(payload)) break;
+
+                onRecord(payload);
+                records++;
+                end = reader.position;
+            }
+        } catch (const std::runtime_error&) {
+            // a record cut short by the game dying while writing it, everything before it is fine
+        }
+
+        if (end != content.size()) return false;
+        bytes = content.size();
+        file.open(path, std::ios::binary | std::ios::app);
+        return true;
+    }
+
+    void RecordLog::Append(std::span<const uint8_t> payload) {
+        header.clear();
+        VarInt::Write(header, payload.size());
+        std::array<uint8_t, 4> checksum;
+        auto value = Checksum(payload);
+        for (int i = 0; i < 4; i++) checksum[i] = uint8_t(value >> (8 * i));
+
+        records++;
+        if (!file.is_open()) return;
+        file.write(reinterpret_cast<const char*>(header.data()), header.size());
+        file.write(reinterpret_cast<const char*>(payload.data()), payload.size());
+        file.write(reinterpret_cast<const char*>(checksum.data()), checksum.size());
+        file.flush();
+        bytes += header.size() + payload.size() + checksum.size();
+    }
+
+    bool RecordLog::Rewrite(const std::function<void()>& writeRecords) {
+        if (file.is_open()) file.close();
+        records = 0;
+        bytes = 0;
+
+        std::error_code error;
+        if (path.has_parent_path()) std::filesystem::create_directories(path.parent_path(), error);
+
+        auto temporary = path;
+        temporary += ".tmp";
+        file.open(temporary, std::ios::binary | std::ios::trunc);
+        if (!file) return false;
+        file.write(reinterpret_cast<const char*>(magic.data()), magic.size());
+        file.put(static_cast<char>(version));
+        bytes = magic.size() + 1;
+        writeRecords();
+        file.close();
+
+        std::filesystem::rename(temporary, path, error);
+        if (error) {
+            std::filesystem::remove(temporary, error);
+            return false;
+        }
+        file.open(path, std::ios::binary | std::ios::app);
+        return static_cast<bool>(file);
+    }
+}